@@ -1,81 +1,337 @@
 #include "Algorithms.hpp"
 #include "Graph.hpp"
+#include "IndexedHeap.hpp"
+#include "Parallel.hpp"
+#include "ParallelBFS.hpp"
+#include "DeltaStepping.hpp"
+#include "BellmanFord.hpp"
+#include "Instrumentation.hpp"
 #include <vector>
 #include <limits>
 #include <queue>
 #include <string>
 #include <iostream>
-#include <algorithm> 
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
 
 using namespace std;
 
 namespace ariel {
-    
-    void Algorithms::DFS(size_t start, vector<bool>& visited, vector<vector<int>>& matrixGraph){
+namespace {
+    const size_t NO_PARENT = numeric_limits<size_t>::max();
+
+    // Explicit DFS stack. Each frame keeps the vertex, the vertex it was reached
+    // from and a cursor positioned at the next neighbor to try, so the traversal
+    // never recurses and handles path-shaped graphs of any length. The frames are
+    // reserved once for the whole graph and reused across every root.
+    template <typename Adjacency>
+    struct DfsFrame {
+        size_t vertex;
+        size_t parent;
+        typename Adjacency::Cursor it;
+        DfsFrame(size_t v, size_t p, const typename Adjacency::Cursor& cursor) : vertex(v), parent(p), it(cursor) {}
+    };
+
+    template <typename Adjacency>
+    void dfsVisit(const Adjacency& adj, size_t start, vector<bool>& visited, vector<DfsFrame<Adjacency>>& stack) {
+        stack.clear();
         visited[start] = true;
-        for(size_t i = 0; i < visited.size(); i++){
-            if(matrixGraph[start][i] > 0 && !visited[i]){
-                DFS(i, visited, matrixGraph);
+        ARIEL_COUNT_VERTICES(1);
+        stack.push_back(DfsFrame<Adjacency>(start, NO_PARENT, adj.neighbors(start)));
+        while (!stack.empty()) {
+            typename Adjacency::Cursor& it = stack.back().it;
+            if (!it.valid()) {
+                stack.pop_back();
+                continue;
+            }
+            size_t v = it.target();
+            bool edge = it.weight() > 0;
+            it.next();
+            ARIEL_COUNT_EDGES(1);
+            if (edge && !visited[v]) {
+                visited[v] = true;
+                ARIEL_COUNT_VERTICES(1);
+                stack.push_back(DfsFrame<Adjacency>(v, NO_PARENT, adj.neighbors(v)));
             }
         }
     }
 
-    bool Algorithms::isConnected(Graph& g) {
-        vector<vector<int>> matrixGraph = g.getMatrixGraph();
-        if(matrixGraph.size() == 1) return true;
-        vector<bool> visited(matrixGraph.size(), false);
-        DFS(0, visited, matrixGraph);
-        for(bool vertexVisit: visited){
-            if(!vertexVisit) return false; 
+    // The traversals below start from the vertices in loaded order (g.internalId),
+    // so a directed graph gets the same answer after Graph::reorder.
+    template <typename Adjacency>
+    bool connected(const GraphView& g, const Adjacency& adj) {
+        if (adj.size() == 1) return true;
+        vector<bool> visited(adj.size(), false);
+        vector<DfsFrame<Adjacency>> stack;
+        stack.reserve(adj.size());
+        dfsVisit(adj, g.internalId(0), visited, stack);
+        for (bool vertexVisit : visited) {
+            if (!vertexVisit) return false;
         }
         return true;
     }
 
-    size_t Algorithms::minDistance(vector<int>& srcPathDest, vector<bool>& visited) {
-    size_t min_index = numeric_limits<size_t>::max();
-    int min = numeric_limits<int>::max();
-    for (size_t v = 0; v < srcPathDest.size(); v++)
-        if (!visited[v] && srcPathDest[v] <= min) {
-            min = srcPathDest[v];
-            min_index = v;
+    // Iterative cycle search from root. recStack marks the vertices on the current
+    // DFS path; reaching one of them again (other than the vertex we came from,
+    // for undirected graphs) closes a cycle, which is read straight off the stack
+    // into `cycle` as i -> ... -> v -> i.
+    template <typename Adjacency>
+    bool cycleFrom(const Adjacency& adj, size_t root, vector<bool>& visited, vector<bool>& recStack, size_t rootParent,
+                   bool isDirected, vector<DfsFrame<Adjacency>>& stack, vector<size_t>& cycle) {
+        stack.clear();
+        visited[root] = true;
+        recStack[root] = true;
+        ARIEL_COUNT_VERTICES(1);
+        stack.push_back(DfsFrame<Adjacency>(root, rootParent, adj.neighbors(root)));
+        while (!stack.empty()) {
+            DfsFrame<Adjacency>& frame = stack.back();
+            if (!frame.it.valid()) {
+                recStack[frame.vertex] = false;
+                stack.pop_back();
+                continue;
+            }
+            size_t i = frame.it.target();
+            frame.it.next();
+            ARIEL_COUNT_EDGES(1);
+            if (!visited[i]) {
+                visited[i] = true;
+                recStack[i] = true;
+                ARIEL_COUNT_VERTICES(1);
+                stack.push_back(DfsFrame<Adjacency>(i, frame.vertex, adj.neighbors(i)));
+            } else if (recStack[i] && (isDirected || i != frame.parent)) {
+                size_t first = stack.size() - 1;
+                while (stack[first].vertex != i) first--;
+                cycle.clear();
+                for (size_t k = first; k < stack.size(); k++) {
+                    cycle.push_back(stack[k].vertex);
+                }
+                cycle.push_back(i);
+                return true;
+            }
         }
-    return min_index;
+        return false;  // No cycle found starting from root
+    }
+
+    template <typename Adjacency>
+    vector<size_t> findCycleIn(const GraphView& g, const Adjacency& adj, bool isDirected) {
+        vector<bool> visited(adj.size(), false);
+        vector<bool> recStack(adj.size(), false);
+        vector<DfsFrame<Adjacency>> stack;
+        stack.reserve(adj.size());
+        vector<size_t> cycle;
+        for (size_t k = 0; k < adj.size(); k++) {
+            size_t i = g.internalId(k);
+            if (!visited[i] && cycleFrom(adj, i, visited, recStack, NO_PARENT, isDirected, stack, cycle)) {
+                break;
+            }
+        }
+        return cycle;
+    }
+
+    string bipartiteString(const vector<size_t>& setA, const vector<size_t>& setB) {
+        string output = "The graph is bipartite: A={";
+        for (size_t i = 0; i < setA.size(); ++i) {
+            output += to_string(setA[i]);
+            output += (i < setA.size() - 1) ? ", " : "}, B={";
+        }
+        for (size_t i = 0; i < setB.size(); ++i) {
+            output += to_string(setB[i]);
+            output += (i < setB.size() - 1) ? ", " : "}";
+        }
+        return output;
+    }
+
+    // The bipartite searches fill the two sides and return false on a clash.
+    template <typename Adjacency>
+    bool bipartite(const GraphView& g, const Adjacency& adj, vector<size_t>& setA, vector<size_t>& setB) {
+        vector<int> color(adj.size(), -1);
+
+        for (size_t k = 0; k < adj.size(); ++k) {
+            size_t start = g.internalId(k);
+            if (color[start] == -1) {
+                queue<size_t> q;
+                q.push(start);
+                color[start] = 0;
+                setA.push_back(start);
+
+                while (!q.empty()) {
+                    size_t u = q.front();
+                    q.pop();
+                    ARIEL_COUNT_VERTICES(1);
+
+                    for (typename Adjacency::Cursor it = adj.neighbors(u); it.valid(); it.next()) {
+                        ARIEL_COUNT_EDGES(1);
+                        if (it.weight() > 0) {  // Check if there is a weight, indicating an edge
+                            size_t v = it.target();
+                            if (color[v] == -1) {
+                                color[v] = 1 - color[u];
+                                q.push(v);
+                                if (color[v] == 0) {
+                                    setA.push_back(v);
+                                } else {
+                                    setB.push_back(v);
+                                }
+                            } else if (color[v] == color[u]) {
+                                return false;  // Not bipartite if two adjacent vertices have the same color
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    // Word-parallel traversals for the bitset storage. A frontier is itself a
+    // bitset: expanding it ORs the rows of its vertices together and masks out
+    // what was already visited, 64 vertices per operation. The loops are plain
+    // word loops so the compiler can vectorize them.
+    void forEachBit(const vector<uint64_t>& bits, vector<size_t>& out) {
+        for (size_t w = 0; w < bits.size(); w++) {
+            for (uint64_t word = bits[w]; word != 0; word &= word - 1) {
+                out.push_back(w * 64 + static_cast<size_t>(__builtin_ctzll(word)));
+            }
+        }
+    }
+
+    // Expands `frontier` by one level into `next`, marking the new vertices in `visited`.
+    // Returns false when nothing new was reached.
+    bool expandFrontier(const BitsetView& adj, const vector<size_t>& frontier, vector<uint64_t>& visited, vector<uint64_t>& next) {
+        const size_t words = adj.wordsPerRow();
+        fill(next.begin(), next.end(), 0);
+        for (size_t k = 0; k < frontier.size(); k++) {
+            const uint64_t* row = adj.row(frontier[k]);
+            for (size_t w = 0; w < words; w++) next[w] |= row[w];
+        }
+        ARIEL_COUNT_VERTICES(frontier.size());
+        uint64_t any = 0;
+        for (size_t w = 0; w < words; w++) {
+            next[w] &= ~visited[w];
+            visited[w] |= next[w];
+            any |= next[w];
+        }
+        return any != 0;
+    }
+
+    bool bitsetConnected(const GraphView& g, const BitsetView& adj) {
+        const size_t words = adj.wordsPerRow();
+        vector<uint64_t> visited(words, 0), next(words, 0);
+        const size_t start = g.internalId(0);
+        vector<size_t> frontier(1, start);
+        visited[start / 64] = uint64_t(1) << (start % 64);
+        while (expandFrontier(adj, frontier, visited, next)) {
+            frontier.clear();
+            forEachBit(next, frontier);
+        }
+        for (size_t w = 0; w + 1 < words; w++) {
+            if (visited[w] != ~uint64_t(0)) return false;
+        }
+        size_t tail = adj.size() - (words - 1) * 64;
+        uint64_t lastMask = tail == 64 ? ~uint64_t(0) : (uint64_t(1) << tail) - 1;
+        return visited[words - 1] == lastMask;
+    }
+
+    // Colors each BFS tree by level parity, then checks every row against the
+    // vertices sharing its color with one AND per word. Within a level the
+    // vertices are listed in increasing order.
+    bool bitsetBipartite(const GraphView& g, const BitsetView& adj, vector<size_t>& setA, vector<size_t>& setB) {
+        const size_t words = adj.wordsPerRow();
+        vector<uint64_t> visited(words, 0), next(words, 0);
+        vector<uint64_t> colorMask[2] = {vector<uint64_t>(words, 0), vector<uint64_t>(words, 0)};
+        vector<int> color(adj.size(), -1);
+        vector<size_t>* sets[2] = {&setA, &setB};
+        vector<size_t> frontier;
+        for (size_t k = 0; k < adj.size(); ++k) {
+            size_t start = g.internalId(k);
+            if (color[start] != -1) continue;
+            visited[start / 64] |= uint64_t(1) << (start % 64);
+            frontier.assign(1, start);
+            for (int level = 0; !frontier.empty(); level = 1 - level) {
+                for (size_t f = 0; f < frontier.size(); f++) {
+                    size_t v = frontier[f];
+                    color[v] = level;
+                    colorMask[level][v / 64] |= uint64_t(1) << (v % 64);
+                    sets[level]->push_back(v);
+                }
+                if (!expandFrontier(adj, frontier, visited, next)) break;
+                frontier.clear();
+                forEachBit(next, frontier);
+            }
+        }
+        for (size_t u = 0; u < adj.size(); ++u) {
+            const uint64_t* row = adj.row(u);
+            const vector<uint64_t>& same = colorMask[color[u]];
+            uint64_t clash = 0;
+            for (size_t w = 0; w < words; w++) clash |= row[w] & same[w];
+            if (clash != 0) return false;  // Not bipartite if two adjacent vertices have the same color
+        }
+        return true;
     }
 
-    string Algorithms::shortestPath(Graph& g, size_t src, size_t dest) {
-        vector<vector<int>> matrixGraph = g.getMatrixGraph();
-        vector<bool> visited(matrixGraph.size(), false);
-        vector<int> srcPathDest(matrixGraph.size(), numeric_limits<int>::max());
-        vector<int> predecessor(matrixGraph.size(), -1);
-        srcPathDest[src] = 0; 
-        for (size_t count = 0; count < matrixGraph.size() - 1; count++) {
-            size_t u = minDistance(srcPathDest, visited);
-            if (u == -1) break; // No more reachable vertices
-            visited[u] = true;
-            for (size_t v = 0; v < matrixGraph.size(); v++) {
-                if (!visited[v] && matrixGraph[u][v] && srcPathDest[u] != numeric_limits<int>::max() &&
-                    srcPathDest[u] + matrixGraph[u][v] < srcPathDest[v]) {
-                    srcPathDest[v] = srcPathDest[u] + matrixGraph[u][v];
-                    predecessor[v] = u; // Track the path
+    template <typename Adjacency>
+    bool parallelConnected(const GraphView& g, const Adjacency& adj, size_t threads) {
+        ParallelBFS<Adjacency> bfs(adj, !g.isDirected(), threads);
+        return bfs.run(g.internalId(0)) == adj.size();
+    }
+
+    // Colors every BFS tree by level parity, then checks all edges for a clash in parallel.
+    template <typename Adjacency>
+    bool parallelBipartite(const GraphView& g, const Adjacency& adj, size_t threads, vector<size_t>& setA, vector<size_t>& setB) {
+        ParallelBFS<Adjacency> bfs(adj, !g.isDirected(), threads);
+        vector<size_t> starts(adj.size());
+        for (size_t k = 0; k < adj.size(); ++k) starts[k] = g.internalId(k);
+        bfs.run(starts);
+        atomic<bool> clash(false);
+        size_t chunks = bfs.threadCount() * 4;
+        size_t chunk = (adj.size() + chunks - 1) / chunks;
+        parallelFor(chunks, bfs.threadCount(), [&](size_t c) {
+            size_t last = min(adj.size(), (c + 1) * chunk);
+            for (size_t u = c * chunk; u < last && !clash.load(memory_order_relaxed); u++) {
+                for (typename Adjacency::Cursor it = adj.neighbors(u); it.valid(); it.next()) {
+                    ARIEL_COUNT_EDGES(1);
+                    if (it.weight() > 0 && bfs.level(it.target()) % 2 == bfs.level(u) % 2) {
+                        clash.store(true, memory_order_relaxed);
+                        break;
+                    }
                 }
             }
+        });
+        if (clash.load()) return false;  // Not bipartite if two adjacent vertices have the same color
+        const vector<size_t>& order = bfs.order();
+        for (size_t k = 0; k < order.size(); k++) {
+            (bfs.level(order[k]) % 2 == 0 ? setA : setB).push_back(order[k]);
         }
+        return true;
+    }
+
+    // Walks the predecessor links back from dest; empty when dest is unreachable.
+    vector<size_t> tracePath(const vector<int>& predecessor, size_t src, size_t dest) {
         vector<size_t> path;
         size_t at = dest;
         while (at != numeric_limits<size_t>::max() && predecessor[at] != -1) {
             path.push_back(at);
             at = static_cast<size_t>(predecessor[at]);
         }
-        if (at == src) { // Check if we've traced back to the source
-            path.push_back(src);
-        } else {
-            return "-1";
+        if (at != src) { // Check if we've traced back to the source
+            return vector<size_t>();
         }
+        path.push_back(src);
         reverse(path.begin(), path.end());
+        return path;
+    }
+
+    string pathToString(const vector<size_t>& path) {
+        if (path.empty()) {
+            return "-1";
+        }
         // Build the string for the path src -> dest
         string result;
         for (size_t i = 0; i < path.size(); ++i) {
-            result += to_string(path[i]); 
+            result += to_string(path[i]);
             if (i < path.size() - 1) {
                 result += "->";
             }
@@ -83,85 +339,759 @@ namespace ariel {
         return result;
     }
 
-    bool Algorithms::dfs(size_t v,vector<bool>& visited, vector<bool>& recStack, vector<vector<int>>& matrixGraph, int parent = -1, bool isDirected = false) {
-    visited[v] = true;
-    recStack[v] = true;
-    for (size_t i = 0; i < matrixGraph[v].size(); i++) {
-        if (matrixGraph[v][i] != 0) {  // There's an edge from v to i
-            if (!visited[i]) {  
-                if (dfs(i, visited, recStack, matrixGraph, v, isDirected)) {
-                    return true;  // If cycle is found
+    const size_t NO_TARGET = numeric_limits<size_t>::max();
+
+    // Dijkstra on an indexed 4-ary heap with decrease-key. The search stops as
+    // soon as dest is settled, so near queries never touch the far side of the graph;
+    // pass NO_TARGET to settle every reachable vertex.
+    template <typename Adjacency>
+    void dijkstra(const Adjacency& adj, size_t src, size_t dest, vector<int>& srcPathDest, vector<int>& predecessor) {
+        srcPathDest.assign(adj.size(), numeric_limits<int>::max());
+        predecessor.assign(adj.size(), -1);
+        vector<bool> settled(adj.size(), false);
+        IndexedHeap<int> heap(adj.size());
+        srcPathDest[src] = 0;
+        heap.push(src, 0);
+        while (!heap.empty()) {
+            size_t u = heap.pop();
+            settled[u] = true;
+            ARIEL_COUNT_VERTICES(1);
+            if (u == dest) break;
+            for (typename Adjacency::Cursor it = adj.neighbors(u); it.valid(); it.next()) {
+                size_t v = it.target();
+                ARIEL_COUNT_EDGES(1);
+                if (!settled[v] && srcPathDest[u] + it.weight() < srcPathDest[v]) {
+                    srcPathDest[v] = srcPathDest[u] + it.weight();
+                    predecessor[v] = static_cast<int>(u);
+                    heap.push(v, srcPathDest[v]);
                 }
-            } else if (isDirected && recStack[i]) {
-                return true;  // If it's a directed graph and i is in recStack, cycle found
-            } else if (!isDirected && i != parent) {
-                return true;  // If it's an undirected graph and i is not the parent, cycle found
             }
         }
     }
-    recStack[v] = false; 
-    return false;  // No cycle found starting from v
+
+    template <typename Adjacency>
+    vector<size_t> heapShortestPath(const Adjacency& adj, size_t src, size_t dest) {
+        vector<int> srcPathDest, predecessor;
+        dijkstra(adj, src, dest, srcPathDest, predecessor);
+        return tracePath(predecessor, src, dest);
     }
 
-    bool Algorithms::isContainsCycle(Graph& g) {
-        vector<vector<int>>& matrixGraph = g.getMatrixGraph();
-        vector<bool> visited(matrixGraph.size(), false);
-        vector<bool> recStack(matrixGraph.size(), false);
-        bool isDirected = g.getIsDirected();
-        for (size_t i = 0; i < matrixGraph.size(); i++) {
-            if (!visited[i]) {
-                if (dfs(i, visited, recStack, matrixGraph, -1, isDirected)) {
-                    return true;
+    // Fills the results of the queries order[begin..end), which all start at src.
+    void fillGroup(const vector<pair<size_t, size_t>>& queries, const vector<size_t>& order, pair<size_t, size_t> range,
+                   size_t src, const vector<int>& srcPathDest, const vector<int>& predecessor, vector<PathResult>& results) {
+        for (size_t k = range.first; k < range.second; k++) {
+            size_t index = order[k];
+            PathResult& result = results[index];
+            result.src = src;
+            result.dest = queries[index].second;
+            result.path = tracePath(predecessor, src, result.dest);
+            result.reachable = !result.path.empty();
+            result.distance = result.reachable ? srcPathDest[result.dest] : -1;
+        }
+    }
+
+    // One full Dijkstra per distinct source answers every query sharing it.
+    // `order` lists query indices sorted by source and `groups` holds the
+    // [begin, end) ranges of `order` that share a source.
+    template <typename Adjacency>
+    void answerBatch(const Adjacency& adj, const vector<pair<size_t, size_t>>& queries, const vector<size_t>& order,
+                     const vector<pair<size_t, size_t>>& groups, size_t threads, vector<PathResult>& results) {
+        parallelFor(groups.size(), threads, [&](size_t group) {
+            size_t src = queries[order[groups[group].first]].first;
+            vector<int> srcPathDest, predecessor;
+            dijkstra(adj, src, NO_TARGET, srcPathDest, predecessor);
+            fillGroup(queries, order, groups[group], src, srcPathDest, predecessor, results);
+        });
+    }
+
+    template <typename Adjacency>
+    vector<size_t> deltaShortestPath(const Adjacency& adj, size_t src, size_t dest, const PathOptions& options) {
+        DeltaStepping<Adjacency> engine(adj, options.delta, options.threads);
+        engine.run(src, dest);
+        vector<int> predecessor;
+        engine.predecessors(src, predecessor);
+        return tracePath(predecessor, src, dest);
+    }
+
+    PathBackend resolveBackend(const GraphView& g, PathBackend backend) {
+        if (backend != PathBackend::Auto) return backend;
+        return g.hasNegativeWeights() ? PathBackend::BellmanFord : PathBackend::Dijkstra;
+    }
+
+    // Vertices of a reordered graph back in the ids the caller loaded.
+    vector<size_t> originalIds(const GraphView& g, vector<size_t> vertices) {
+        for (size_t k = 0; k < vertices.size(); k++) vertices[k] = g.originalId(vertices[k]);
+        return vertices;
+    }
+
+    void throwNegativeCycle(const GraphView& g, const vector<size_t>& cycle) {
+        throw invalid_argument("Invalid graph: The graph contains a negative cycle: " + pathToString(originalIds(g, cycle)) + ".");
+    }
+
+    template <typename Adjacency>
+    vector<size_t> bellmanFordShortestPath(const GraphView& g, const Adjacency& adj, size_t src, size_t dest, size_t threads) {
+        BellmanFord<Adjacency> engine(adj, threads);
+        if (!engine.run(src)) throwNegativeCycle(g, engine.negativeCycleFound());
+        vector<int> predecessor;
+        engine.predecessors(predecessor);
+        return tracePath(predecessor, src, dest);
+    }
+
+    template <typename Adjacency>
+    void bellmanFordBatch(const GraphView& g, const Adjacency& adj, const vector<pair<size_t, size_t>>& queries, const vector<size_t>& order,
+                          const vector<pair<size_t, size_t>>& groups, size_t threads, vector<PathResult>& results) {
+        BellmanFord<Adjacency> engine(adj, threads);
+        vector<int> srcPathDest, predecessor;
+        for (size_t group = 0; group < groups.size(); group++) {
+            size_t src = queries[order[groups[group].first]].first;
+            if (!engine.run(src)) throwNegativeCycle(g, engine.negativeCycleFound());
+            engine.distances(srcPathDest);
+            engine.predecessors(predecessor);
+            fillGroup(queries, order, groups[group], src, srcPathDest, predecessor, results);
+        }
+    }
+
+    template <typename Adjacency>
+    vector<size_t> anyNegativeCycle(const Adjacency& adj, size_t threads) {
+        BellmanFord<Adjacency> engine(adj, threads);
+        engine.run(BellmanFord<Adjacency>::NONE);
+        return engine.negativeCycleFound();
+    }
+
+    // Delta-stepping batch: the sources take turns, each run using every worker.
+    template <typename Adjacency>
+    void deltaBatch(const Adjacency& adj, const vector<pair<size_t, size_t>>& queries, const vector<size_t>& order,
+                    const vector<pair<size_t, size_t>>& groups, const PathOptions& options, vector<PathResult>& results) {
+        DeltaStepping<Adjacency> engine(adj, options.delta, options.threads);
+        vector<int> srcPathDest, predecessor;
+        for (size_t group = 0; group < groups.size(); group++) {
+            size_t src = queries[order[groups[group].first]].first;
+            engine.run(src, NO_TARGET);
+            engine.distances(srcPathDest);
+            engine.predecessors(src, predecessor);
+            fillGroup(queries, order, groups[group], src, srcPathDest, predecessor, results);
+        }
+    }
+
+    const size_t APSP_TILE = 64;
+    const int INF = DistanceTable::UNREACHABLE;
+
+    // Floyd-Warshall step for the tile (bi, bj) over the intermediate vertices of
+    // block bk. Rows are contiguous, so the inner loop streams one row of the
+    // tile and one row of the k block.
+    void relaxTile(DistanceTable& table, size_t bi, size_t bj, size_t bk) {
+        const size_t n = table.size;
+        int* d = table.distances.data();
+        uint32_t* hop = table.nextHops.empty() ? nullptr : table.nextHops.data();
+        size_t ei = min(n, bi + APSP_TILE), ej = min(n, bj + APSP_TILE), ek = min(n, bk + APSP_TILE);
+        for (size_t k = bk; k < ek; k++) {
+            const int* rowK = d + k * n;
+            for (size_t i = bi; i < ei; i++) {
+                int dik = d[i * n + k];
+                if (dik == INF) continue;
+                ARIEL_COUNT_EDGES(ej - bj);
+                int* rowI = d + i * n;
+                if (hop != nullptr) {
+                    uint32_t hopIK = hop[i * n + k];
+                    for (size_t j = bj; j < ej; j++) {
+                        if (rowK[j] != INF && dik + rowK[j] < rowI[j]) {
+                            rowI[j] = dik + rowK[j];
+                            hop[i * n + j] = hopIK;
+                        }
+                    }
+                } else {
+                    for (size_t j = bj; j < ej; j++) {
+                        int through = rowK[j] != INF ? dik + rowK[j] : INF;
+                        rowI[j] = through < rowI[j] ? through : rowI[j];
+                    }
                 }
             }
         }
-    return false;
     }
 
-    string Algorithms::isBipartite(Graph& g) {
-        vector<vector<int>>& matrixGraph = g.getMatrixGraph();
-        vector<int> color(matrixGraph.size(), -1);  
-        vector<int> setA, setB;
-        
-        for (size_t start = 0; start < matrixGraph.size(); ++start) {
-            if (color[start] == -1) {
-                queue<int> q;
-                q.push(start);
-                color[start] = 0; 
-                setA.push_back(start);
+    // Blocked Floyd-Warshall: for every k block, the diagonal tile first, then
+    // the tiles in its row and column, then every other tile. The tiles of each
+    // of the last two phases only read tiles finished in an earlier phase, so
+    // they run in parallel.
+    void tiledFloydWarshall(DistanceTable& table, size_t threads) {
+        size_t blocks = (table.size + APSP_TILE - 1) / APSP_TILE;
+        for (size_t kb = 0; kb < blocks; kb++) {
+            size_t k = kb * APSP_TILE;
+            relaxTile(table, k, k, k);
+            parallelFor(2 * blocks, threads, [&](size_t x) {
+                size_t b = x / 2;
+                if (b == kb) return;
+                if (x % 2 == 0) {
+                    relaxTile(table, k, b * APSP_TILE, k);
+                } else {
+                    relaxTile(table, b * APSP_TILE, k, k);
+                }
+            });
+            parallelFor(blocks * blocks, threads, [&](size_t x) {
+                size_t bi = x / blocks, bj = x % blocks;
+                if (bi == kb || bj == kb) return;
+                relaxTile(table, bi * APSP_TILE, bj * APSP_TILE, k);
+            });
+        }
+    }
 
-                while (!q.empty()) {
-                    size_t u = static_cast<size_t>(q.front());
-                    q.pop();
+    template <typename Adjacency>
+    void denseAllPairs(const Adjacency& adj, DistanceTable& table, size_t threads) {
+        const size_t n = adj.size();
+        for (size_t u = 0; u < n; u++) {
+            int* row = &table.distances[u * n];
+            for (typename Adjacency::Cursor it = adj.neighbors(u); it.valid(); it.next()) {
+                size_t v = it.target();
+                // A positive self-loop never shortens anything; a negative one is a negative cycle.
+                if (v == u && it.weight() > 0) continue;
+                row[v] = it.weight();
+                if (!table.nextHops.empty()) table.nextHops[u * n + v] = static_cast<uint32_t>(v);
+            }
+            if (row[u] == INF) row[u] = 0;
+            if (!table.nextHops.empty()) table.nextHops[u * n + u] = static_cast<uint32_t>(u);
+        }
+        tiledFloydWarshall(table, threads);
+    }
 
-                    for (size_t v = 0; v < matrixGraph[u].size(); ++v) {
-                        if (matrixGraph[u][v] > 0) {  // Check if there is a weight, indicating an edge
-                            if (color[v] == -1) {
-                                color[v] = 1 - color[u];  
-                                q.push(v);
-                                if (color[v] == 0) {
-                                    setA.push_back(v);
-                                } else {
-                                    setB.push_back(v);
-                                }
-                            } else if (color[v] == color[u]) {
-                                return "0";  // Not bipartite if two adjacent vertices have the same color
-                            }
-                        }
+    // Edge weights shifted by a potential h: w(u, v) + h(u) - h(v). With the
+    // potentials from johnsonPotentials every shifted weight is non-negative.
+    template <typename Adjacency>
+    class ReweightedView {
+        private:
+            const Adjacency& adj;
+            const vector<int>& h;
+
+        public:
+            class Cursor {
+                private:
+                    typename Adjacency::Cursor it;
+                    const int* h;
+                    int hu;
+
+                public:
+                    Cursor(const typename Adjacency::Cursor& cursor, const int* potentials, int source)
+                        : it(cursor), h(potentials), hu(source) {}
+                    bool valid() const { return it.valid(); }
+                    void next() { it.next(); }
+                    size_t target() const { return it.target(); }
+                    int weight() const { return it.weight() + hu - h[it.target()]; }
+            };
+
+            ReweightedView(const Adjacency& view, const vector<int>& potentials) : adj(view), h(potentials) {}
+            size_t size() const { return adj.size(); }
+            Cursor neighbors(size_t u) const { return Cursor(adj.neighbors(u), h.data(), h[u]); }
+    };
+
+    // Shortest distances from a virtual source joined to every vertex by a
+    // zero-weight edge, by queue-based Bellman-Ford. Returns false when a
+    // tentative path reaches n real edges, which only happens on a negative cycle.
+    template <typename Adjacency>
+    bool johnsonPotentials(const Adjacency& adj, vector<int>& h) {
+        const size_t n = adj.size();
+        h.assign(n, 0);
+        // Real edges on the tentative path to each vertex; a shortest path has
+        // fewer than n, so reaching n means the path runs around a negative cycle.
+        vector<size_t> hops(n, 0);
+        vector<bool> queued(n, true);
+        queue<size_t> pending;
+        for (size_t v = 0; v < n; v++) pending.push(v);
+        while (!pending.empty()) {
+            size_t u = pending.front();
+            pending.pop();
+            queued[u] = false;
+            ARIEL_COUNT_VERTICES(1);
+            for (typename Adjacency::Cursor it = adj.neighbors(u); it.valid(); it.next()) {
+                size_t v = it.target();
+                ARIEL_COUNT_EDGES(1);
+                if (h[u] + it.weight() < h[v]) {
+                    h[v] = h[u] + it.weight();
+                    hops[v] = hops[u] + 1;
+                    if (hops[v] >= n) return false;
+                    if (!queued[v]) {
+                        queued[v] = true;
+                        pending.push(v);
                     }
                 }
             }
         }
-        string output = "The graph is bipartite: A={";
-        for (size_t i = 0; i < setA.size(); ++i) {
-            output += to_string(setA[i]);
-            output += (i < setA.size() - 1) ? ", " : "}, B={";
+        return true;
+    }
+
+    // First hop from src towards every vertex of a shortest-path tree, filled
+    // top-down along the predecessor links in O(n).
+    void fillNextHops(const vector<int>& predecessor, size_t src, uint32_t* hops) {
+        vector<size_t> chain;
+        hops[src] = static_cast<uint32_t>(src);
+        for (size_t v = 0; v < predecessor.size(); v++) {
+            size_t at = v;
+            while (hops[at] == DistanceTable::NO_HOP && predecessor[at] != -1) {
+                chain.push_back(at);
+                at = static_cast<size_t>(predecessor[at]);
+            }
+            if (hops[at] == DistanceTable::NO_HOP) {
+                chain.clear();  // not reachable from src
+                continue;
+            }
+            while (!chain.empty()) {
+                size_t w = chain.back();
+                chain.pop_back();
+                hops[w] = at == src ? static_cast<uint32_t>(w) : hops[at];
+                at = w;
+            }
         }
-        for (size_t i = 0; i < setB.size(); ++i) {
-            output += to_string(setB[i]);
-            output += (i < setB.size() - 1) ? ", " : "}";
+    }
+
+    // One full Dijkstra per source, each writing its own row. Rows computed on
+    // reweighted edges are shifted back with the potentials.
+    template <typename Adjacency>
+    void sourceAllPairs(const Adjacency& adj, DistanceTable& table, size_t threads, const vector<int>* potentials) {
+        const size_t n = adj.size();
+        parallelFor(n, threads, [&](size_t src) {
+            vector<int> srcPathDest, predecessor;
+            dijkstra(adj, src, NO_TARGET, srcPathDest, predecessor);
+            int* row = &table.distances[src * n];
+            for (size_t v = 0; v < n; v++) {
+                if (srcPathDest[v] == INF) continue;
+                row[v] = potentials == nullptr ? srcPathDest[v] : srcPathDest[v] - (*potentials)[src] + (*potentials)[v];
+            }
+            if (!table.nextHops.empty()) fillNextHops(predecessor, src, &table.nextHops[src * n]);
+        });
+    }
+
+    template <typename Adjacency>
+    bool hasNegativeWeight(const Adjacency& adj) {
+        for (size_t u = 0; u < adj.size(); u++) {
+            for (typename Adjacency::Cursor it = adj.neighbors(u); it.valid(); it.next()) {
+                if (it.weight() < 0) return true;
+            }
         }
-        return output;
+        return false;
+    }
+
+    template <typename Adjacency>
+    void sparseAllPairs(const Adjacency& adj, DistanceTable& table, size_t threads) {
+        if (!hasNegativeWeight(adj)) {
+            sourceAllPairs(adj, table, threads, nullptr);
+            return;
+        }
+        vector<int> h;
+        if (!johnsonPotentials(adj, h)) {
+            throw invalid_argument("Invalid graph: The graph contains a negative cycle.");
+        }
+        ReweightedView<Adjacency> reweighted(adj, h);
+        sourceAllPairs(reweighted, table, threads, &h);
+    }
+
+    // Answers of isConnected, isContainsCycle and isBipartite keyed on the
+    // graph's version stamp, as text ("1" / "0" for the flags); an empty string
+    // is a question not asked yet. Past the capacity the oldest stamp goes first.
+    enum CachedQuery { CONNECTED, CONTAINS_CYCLE, BIPARTITE, PARALLEL_BIPARTITE, CACHED_QUERIES };
+    const size_t CACHE_CAPACITY = 64;
+
+    struct ResultCache {
+        mutex lock;
+        atomic<bool> enabled;
+        map<uint64_t, vector<string>> answers;
+        uint64_t hits;
+        uint64_t misses;
+
+        ResultCache() : enabled(false), hits(0), misses(0) {}
+    };
+
+    ResultCache& resultCache() {
+        static ResultCache cache;
+        return cache;
+    }
+
+    string flagText(bool flag) {
+        return flag ? "1" : "0";
+    }
+
+    // The cached answer to `query` on g, or compute()'s, stored under g's
+    // version. The computation runs outside the lock.
+    template <typename Compute>
+    string cachedAnswer(const GraphView& g, CachedQuery query, Compute compute) {
+        ResultCache& cache = resultCache();
+        if (g.getVersion() == 0 || !cache.enabled.load(memory_order_relaxed)) return compute();
+        {
+            lock_guard<mutex> guard(cache.lock);
+            map<uint64_t, vector<string>>::const_iterator entry = cache.answers.find(g.getVersion());
+            if (entry != cache.answers.end() && !entry->second[query].empty()) {
+                cache.hits++;
+                return entry->second[query];
+            }
+            cache.misses++;
+        }
+        string answer = compute();
+        lock_guard<mutex> guard(cache.lock);
+        vector<string>& slots = cache.answers[g.getVersion()];
+        slots.resize(CACHED_QUERIES);
+        slots[query] = answer;
+        if (cache.answers.size() > CACHE_CAPACITY) cache.answers.erase(cache.answers.begin());
+        return answer;
+    }
+
+    // The sides of a reordered graph are listed in increasing loaded id.
+    string bipartiteAnswer(const GraphView& g, bool isBipartite, const vector<size_t>& setA, const vector<size_t>& setB) {
+        if (!isBipartite) return "0";
+        if (!g.isReordered()) return bipartiteString(setA, setB);
+        vector<size_t> sideA = originalIds(g, setA), sideB = originalIds(g, setB);
+        sort(sideA.begin(), sideA.end());
+        sort(sideB.begin(), sideB.end());
+        return bipartiteString(sideA, sideB);
+    }
+
+    // Per-vertex flags passed in by the caller, indexed by loaded id, moved to
+    // internal ids and back.
+    vector<bool> internalFlags(const GraphView& g, const vector<bool>& flags) {
+        vector<bool> moved(flags.size());
+        for (size_t v = 0; v < flags.size(); v++) moved[g.internalId(v)] = flags[v];
+        return moved;
+    }
+
+    void restoreFlags(const GraphView& g, const vector<bool>& moved, vector<bool>& flags) {
+        for (size_t v = 0; v < flags.size(); v++) flags[v] = moved[g.internalId(v)];
+    }
+
+    // Rows and columns of a table computed on a reordered graph, moved to the loaded ids.
+    void restoreTable(const GraphView& g, DistanceTable& table) {
+        const size_t n = table.size;
+        vector<int> distances(table.distances.size());
+        vector<uint32_t> hops(table.nextHops.size());
+        for (size_t u = 0; u < n; u++) {
+            size_t from = g.originalId(u) * n;
+            for (size_t v = 0; v < n; v++) {
+                distances[from + g.originalId(v)] = table.distances[u * n + v];
+                if (hops.empty()) continue;
+                uint32_t hop = table.nextHops[u * n + v];
+                hops[from + g.originalId(v)] = hop == DistanceTable::NO_HOP ? hop : static_cast<uint32_t>(g.originalId(hop));
+            }
+        }
+        table.distances.swap(distances);
+        table.nextHops.swap(hops);
     }
 }
 
+    void Algorithms::DFS(size_t start, vector<bool>& visited, const GraphView& g){
+        ARIEL_PROFILE_CALL("DFS");
+        if (g.isReordered()) {
+            vector<bool> seen = internalFlags(g, visited);
+            GraphView internal = g;
+            internal.setOrder(nullptr, nullptr);
+            DFS(g.internalId(start), seen, internal);
+            restoreFlags(g, seen, visited);
+            return;
+        }
+        switch (g.getStorage()) {
+            case Storage::Sparse: {
+                vector<DfsFrame<SparseView>> stack;
+                dfsVisit(g.sparseView(), start, visited, stack);
+                break;
+            }
+            case Storage::Compressed: {
+                vector<DfsFrame<CompressedView>> stack;
+                dfsVisit(g.compressedView(), start, visited, stack);
+                break;
+            }
+            case Storage::Bitset: {
+                vector<DfsFrame<BitsetView>> stack;
+                dfsVisit(g.bitsetView(), start, visited, stack);
+                break;
+            }
+            default: {
+                vector<DfsFrame<DenseView>> stack;
+                dfsVisit(g.denseView(), start, visited, stack);
+            }
+        }
+    }
+
+    bool Algorithms::isConnected(const GraphView& g) {
+        ARIEL_PROFILE_CALL("isConnected");
+        return cachedAnswer(g, CONNECTED, [&]() -> string {
+            switch (g.getStorage()) {
+                case Storage::Sparse: return flagText(connected(g, g.sparseView()));
+                case Storage::Compressed: return flagText(connected(g, g.compressedView()));
+                case Storage::Bitset: return flagText(bitsetConnected(g, g.bitsetView()));
+                default: return flagText(connected(g, g.denseView()));
+            }
+        }) == "1";
+    }
+
+    // Same answer as the sequential search, so both share one cache slot.
+    bool Algorithms::isConnected(const GraphView& g, size_t threads) {
+        ARIEL_PROFILE_CALL("isConnected(threads)");
+        return cachedAnswer(g, CONNECTED, [&]() -> string {
+            switch (g.getStorage()) {
+                case Storage::Sparse: return flagText(parallelConnected(g, g.sparseView(), threads));
+                case Storage::Compressed: return flagText(parallelConnected(g, g.compressedView(), threads));
+                case Storage::Bitset: return flagText(parallelConnected(g, g.bitsetView(), threads));
+                default: return flagText(parallelConnected(g, g.denseView(), threads));
+            }
+        }) == "1";
+    }
+
+    void Algorithms::setResultCache(bool enabled) {
+        resultCache().enabled.store(enabled);
+    }
+
+    CacheStats Algorithms::resultCacheStats() {
+        ResultCache& cache = resultCache();
+        lock_guard<mutex> guard(cache.lock);
+        CacheStats stats = {cache.hits, cache.misses, cache.answers.size()};
+        return stats;
+    }
+
+    void Algorithms::clearResultCache() {
+        ResultCache& cache = resultCache();
+        lock_guard<mutex> guard(cache.lock);
+        cache.answers.clear();
+        cache.hits = cache.misses = 0;
+    }
+
+    size_t Algorithms::minDistance(vector<int>& srcPathDest, vector<bool>& visited) {
+        ARIEL_PROFILE_CALL("minDistance");
+    size_t min_index = numeric_limits<size_t>::max();
+    int min = numeric_limits<int>::max();
+    for (size_t v = 0; v < srcPathDest.size(); v++)
+        if (!visited[v] && srcPathDest[v] <= min) {
+            min = srcPathDest[v];
+            min_index = v;
+        }
+    return min_index;
+    }
+
+    string Algorithms::shortestPath(const GraphView& g, size_t src, size_t dest) {
+        ARIEL_PROFILE_CALL("shortestPath");
+        return shortestPath(g, src, dest, PathOptions());
+    }
+
+    string Algorithms::shortestPath(const GraphView& g, size_t src, size_t dest, const PathOptions& options) {
+        ARIEL_PROFILE_CALL("shortestPath");
+        if (src >= g.size() || dest >= g.size()) {
+            throw invalid_argument("Invalid vertex: The vertex is not in the graph.");
+        }
+        src = g.internalId(src);
+        dest = g.internalId(dest);
+        PathBackend backend = resolveBackend(g, options.backend);
+        vector<size_t> path;
+        if (backend == PathBackend::BellmanFord) {
+            switch (g.getStorage()) {
+                case Storage::Sparse: path = bellmanFordShortestPath(g, g.sparseView(), src, dest, options.threads); break;
+                case Storage::Compressed: path = bellmanFordShortestPath(g, g.compressedView(), src, dest, options.threads); break;
+                case Storage::Bitset: path = bellmanFordShortestPath(g, g.bitsetView(), src, dest, options.threads); break;
+                default: path = bellmanFordShortestPath(g, g.denseView(), src, dest, options.threads);
+            }
+        } else if (backend == PathBackend::Dijkstra) {
+            switch (g.getStorage()) {
+                case Storage::Sparse: path = heapShortestPath(g.sparseView(), src, dest); break;
+                case Storage::Compressed: path = heapShortestPath(g.compressedView(), src, dest); break;
+                case Storage::Bitset: path = heapShortestPath(g.bitsetView(), src, dest); break;
+                default: path = heapShortestPath(g.denseView(), src, dest);
+            }
+        } else {
+            switch (g.getStorage()) {
+                case Storage::Sparse: path = deltaShortestPath(g.sparseView(), src, dest, options); break;
+                case Storage::Compressed: path = deltaShortestPath(g.compressedView(), src, dest, options); break;
+                case Storage::Bitset: path = deltaShortestPath(g.bitsetView(), src, dest, options); break;
+                default: path = deltaShortestPath(g.denseView(), src, dest, options);
+            }
+        }
+        return pathToString(originalIds(g, path));
+    }
+
+    vector<PathResult> Algorithms::shortestPaths(const GraphView& g, const vector<pair<size_t, size_t>>& queries, size_t threads) {
+        ARIEL_PROFILE_CALL("shortestPaths");
+        return shortestPaths(g, queries, PathOptions(PathBackend::Auto, 0, threads));
+    }
+
+    vector<PathResult> Algorithms::shortestPaths(const GraphView& g, const vector<pair<size_t, size_t>>& requested, const PathOptions& options) {
+        ARIEL_PROFILE_CALL("shortestPaths");
+        for (size_t i = 0; i < requested.size(); i++) {
+            if (requested[i].first >= g.size() || requested[i].second >= g.size()) {
+                throw invalid_argument("Invalid vertex: The vertex is not in the graph.");
+            }
+        }
+        vector<pair<size_t, size_t>> translated;
+        if (g.isReordered()) {
+            translated = requested;
+            for (size_t i = 0; i < translated.size(); i++) {
+                translated[i] = make_pair(g.internalId(translated[i].first), g.internalId(translated[i].second));
+            }
+        }
+        const vector<pair<size_t, size_t>>& queries = g.isReordered() ? translated : requested;
+        vector<size_t> order(queries.size());
+        for (size_t i = 0; i < order.size(); i++) order[i] = i;
+        stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return queries[a].first < queries[b].first;
+        });
+        vector<pair<size_t, size_t>> groups;
+        for (size_t k = 0; k < order.size(); k++) {
+            if (k == 0 || queries[order[k]].first != queries[order[k - 1]].first) {
+                groups.push_back(make_pair(k, k));
+            }
+            groups.back().second = k + 1;
+        }
+
+        vector<PathResult> results(queries.size());
+        PathBackend backend = resolveBackend(g, options.backend);
+        if (backend == PathBackend::BellmanFord) {
+            switch (g.getStorage()) {
+                case Storage::Sparse: bellmanFordBatch(g, g.sparseView(), queries, order, groups, options.threads, results); break;
+                case Storage::Compressed: bellmanFordBatch(g, g.compressedView(), queries, order, groups, options.threads, results); break;
+                case Storage::Bitset: bellmanFordBatch(g, g.bitsetView(), queries, order, groups, options.threads, results); break;
+                default: bellmanFordBatch(g, g.denseView(), queries, order, groups, options.threads, results);
+            }
+        } else if (backend == PathBackend::DeltaStepping) {
+            switch (g.getStorage()) {
+                case Storage::Sparse: deltaBatch(g.sparseView(), queries, order, groups, options, results); break;
+                case Storage::Compressed: deltaBatch(g.compressedView(), queries, order, groups, options, results); break;
+                case Storage::Bitset: deltaBatch(g.bitsetView(), queries, order, groups, options, results); break;
+                default: deltaBatch(g.denseView(), queries, order, groups, options, results);
+            }
+        } else {
+            switch (g.getStorage()) {
+                case Storage::Sparse: answerBatch(g.sparseView(), queries, order, groups, options.threads, results); break;
+                case Storage::Compressed: answerBatch(g.compressedView(), queries, order, groups, options.threads, results); break;
+                case Storage::Bitset: answerBatch(g.bitsetView(), queries, order, groups, options.threads, results); break;
+                default: answerBatch(g.denseView(), queries, order, groups, options.threads, results);
+            }
+        }
+        if (g.isReordered()) {
+            for (size_t i = 0; i < results.size(); i++) {
+                results[i].src = requested[i].first;
+                results[i].dest = requested[i].second;
+                results[i].path = originalIds(g, results[i].path);
+            }
+        }
+        return results;
+    }
+
+    bool Algorithms::dfs(size_t v,vector<bool>& visited, vector<bool>& recStack, const GraphView& g, int parent = -1, bool isDirected = false) {
+        ARIEL_PROFILE_CALL("dfs");
+        if (g.isReordered()) {
+            vector<bool> seen = internalFlags(g, visited), onStack = internalFlags(g, recStack);
+            GraphView internal = g;
+            internal.setOrder(nullptr, nullptr);
+            int internalParent = parent < 0 ? parent : static_cast<int>(g.internalId(static_cast<size_t>(parent)));
+            bool found = dfs(g.internalId(v), seen, onStack, internal, internalParent, isDirected);
+            restoreFlags(g, seen, visited);
+            restoreFlags(g, onStack, recStack);
+            return found;
+        }
+        size_t parentVertex = parent < 0 ? NO_PARENT : static_cast<size_t>(parent);
+        vector<size_t> cycle;
+        switch (g.getStorage()) {
+            case Storage::Sparse: {
+                vector<DfsFrame<SparseView>> stack;
+                return cycleFrom(g.sparseView(), v, visited, recStack, parentVertex, isDirected, stack, cycle);
+            }
+            case Storage::Compressed: {
+                vector<DfsFrame<CompressedView>> stack;
+                return cycleFrom(g.compressedView(), v, visited, recStack, parentVertex, isDirected, stack, cycle);
+            }
+            case Storage::Bitset: {
+                vector<DfsFrame<BitsetView>> stack;
+                return cycleFrom(g.bitsetView(), v, visited, recStack, parentVertex, isDirected, stack, cycle);
+            }
+            default: {
+                vector<DfsFrame<DenseView>> stack;
+                return cycleFrom(g.denseView(), v, visited, recStack, parentVertex, isDirected, stack, cycle);
+            }
+        }
+    }
+
+    const int DistanceTable::UNREACHABLE;
+    const uint32_t DistanceTable::NO_HOP;
+
+    vector<size_t> DistanceTable::path(size_t u, size_t v) const {
+        if (nextHops.empty()) {
+            throw logic_error("The distance table was built without next hops.");
+        }
+        vector<size_t> walk;
+        if (!reachable(u, v)) return walk;
+        walk.push_back(u);
+        while (u != v) {
+            u = nextHops[u * size + v];
+            walk.push_back(u);
+        }
+        return walk;
+    }
+
+    DistanceTable Algorithms::allPairsShortestPaths(const GraphView& g, bool withNextHops, size_t threads) {
+        ARIEL_PROFILE_CALL("allPairsShortestPaths");
+        const size_t n = g.size();
+        if (withNextHops && n >= DistanceTable::NO_HOP) {
+            throw invalid_argument("Invalid graph: Too many vertices for a next-hop table.");
+        }
+        DistanceTable table;
+        table.size = n;
+        table.distances.assign(n * n, DistanceTable::UNREACHABLE);
+        if (withNextHops) table.nextHops.assign(n * n, DistanceTable::NO_HOP);
+        switch (g.getStorage()) {
+            case Storage::Sparse: sparseAllPairs(g.sparseView(), table, threads); break;
+            case Storage::Compressed: sparseAllPairs(g.compressedView(), table, threads); break;
+            case Storage::Bitset: sparseAllPairs(g.bitsetView(), table, threads); break;
+            default: denseAllPairs(g.denseView(), table, threads);
+        }
+        for (size_t u = 0; u < n; u++) {
+            if (table.distances[u * n + u] < 0) {
+                throw invalid_argument("Invalid graph: The graph contains a negative cycle.");
+            }
+        }
+        if (g.isReordered()) restoreTable(g, table);
+        return table;
+    }
+
+    bool Algorithms::isContainsCycle(const GraphView& g) {
+        ARIEL_PROFILE_CALL("isContainsCycle");
+        return cachedAnswer(g, CONTAINS_CYCLE, [&]() { return flagText(!findCycle(g).empty()); }) == "1";
+    }
+
+    vector<size_t> Algorithms::findCycle(const GraphView& g) {
+        ARIEL_PROFILE_CALL("findCycle");
+        switch (g.getStorage()) {
+            case Storage::Sparse: return originalIds(g, findCycleIn(g, g.sparseView(), g.isDirected()));
+            case Storage::Compressed: return originalIds(g, findCycleIn(g, g.compressedView(), g.isDirected()));
+            case Storage::Bitset: return originalIds(g, findCycleIn(g, g.bitsetView(), g.isDirected()));
+            default: return originalIds(g, findCycleIn(g, g.denseView(), g.isDirected()));
+        }
+    }
+
+    vector<size_t> Algorithms::negativeCycle(const GraphView& g, size_t threads) {
+        ARIEL_PROFILE_CALL("negativeCycle");
+        if (!g.hasNegativeWeights()) return vector<size_t>();
+        switch (g.getStorage()) {
+            case Storage::Sparse: return originalIds(g, anyNegativeCycle(g.sparseView(), threads));
+            case Storage::Compressed: return originalIds(g, anyNegativeCycle(g.compressedView(), threads));
+            case Storage::Bitset: return vector<size_t>();
+            default: return originalIds(g, anyNegativeCycle(g.denseView(), threads));
+        }
+    }
+
+    string Algorithms::isBipartite(const GraphView& g) {
+        ARIEL_PROFILE_CALL("isBipartite");
+        return cachedAnswer(g, BIPARTITE, [&]() -> string {
+            vector<size_t> setA, setB;
+            switch (g.getStorage()) {
+                case Storage::Sparse: return bipartiteAnswer(g, bipartite(g, g.sparseView(), setA, setB), setA, setB);
+                case Storage::Compressed: return bipartiteAnswer(g, bipartite(g, g.compressedView(), setA, setB), setA, setB);
+                case Storage::Bitset: return bipartiteAnswer(g, bitsetBipartite(g, g.bitsetView(), setA, setB), setA, setB);
+                default: return bipartiteAnswer(g, bipartite(g, g.denseView(), setA, setB), setA, setB);
+            }
+        });
+    }
+
+    // The sets can be listed in another order than the sequential ones, so the answer has its own slot.
+    string Algorithms::isBipartite(const GraphView& g, size_t threads) {
+        ARIEL_PROFILE_CALL("isBipartite(threads)");
+        return cachedAnswer(g, PARALLEL_BIPARTITE, [&]() -> string {
+            vector<size_t> setA, setB;
+            switch (g.getStorage()) {
+                case Storage::Sparse: return bipartiteAnswer(g, parallelBipartite(g, g.sparseView(), threads, setA, setB), setA, setB);
+                case Storage::Compressed: return bipartiteAnswer(g, parallelBipartite(g, g.compressedView(), threads, setA, setB), setA, setB);
+                case Storage::Bitset: return bipartiteAnswer(g, parallelBipartite(g, g.bitsetView(), threads, setA, setB), setA, setB);
+                default: return bipartiteAnswer(g, parallelBipartite(g, g.denseView(), threads, setA, setB), setA, setB);
+            }
+        });
+    }
+}
@@ -1,17 +1,110 @@
 #pragma once
 
 #include "Graph.hpp"
+#include <cstdint>
+#include <limits>
 #include <vector> 
+#include <utility>
 
 namespace ariel {
+    // Answer to one (src, dest) query of Algorithms::shortestPaths.
+    struct PathResult {
+        size_t src;
+        size_t dest;
+        bool reachable;
+        int distance;          // -1 when dest is unreachable
+        vector<size_t> path;   // src ... dest, empty when dest is unreachable
+    };
+
+    // Engine behind shortestPath and shortestPaths.
+    enum class PathBackend {
+        Auto,            // BellmanFord when the graph has a negative weight, Dijkstra otherwise
+        Dijkstra,        // indexed-heap Dijkstra; a batch runs its sources in parallel
+        DeltaStepping,   // parallel delta-stepping (DeltaStepping.hpp); non-negative weights only
+        BellmanFord      // parallel frontier Bellman-Ford (BellmanFord.hpp); any weights
+    };
+
+    struct PathOptions {
+        PathBackend backend;
+        int delta;       // delta-stepping bucket width, 0 = mean edge weight
+        size_t threads;  // 0 = all hardware threads
+
+        PathOptions(PathBackend engine = PathBackend::Auto, int bucketWidth = 0, size_t threadCount = 0)
+            : backend(engine), delta(bucketWidth), threads(threadCount) {}
+    };
+
+    // Result of Algorithms::allPairsShortestPaths: row-major size x size tables.
+    struct DistanceTable {
+        static const int UNREACHABLE = numeric_limits<int>::max();
+        static const uint32_t NO_HOP = numeric_limits<uint32_t>::max();
+
+        size_t size;
+        vector<int> distances;       // UNREACHABLE when there is no path
+        vector<uint32_t> nextHops;   // first vertex after u on a shortest u -> v path; empty unless requested
+
+        int distance(size_t u, size_t v) const { return distances[u * size + v]; }
+        bool reachable(size_t u, size_t v) const { return distances[u * size + v] != UNREACHABLE; }
+        // u ... v following the next hops; empty when v is unreachable.
+        // Throws logic_error when the table was built without next hops.
+        vector<size_t> path(size_t u, size_t v) const;
+    };
+
+    // Counters of the Algorithms result cache; `versions` is how many graph versions it holds.
+    struct CacheStats {
+        uint64_t hits;
+        uint64_t misses;
+        size_t versions;
+    };
+
     class Algorithms {
     public:
-        static bool isConnected(Graph& g);
-        static string shortestPath(Graph& g, size_t src, size_t dest);
-        static bool isContainsCycle(Graph& g);
-        static string isBipartite(Graph& g);
-        static void DFS(size_t start, std::vector<bool>& visited, vector<vector<int>>& matrixGraph);
+        // Every entry point reads the graph through a non-owning GraphView, so a
+        // Graph passed here is never copied and can be shared between threads.
+        // On a reordered graph (Graph::reorder) vertex ids going in and out are
+        // the loaded ones; the isBipartite sides are then listed in increasing id.
+        static bool isConnected(const GraphView& g);
+        // Same answer through the parallel direction-optimizing BFS on `threads` workers (0 = all hardware threads).
+        static bool isConnected(const GraphView& g, size_t threads);
+        // Dijkstra, or Bellman-Ford on a graph with a negative weight. Throws
+        // invalid_argument, naming the cycle, when src reaches a negative cycle.
+        static string shortestPath(const GraphView& g, size_t src, size_t dest);
+        // Same answer on the chosen backend. Delta-stepping spreads the edge relaxations
+        // of one search over options.threads workers and throws invalid_argument on a
+        // negative weight; among equally short paths it returns the one whose
+        // predecessors have the smallest ids. Dijkstra on negative weights may be wrong.
+        static string shortestPath(const GraphView& g, size_t src, size_t dest, const PathOptions& options);
+        // Batch version of shortestPath: runs one search per distinct source, Dijkstras on up
+        // to `threads` workers (0 = all hardware threads). Results follow the query order.
+        static vector<PathResult> shortestPaths(const GraphView& g, const vector<pair<size_t, size_t>>& queries, size_t threads = 0);
+        // With PathBackend::DeltaStepping or BellmanFord the distinct sources run one
+        // after another, each search using every worker.
+        static vector<PathResult> shortestPaths(const GraphView& g, const vector<pair<size_t, size_t>>& queries, const PathOptions& options);
+        // Distances between every pair of vertices, on up to `threads` workers (0 = all
+        // hardware threads). Dense graphs run a cache-tiled Floyd-Warshall, Sparse,
+        // Bitset and Compressed graphs one Dijkstra per source, reweighted first
+        // (Johnson) when a negative weight is present. Throws invalid_argument on a
+        // negative cycle.
+        static DistanceTable allPairsShortestPaths(const GraphView& g, bool withNextHops = false, size_t threads = 0);
+        static bool isContainsCycle(const GraphView& g);
+        // The first cycle found as a closed walk, e.g. {0, 1, 2, 0}; empty when the graph is acyclic.
+        static vector<size_t> findCycle(const GraphView& g);
+        // A cycle of negative total weight anywhere in the graph as a closed walk, empty
+        // when there is none. Runs the parallel Bellman-Ford from every vertex at once.
+        static vector<size_t> negativeCycle(const GraphView& g, size_t threads = 0);
+        static string isBipartite(const GraphView& g);
+        // Parallel BFS version; within one BFS level the vertices are listed in increasing order.
+        static string isBipartite(const GraphView& g, size_t threads);
+        // Optional cache of the isConnected, isContainsCycle and isBipartite answers,
+        // off by default. Answers are keyed on the version stamp the GraphView carries
+        // (Graph::getVersion), so asking again about an unchanged Graph is a lookup
+        // and loadGraph or any mutation makes the next question miss. The answers of
+        // the 64 most recent versions are kept.
+        static void setResultCache(bool enabled);
+        static CacheStats resultCacheStats();
+        // Drops every cached answer and zeroes the counters.
+        static void clearResultCache();
+        static void DFS(size_t start, std::vector<bool>& visited, const GraphView& g);
         static size_t minDistance(std::vector<int>& srcPathDest, vector<bool>& visited);
-        static bool dfs(size_t v,vector<bool>& visited, vector<bool>& recStack, vector<vector<int>>& matrixGraph, int parent , bool isDirected);
+        static bool dfs(size_t v,vector<bool>& visited, vector<bool>& recStack, const GraphView& g, int parent , bool isDirected);
     };
 }
@@ -0,0 +1,171 @@
+#pragma once
+
+#include "GraphView.hpp"
+#include "Parallel.hpp"
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <vector>
+using namespace std;
+
+namespace ariel {
+    // Frontier-based Bellman-Ford (SPFA without the FIFO): every round relaxes
+    // the out-edges of the vertices whose distance dropped in the round before,
+    // with the frontier cut into chunks that a team of threads pulls from. The
+    // distance and the predecessor of a vertex live in one 64-bit word updated
+    // by compare-and-swap, so a predecessor always matches its distance.
+    //
+    // Any cycle among the predecessor links is negative, so the links are
+    // searched for one in rounds 1, 2, 4, 8, ...: a negative cycle is reported
+    // within a few laps of it instead of after the n rounds that prove it.
+    template <typename View>
+    class BellmanFord {
+        public:
+            static const size_t NONE = SIZE_MAX;
+
+        private:
+            static const int INF = INT_MAX;
+            static const uint32_t NO_PARENT = UINT32_MAX;
+            static const size_t CHUNK = 64;
+
+            const View& adj;
+            size_t threads;
+            vector<atomic<uint64_t>> state;      // (distance ^ sign bit) << 32 | predecessor
+            vector<atomic<size_t>> queuedRound;  // last round that put the vertex in the next frontier
+            vector<size_t> frontier;
+            vector<vector<size_t>> local;
+            vector<size_t> negativeCycle;
+            atomic<bool> clamped;
+
+            // The sign bit is flipped so unsigned order on the packed word is int order on the distance.
+            static uint64_t pack(int distance, uint32_t parent) {
+                return (uint64_t(uint32_t(distance) ^ 0x80000000U) << 32) | parent;
+            }
+            static int unpackDistance(uint64_t word) { return static_cast<int>(uint32_t(word >> 32) ^ 0x80000000U); }
+            static uint32_t unpackParent(uint64_t word) { return static_cast<uint32_t>(word); }
+
+            void relax(size_t u, size_t round, size_t id) {
+                int base = unpackDistance(state[u].load(memory_order_relaxed));
+                ARIEL_COUNT_VERTICES(1);
+                for (typename View::Cursor it = adj.neighbors(u); it.valid(); it.next()) {
+                    ARIEL_COUNT_EDGES(1);
+                    // Clamped so that the runaway distances on a negative cycle cannot wrap around.
+                    long long sum = static_cast<long long>(base) + it.weight();
+                    if (sum < INT_MIN) {
+                        clamped.store(true, memory_order_relaxed);
+                        sum = INT_MIN;
+                    }
+                    int candidate = static_cast<int>(sum);
+                    uint64_t proposed = pack(candidate, static_cast<uint32_t>(u));
+                    atomic<uint64_t>& target = state[it.target()];
+                    uint64_t current = target.load(memory_order_relaxed);
+                    while ((proposed >> 32) < (current >> 32)) {
+                        if (target.compare_exchange_weak(current, proposed, memory_order_relaxed)) {
+                            if (queuedRound[it.target()].exchange(round, memory_order_relaxed) != round) {
+                                local[id].push_back(it.target());
+                            }
+                            break;
+                        }
+                    }
+                }
+            }
+
+            // Finds a cycle among the predecessor links, as a closed walk in edge order.
+            bool findParentCycle() {
+                const size_t n = adj.size();
+                vector<size_t> seenBy(n, NONE);
+                for (size_t start = 0; start < n; start++) {
+                    size_t v = start;
+                    while (v != NONE && seenBy[v] == NONE) {
+                        seenBy[v] = start;
+                        uint32_t parent = unpackParent(state[v].load(memory_order_relaxed));
+                        v = parent == NO_PARENT ? NONE : parent;
+                    }
+                    if (v == NONE || seenBy[v] != start) continue;
+                    // v is on a cycle: walk it once, then reverse the parent order into edge order.
+                    negativeCycle.assign(1, v);
+                    for (size_t at = unpackParent(state[v].load(memory_order_relaxed)); at != v;
+                         at = unpackParent(state[at].load(memory_order_relaxed))) {
+                        negativeCycle.push_back(at);
+                    }
+                    negativeCycle.push_back(v);
+                    reverse(negativeCycle.begin(), negativeCycle.end());
+                    return true;
+                }
+                return false;
+            }
+
+        public:
+            BellmanFord(const View& view, size_t threadCount)
+                : adj(view), threads(resolveThreads(threadCount)), state(view.size()), queuedRound(view.size()), local(threads), clamped(false) {}
+
+            // Distances from src, or from every vertex at distance 0 when src is NONE
+            // (the usual virtual source for finding any negative cycle). Returns false
+            // when a negative cycle is reachable; negativeCycleFound() then holds it.
+            bool run(size_t src) {
+                const size_t n = adj.size();
+                negativeCycle.clear();
+                frontier.clear();
+                clamped.store(false);
+                for (size_t v = 0; v < n; v++) {
+                    bool start = src == NONE || v == src;
+                    state[v].store(pack(start ? 0 : INF, NO_PARENT), memory_order_relaxed);
+                    queuedRound[v].store(0, memory_order_relaxed);
+                    if (start) frontier.push_back(v);
+                }
+                size_t round = 1;
+                bool cycle = false;
+                atomic<size_t> next(0);
+                Barrier barrier(threads);
+                runTeam(threads, [&](size_t id) {
+                    while (!frontier.empty() && !cycle) {
+                        local[id].clear();
+                        for (size_t begin = next.fetch_add(CHUNK); begin < frontier.size(); begin = next.fetch_add(CHUNK)) {
+                            size_t end = min(frontier.size(), begin + CHUNK);
+                            for (size_t k = begin; k < end; k++) relax(frontier[k], round, id);
+                        }
+                        barrier.wait();
+                        if (id == 0) {
+                            frontier.clear();
+                            for (size_t t = 0; t < threads; t++) frontier.insert(frontier.end(), local[t].begin(), local[t].end());
+                            if (!frontier.empty() && (round & (round - 1)) == 0) cycle = findParentCycle();
+                            round++;
+                            next.store(0);
+                        }
+                        barrier.wait();
+                    }
+                });
+                // A distance stuck at INT_MIN stops improving, which can drain the
+                // frontier while a cycle is still there.
+                if (!cycle && clamped.load()) cycle = findParentCycle();
+                return !cycle;
+            }
+
+            const vector<size_t>& negativeCycleFound() const { return negativeCycle; }
+
+            // INT_MAX for unreached vertices.
+            void distances(vector<int>& out) const {
+                out.resize(state.size());
+                for (size_t v = 0; v < state.size(); v++) out[v] = unpackDistance(state[v].load(memory_order_relaxed));
+            }
+
+            // -1 for the source and unreached vertices.
+            void predecessors(vector<int>& out) const {
+                out.resize(state.size());
+                for (size_t v = 0; v < state.size(); v++) {
+                    uint32_t parent = unpackParent(state[v].load(memory_order_relaxed));
+                    out[v] = parent == NO_PARENT ? -1 : static_cast<int>(parent);
+                }
+            }
+    };
+
+    template <typename View>
+    const size_t BellmanFord<View>::NONE;
+    template <typename View>
+    const int BellmanFord<View>::INF;
+    template <typename View>
+    const uint32_t BellmanFord<View>::NO_PARENT;
+    template <typename View>
+    const size_t BellmanFord<View>::CHUNK;
+}
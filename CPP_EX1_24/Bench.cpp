@@ -0,0 +1,979 @@
+/*
+ * Benchmarks for the graph algorithms.
+ * Build and run with: make bench
+ */
+
+#include "Graph.hpp"
+#include "Algorithms.hpp"
+#include "PathSearch.hpp"
+#include "ContractionHierarchy.hpp"
+#include "ConnectedComponents.hpp"
+#include "StronglyConnectedComponents.hpp"
+#include "Generators.hpp"
+using ariel::Algorithms;
+using ariel::Graph;
+using ariel::Storage;
+using ariel::EdgeEntry;
+using ariel::DistanceTable;
+using ariel::PathSearch;
+using ariel::ContractionHierarchy;
+using ariel::ConnectedComponents;
+using ariel::StronglyConnectedComponents;
+using ariel::PathResult;
+using ariel::PathBackend;
+using ariel::PathOptions;
+using ariel::CacheStats;
+using ariel::GraphFamily;
+using ariel::VertexOrder;
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <limits>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+using namespace std;
+
+namespace {
+    // Undirected graph where every vertex gets `degree` random neighbors (weights 1..100).
+    vector<vector<int>> randomSparseMatrix(size_t n, size_t degree, unsigned seed) {
+        mt19937 rng(seed);
+        uniform_int_distribution<size_t> vertex(0, n - 1);
+        uniform_int_distribution<int> weight(1, 100);
+        vector<vector<int>> matrix(n, vector<int>(n, 0));
+        for (size_t u = 0; u < n; u++) {
+            for (size_t k = 0; k < degree; k++) {
+                size_t v = vertex(rng);
+                if (u == v) continue;
+                matrix[u][v] = matrix[v][u] = weight(rng);
+            }
+        }
+        return matrix;
+    }
+
+    vector<vector<int>> randomDenseMatrix(size_t n, unsigned seed) {
+        mt19937 rng(seed);
+        uniform_int_distribution<int> weight(1, 100);
+        vector<vector<int>> matrix(n, vector<int>(n, 0));
+        for (size_t u = 0; u < n; u++) {
+            for (size_t v = u + 1; v < n; v++) {
+                matrix[u][v] = matrix[v][u] = weight(rng);
+            }
+        }
+        return matrix;
+    }
+
+    // The O(V^2) linear-scan Dijkstra that shortestPath used before the heap,
+    // kept here as the baseline. Returns the distance to dest.
+    int linearScanDistance(vector<vector<int>>& matrixGraph, size_t src, size_t dest) {
+        vector<bool> visited(matrixGraph.size(), false);
+        vector<int> srcPathDest(matrixGraph.size(), numeric_limits<int>::max());
+        srcPathDest[src] = 0;
+        for (size_t count = 0; count < matrixGraph.size() - 1; count++) {
+            size_t u = Algorithms::minDistance(srcPathDest, visited);
+            if (u == numeric_limits<size_t>::max()) break;
+            visited[u] = true;
+            for (size_t v = 0; v < matrixGraph.size(); v++) {
+                if (!visited[v] && matrixGraph[u][v] && srcPathDest[u] != numeric_limits<int>::max() &&
+                    srcPathDest[u] + matrixGraph[u][v] < srcPathDest[v]) {
+                    srcPathDest[v] = srcPathDest[u] + matrixGraph[u][v];
+                }
+            }
+        }
+        return srcPathDest[dest];
+    }
+
+    // The two-pass classification loadGraph ran before the blocked version, kept as the baseline.
+    pair<bool, int> twoPassClassify(const vector<vector<int>>& matrixGraph) {
+        bool isDirected = false;
+        int numOfEdges = 0;
+        for (size_t i = 0; i < matrixGraph.size(); ++i) {
+            for (size_t j = 0; j < matrixGraph.size(); ++j) {
+                if (matrixGraph[i][j] != matrixGraph[j][i]) {
+                    isDirected = true;
+                }
+            }
+        }
+        for (size_t i = 0; i < matrixGraph.size(); ++i) {
+            for (size_t j = 0; j < matrixGraph.size(); ++j) {
+                if (matrixGraph[i][j] != 0) {
+                    if (isDirected) {
+                        numOfEdges++;
+                    } else if (i < j) {
+                        numOfEdges += 2;
+                    }
+                }
+            }
+        }
+        return make_pair(isDirected, numOfEdges);
+    }
+
+    double millisSince(chrono::steady_clock::time_point start) {
+        return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    }
+
+    void benchShortestPath(const string& name, vector<vector<int>>& matrix, size_t queries) {
+        Graph dense, sparse;
+        dense.loadGraph(matrix);
+        sparse.loadGraph(matrix, Storage::Sparse);
+        mt19937 rng(7);
+        uniform_int_distribution<size_t> vertex(0, matrix.size() - 1);
+        vector<pair<size_t, size_t>> pairs;
+        for (size_t i = 0; i < queries; i++) {
+            pairs.push_back(make_pair(vertex(rng), vertex(rng)));
+        }
+
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        long long checksum = 0;
+        for (size_t i = 0; i < pairs.size(); i++) {
+            checksum += linearScanDistance(matrix, pairs[i].first, pairs[i].second);
+        }
+        double linear = millisSince(start) / static_cast<double>(queries);
+
+        start = chrono::steady_clock::now();
+        for (size_t i = 0; i < pairs.size(); i++) {
+            checksum += static_cast<long long>(Algorithms::shortestPath(dense, pairs[i].first, pairs[i].second).size());
+        }
+        double heapDense = millisSince(start) / static_cast<double>(queries);
+
+        start = chrono::steady_clock::now();
+        for (size_t i = 0; i < pairs.size(); i++) {
+            checksum += static_cast<long long>(Algorithms::shortestPath(sparse, pairs[i].first, pairs[i].second).size());
+        }
+        double heapSparse = millisSince(start) / static_cast<double>(queries);
+
+        cout << left << setw(24) << name << fixed << setprecision(3)
+             << setw(16) << linear << setw(16) << heapDense << setw(16) << heapSparse
+             << " (checksum " << checksum << ")" << endl;
+    }
+
+    // Thousands of queries spread over a few hundred sources: single calls vs the batch API.
+    void benchBatch(vector<vector<int>>& matrix, size_t sources, size_t queriesPerSource) {
+        Graph g;
+        g.loadGraph(matrix, Storage::Sparse);
+        mt19937 rng(11);
+        uniform_int_distribution<size_t> vertex(0, matrix.size() - 1);
+        vector<pair<size_t, size_t>> queries;
+        for (size_t s = 0; s < sources; s++) {
+            size_t src = vertex(rng);
+            for (size_t q = 0; q < queriesPerSource; q++) {
+                queries.push_back(make_pair(src, vertex(rng)));
+            }
+        }
+        shuffle(queries.begin(), queries.end(), rng);
+
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        size_t checksum = 0;
+        for (size_t i = 0; i < queries.size(); i++) {
+            checksum += Algorithms::shortestPath(g, queries[i].first, queries[i].second).size();
+        }
+        cout << left << setw(24) << "single calls" << fixed << setprecision(1)
+             << static_cast<double>(queries.size()) / millisSince(start) * 1000.0 << " queries/s" << endl;
+
+        size_t maxThreads = thread::hardware_concurrency() > 0 ? thread::hardware_concurrency() : 1;
+        for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+            start = chrono::steady_clock::now();
+            vector<ariel::PathResult> results = Algorithms::shortestPaths(g, queries, threads);
+            checksum += results.size();
+            cout << left << setw(24) << ("batch, " + to_string(threads) + " threads") << fixed << setprecision(1)
+                 << static_cast<double>(queries.size()) / millisSince(start) * 1000.0 << " queries/s" << endl;
+        }
+        cout << "(checksum " << checksum << ")" << endl;
+    }
+
+    // isConnected / isBipartite on the matrix vs the bitset storage.
+    void benchUnweighted(const string& name, vector<vector<int>>& matrix, size_t repeats) {
+        const Storage modes[] = {Storage::Dense, Storage::Sparse, Storage::Bitset};
+        const char* labels[] = {"matrix", "CSR", "bitset"};
+        cout << left << setw(24) << name;
+        size_t checksum = 0;
+        for (size_t m = 0; m < 3; m++) {
+            Graph g;
+            g.loadGraph(matrix, modes[m]);
+            chrono::steady_clock::time_point start = chrono::steady_clock::now();
+            for (size_t r = 0; r < repeats; r++) {
+                checksum += Algorithms::isConnected(g) ? 1U : 0U;
+                checksum += Algorithms::isBipartite(g).size();
+            }
+            cout << labels[m] << " " << fixed << setprecision(3) << setw(10) << millisSince(start) / static_cast<double>(repeats);
+        }
+        cout << " ms (checksum " << checksum << ")" << endl;
+    }
+
+    // Scaling of the parallel BFS engine from 1 thread to every hardware thread.
+    void benchParallelBFS(const string& name, vector<vector<int>>& matrix, size_t repeats) {
+        Graph g;
+        g.loadGraph(matrix, Storage::Sparse);
+        size_t maxThreads = thread::hardware_concurrency() > 0 ? thread::hardware_concurrency() : 1;
+        size_t checksum = 0;
+        double single = 0;
+        cout << name << endl;
+        for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+            chrono::steady_clock::time_point start = chrono::steady_clock::now();
+            for (size_t r = 0; r < repeats; r++) {
+                checksum += Algorithms::isConnected(g, threads) ? 1U : 0U;
+                checksum += Algorithms::isBipartite(g, threads).size();
+            }
+            double elapsed = millisSince(start) / static_cast<double>(repeats);
+            if (threads == 1) single = elapsed;
+            cout << "  " << left << setw(12) << (to_string(threads) + " threads") << fixed << setprecision(3)
+                 << setw(12) << elapsed << "ms  speedup " << setprecision(2) << single / elapsed << "x" << endl;
+        }
+        cout << "  (checksum " << checksum << ")" << endl;
+    }
+
+    // loadGraph on large matrices: the copy plus the classification pass.
+    void benchLoad(size_t n) {
+        vector<vector<int>> matrix = randomSparseMatrix(n, 4, 3);
+        for (int pass = 0; pass < 2; pass++) {
+            if (pass == 1) matrix[0][1] += 1;  // asymmetric in the first tile: the symmetry test stops there
+            chrono::steady_clock::time_point start = chrono::steady_clock::now();
+            pair<bool, int> baseline = twoPassClassify(matrix);
+            double twoPass = millisSince(start);
+
+            Graph g;
+            start = chrono::steady_clock::now();
+            g.loadGraph(matrix);
+            double load = millisSince(start);
+            start = chrono::steady_clock::now();
+            g.classifyGraph();
+            double blocked = millisSince(start);
+            cout << left << setw(8) << n << setw(12) << (pass == 0 ? "symmetric" : "asymmetric") << fixed << setprecision(1)
+                 << setw(14) << twoPass << setw(14) << blocked << setw(14) << load
+                 << (baseline.first == g.getIsDirected() && baseline.second == g.getNumOfEdges() ? "" : " MISMATCH") << endl;
+        }
+    }
+
+    // loadGraph from rows versus openGraph on the file saveGraph wrote. The
+    // first algorithm call after openGraph is timed too, since that is where
+    // the pages of the mapping are actually read.
+    void benchFile(size_t n, Storage mode) {
+        vector<vector<int>> matrix = randomSparseMatrix(n, 4, 4);
+        const string path = "bench_graph.bin";
+        Graph g;
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        g.loadGraph(matrix, mode);
+        double load = millisSince(start);
+        start = chrono::steady_clock::now();
+        g.saveGraph(path);
+        double save = millisSince(start);
+
+        Graph mapped;
+        start = chrono::steady_clock::now();
+        mapped.openGraph(path);
+        double open = millisSince(start);
+        start = chrono::steady_clock::now();
+        bool connected = Algorithms::isConnected(mapped);
+        double firstCall = millisSince(start);
+        remove(path.c_str());
+        cout << left << setw(8) << n << setw(12) << (mode == Storage::Dense ? "dense" : "CSR") << fixed << setprecision(3)
+             << setw(14) << load << setw(14) << save << setw(14) << open << setw(14) << firstCall
+             << (connected == Algorithms::isConnected(g) && mapped.getNumOfEdges() == g.getNumOfEdges() ? "" : " MISMATCH") << endl;
+    }
+
+    // Undirected edge list with `degree` random neighbors per vertex, both directions written.
+    size_t writeEdgeList(const string& path, size_t n, size_t degree, unsigned seed) {
+        mt19937 rng(seed);
+        uniform_int_distribution<size_t> vertex(0, n - 1);
+        uniform_int_distribution<int> weight(1, 100);
+        FILE* file = fopen(path.c_str(), "w");
+        size_t lines = 0;
+        for (size_t u = 0; u < n; u++) {
+            for (size_t k = 0; k < degree; k++) {
+                size_t v = vertex(rng);
+                if (v == u) continue;
+                int w = weight(rng);
+                fprintf(file, "%zu %zu %d\n%zu %zu %d\n", u, v, w, v, u, w);
+                lines += 2;
+            }
+        }
+        fclose(file);
+        return lines;
+    }
+
+    // ifstream >> into an edge vector (parsing only) versus loadEdgeList building
+    // the whole CSR graph.
+    void benchEdgeList(size_t n, size_t degree) {
+        const string path = "bench_edges.txt";
+        size_t lines = writeEdgeList(path, n, degree, 5);
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        ifstream in(path.c_str());
+        vector<pair<pair<size_t, size_t>, int>> edges;
+        size_t u, v;
+        int w;
+        while (in >> u >> v >> w) edges.push_back(make_pair(make_pair(u, v), w));
+        double stream = millisSince(start);
+
+        Graph g;
+        start = chrono::steady_clock::now();
+        g.loadEdgeList(path);
+        double loader = millisSince(start);
+        remove(path.c_str());
+        cout << left << setw(10) << n << setw(12) << lines << fixed << setprecision(1)
+             << setw(16) << stream << setw(16) << loader << setprecision(2) << setw(12) << lines / loader / 1000.0
+             << (g.getIsDirected() || edges.size() != lines ? " MISMATCH" : "") << endl;
+    }
+
+    // 1000 cell updates (500 undirected edges) applied in place, as one batch and
+    // then one by one, versus rebuilding the matrix and calling loadGraph again.
+    void benchUpdates(size_t n, Storage mode) {
+        vector<vector<int>> matrix = randomSparseMatrix(n, 4, 6);
+        Graph g;
+        g.loadGraph(matrix, mode);
+        mt19937 rng(7);
+        uniform_int_distribution<size_t> vertex(0, n - 1);
+        uniform_int_distribution<int> weight(0, 20);
+        vector<EdgeEntry> updates;
+        while (updates.size() < 1000) {
+            EdgeEntry e = {vertex(rng), vertex(rng), weight(rng)};
+            EdgeEntry mirror = {e.to, e.from, e.weight};
+            updates.push_back(e);
+            updates.push_back(mirror);
+        }
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        g.applyUpdates(updates);
+        double batch = millisSince(start);
+        for (size_t k = 0; k < updates.size(); k++) matrix[updates[k].from][updates[k].to] = updates[k].weight;
+        for (size_t k = 0; k < updates.size(); k++) updates[k].weight = (updates[k].weight + 1) % 21;
+        start = chrono::steady_clock::now();
+        for (size_t k = 0; k < updates.size(); k++) g.setWeight(updates[k].from, updates[k].to, updates[k].weight);
+        double single = millisSince(start);
+
+        start = chrono::steady_clock::now();
+        for (size_t k = 0; k < updates.size(); k++) matrix[updates[k].from][updates[k].to] = updates[k].weight;
+        Graph reloaded;
+        reloaded.loadGraph(matrix, mode);
+        double reload = millisSince(start);
+        cout << left << setw(8) << n << setw(12) << (mode == Storage::Dense ? "dense" : "CSR") << fixed << setprecision(3)
+             << setw(16) << batch << setw(16) << single << setw(16) << reload
+             << (g.getNumOfEdges() == reloaded.getNumOfEdges() && g.getIsDirected() == reloaded.getIsDirected() ? "" : " MISMATCH") << endl;
+    }
+
+    // A monitoring loop: undirected edges arrive in batches and connectivity is
+    // polled after each one, by a fresh isConnected traversal or by inserting
+    // the batch into a ConnectedComponents built once.
+    void benchComponents(size_t n, size_t batches, size_t batchEdges) {
+        const string path = "bench_components.txt";
+        writeEdgeList(path, n, 1, 12);
+        Graph g;
+        g.loadEdgeList(path);
+        remove(path.c_str());
+        mt19937 rng(13);
+        uniform_int_distribution<size_t> vertex(0, n - 1);
+        uniform_int_distribution<int> weight(1, 20);
+        vector<vector<EdgeEntry>> stream(batches);
+        for (size_t b = 0; b < batches; b++) {
+            for (size_t k = 0; k < batchEdges; k++) {
+                EdgeEntry e = {vertex(rng), vertex(rng), weight(rng)};
+                EdgeEntry mirror = {e.to, e.from, e.weight};
+                stream[b].push_back(e);
+                stream[b].push_back(mirror);
+            }
+        }
+
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        ConnectedComponents components(g);
+        double build = millisSince(start);
+        double traversal = 0, incremental = 0;
+        size_t mismatches = 0;
+        for (size_t b = 0; b < batches; b++) {
+            g.applyUpdates(stream[b]);
+            start = chrono::steady_clock::now();
+            bool byTraversal = Algorithms::isConnected(g);
+            traversal += millisSince(start);
+            start = chrono::steady_clock::now();
+            components.addEdges(stream[b]);
+            bool byComponents = components.isConnected();
+            incremental += millisSince(start);
+            if (byTraversal != byComponents) mismatches++;
+        }
+        cout << left << setw(8) << n << setw(12) << batches << fixed << setprecision(3) << setw(16) << build
+             << setw(16) << traversal / static_cast<double>(batches) << setw(16) << incremental / static_cast<double>(batches)
+             << components.componentCount() << " components" << (mismatches == 0 ? "" : " MISMATCH") << endl;
+    }
+
+    // Random directed graph with `degree` out-edges per vertex: Tarjan against
+    // forward-backward, with the one-DFS isConnected for scale.
+    void benchStrongComponents(size_t n, size_t degree) {
+        const string path = "bench_scc.txt";
+        mt19937 rng(14);
+        uniform_int_distribution<size_t> vertex(0, n - 1);
+        FILE* file = fopen(path.c_str(), "w");
+        for (size_t u = 0; u < n; u++) {
+            for (size_t k = 0; k < degree; k++) fprintf(file, "%zu %zu 1\n", u, vertex(rng));
+        }
+        fclose(file);
+        Graph g;
+        g.loadEdgeList(path);
+        remove(path.c_str());
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        Algorithms::isConnected(g);
+        double dfs = millisSince(start);
+        start = chrono::steady_clock::now();
+        StronglyConnectedComponents tarjan(g, 1);
+        double sequential = millisSince(start);
+        cout << left << setw(10) << n << setw(8) << degree << setw(14) << "isConnected" << fixed << setprecision(1) << setw(10) << dfs << endl;
+        cout << left << setw(10) << n << setw(8) << degree << setw(14) << "Tarjan" << setw(10) << sequential
+             << tarjan.componentCount() << " components, largest " << *max_element(tarjan.componentSizes().begin(), tarjan.componentSizes().end())
+             << ", " << tarjan.condensationEdgeCount() << " DAG edges" << endl;
+        for (size_t threads : {size_t(2), size_t(4)}) {
+            start = chrono::steady_clock::now();
+            StronglyConnectedComponents split(g, threads);
+            double ms = millisSince(start);
+            cout << left << setw(10) << n << setw(8) << degree << setw(14) << ("FW-BW x" + to_string(threads)) << setw(10) << ms
+                 << (split.components() == tarjan.components() ? "" : "MISMATCH") << endl;
+        }
+    }
+
+    // The same three questions asked `repeats` times about an unchanged graph
+    // (after one warm-up round), with the result cache off and on, then once more
+    // after one edge update.
+    void benchResultCache(size_t n, size_t repeats) {
+        const string path = "bench_cache.txt";
+        writeEdgeList(path, n, 4, 15);
+        Graph g;
+        g.loadEdgeList(path);
+        remove(path.c_str());
+        Algorithms::clearResultCache();
+        double ms[2];
+        string answers[2];
+        for (int enabled = 0; enabled < 2; enabled++) {
+            Algorithms::setResultCache(enabled == 1);
+            Algorithms::isConnected(g);
+            Algorithms::isContainsCycle(g);
+            Algorithms::isBipartite(g);
+            chrono::steady_clock::time_point start = chrono::steady_clock::now();
+            for (size_t r = 0; r < repeats; r++) {
+                answers[enabled] = to_string(Algorithms::isConnected(g)) + to_string(Algorithms::isContainsCycle(g)) +
+                                   Algorithms::isBipartite(g).substr(0, 1);
+            }
+            ms[enabled] = millisSince(start) / static_cast<double>(repeats);
+        }
+        g.setWeight(0, 1, 7);
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        Algorithms::isConnected(g);
+        Algorithms::isContainsCycle(g);
+        Algorithms::isBipartite(g);
+        double afterUpdate = millisSince(start);
+        CacheStats stats = Algorithms::resultCacheStats();
+        Algorithms::setResultCache(false);
+        Algorithms::clearResultCache();
+        cout << left << setw(10) << n << fixed << setprecision(4) << setw(14) << ms[0] << setw(14) << ms[1]
+             << setprecision(1) << setw(16) << afterUpdate << stats.hits << " hits, " << stats.misses << " misses"
+             << (answers[0] == answers[1] ? "" : " MISMATCH") << endl;
+    }
+
+    // Weight of a path written as "a->b->c"; -1 when there is none.
+    long long pathWeight(const Graph& g, const string& path) {
+        if (path == "-1") return -1;
+        long long total = 0;
+        size_t at = 0, previous = 0;
+        for (bool first = true; at < path.size(); first = false) {
+            size_t end = path.find("->", at);
+            size_t v = stoul(path.substr(at, end == string::npos ? string::npos : end - at));
+            if (!first) total += g.getWeight(previous, v);
+            previous = v;
+            at = end == string::npos ? path.size() : end + 2;
+        }
+        return total;
+    }
+
+    // A Generators.hpp graph with its vertex ids shuffled, as in inputs whose ids
+    // carry no meaning, timed before and after each reordering on a DFS over the
+    // component of the highest-degree vertex and on 16 Dijkstra queries inside
+    // that component. The DFS runs on the view in the new ids, so it measures
+    // the traversal and not the translation of the visited flags.
+    void benchReordering(GraphFamily family, size_t requested) {
+        const size_t n = ariel::familyVertices(family, requested);
+        const string path = "bench_reorder.txt";
+        vector<size_t> label(n);
+        for (size_t v = 0; v < n; v++) label[v] = v;
+        mt19937 rng(23);
+        shuffle(label.begin(), label.end(), rng);
+        FILE* file = fopen(path.c_str(), "w");
+        vector<size_t> degree(n, 0);
+        ariel::generateGraph(family, n, 42, [&](size_t u, size_t v, int w) {
+            fprintf(file, "%zu %zu %d\n%zu %zu %d\n", label[u], label[v], w, label[v], label[u], w);
+            degree[label[u]]++;
+            degree[label[v]]++;
+        });
+        fprintf(file, "%zu %zu 0\n", n - 1, n - 1);
+        fclose(file);
+        Graph loaded;
+        loaded.loadEdgeList(path);
+        remove(path.c_str());
+        const size_t hub = static_cast<size_t>(max_element(degree.begin(), degree.end()) - degree.begin());
+        vector<bool> visited(n, false);
+        Algorithms::DFS(hub, visited, loaded);
+        vector<size_t> component;
+        for (size_t v = 0; v < n; v++) {
+            if (visited[v]) component.push_back(v);
+        }
+        uniform_int_distribution<size_t> member(0, component.size() - 1);
+        vector<pair<size_t, size_t>> queries;
+        for (size_t q = 0; q < 16; q++) queries.push_back(make_pair(component[member(rng)], component[member(rng)]));
+        const PathOptions dijkstra(PathBackend::Dijkstra);
+        vector<long long> baseline;
+        double before[2] = {0, 0};
+        const VertexOrder orders[] = {VertexOrder::DegreeSort, VertexOrder::BFS, VertexOrder::ReverseCuthillMcKee};
+        for (int k = -1; k < 3; k++) {
+            Graph g = loaded;
+            chrono::steady_clock::time_point start = chrono::steady_clock::now();
+            if (k >= 0) g.reorder(orders[k]);
+            double reorder = millisSince(start);
+            ariel::GraphView internal = g.view();
+            internal.setOrder(nullptr, nullptr);
+            double ms[2];
+            visited.assign(n, false);
+            start = chrono::steady_clock::now();
+            Algorithms::DFS(g.internalId(hub), visited, internal);
+            ms[0] = millisSince(start);
+            vector<long long> answers(1, static_cast<long long>(count(visited.begin(), visited.end(), true)));
+            vector<string> paths;
+            start = chrono::steady_clock::now();
+            for (size_t q = 0; q < queries.size(); q++) paths.push_back(Algorithms::shortestPath(g, queries[q].first, queries[q].second, dijkstra));
+            ms[1] = millisSince(start);
+            for (size_t q = 0; q < paths.size(); q++) answers.push_back(pathWeight(g, paths[q]));
+            if (k < 0) {
+                baseline = answers;
+                before[0] = ms[0];
+                before[1] = ms[1];
+            }
+            cout << left << setw(20) << (familyName(family) + " " + to_string(n)) << setw(10) << (k < 0 ? "loaded" : ariel::orderName(orders[k]))
+                 << fixed << setprecision(1) << setw(12) << reorder;
+            for (int m = 0; m < 2; m++) {
+                cout << setprecision(1) << setw(10) << ms[m] << "x" << setprecision(2) << setw(8) << before[m] / ms[m];
+            }
+            cout << (answers == baseline ? "" : "MISMATCH") << endl;
+        }
+    }
+
+    // The same graph with int weights and after narrowWeights (weights 1..100, so
+    // UInt8): adjacency bytes, a DFS from vertex 0 and 8 Dijkstra queries.
+    void benchWeightWidths(GraphFamily family, size_t requested, Storage mode) {
+        const size_t n = ariel::familyVertices(family, requested);
+        Graph wide;
+        if (mode == Storage::Dense) {
+            vector<vector<int>> matrix(n, vector<int>(n, 0));
+            ariel::generateGraph(family, n, 42, [&](size_t u, size_t v, int w) { matrix[u][v] = matrix[v][u] = w; });
+            wide.loadGraph(matrix);
+        } else {
+            const string path = "bench_widths.txt";
+            FILE* file = fopen(path.c_str(), "w");
+            ariel::generateGraph(family, n, 42, [&](size_t u, size_t v, int w) { fprintf(file, "%zu %zu %d\n%zu %zu %d\n", u, v, w, v, u, w); });
+            fprintf(file, "%zu %zu 0\n", n - 1, n - 1);
+            fclose(file);
+            wide.loadEdgeList(path);
+            remove(path.c_str());
+        }
+        mt19937 rng(29);
+        uniform_int_distribution<size_t> vertex(0, n - 1);
+        vector<pair<size_t, size_t>> queries;
+        for (size_t q = 0; q < 8; q++) queries.push_back(make_pair(vertex(rng), vertex(rng)));
+        const PathOptions dijkstra(PathBackend::Dijkstra);
+        Graph narrow = wide;
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        narrow.narrowWeights();
+        double narrowing = millisSince(start);
+        vector<string> baseline;
+        double before[2] = {0, 0};
+        for (int k = 0; k < 2; k++) {
+            const Graph& g = k == 0 ? wide : narrow;
+            double ms[2];
+            vector<bool> visited(n, false);
+            start = chrono::steady_clock::now();
+            Algorithms::DFS(0, visited, g);
+            ms[0] = millisSince(start);
+            vector<string> paths;
+            start = chrono::steady_clock::now();
+            for (size_t q = 0; q < queries.size(); q++) paths.push_back(Algorithms::shortestPath(g, queries[q].first, queries[q].second, dijkstra));
+            ms[1] = millisSince(start);
+            if (k == 0) {
+                baseline = paths;
+                before[0] = ms[0];
+                before[1] = ms[1];
+            }
+            cout << left << setw(20) << (familyName(family) + " " + to_string(n)) << setw(8) << (mode == Storage::Dense ? "dense" : "sparse")
+                 << setw(8) << (k == 0 ? "int32" : "uint8") << fixed << setprecision(1) << setw(10) << (k == 0 ? 0.0 : narrowing)
+                 << setw(10) << static_cast<double>(g.getStorageBytes()) / (1 << 20);
+            for (int m = 0; m < 2; m++) {
+                cout << setprecision(1) << setw(10) << ms[m] << "x" << setprecision(2) << setw(8) << before[m] / ms[m];
+            }
+            cout << (paths == baseline ? "" : "MISMATCH") << endl;
+        }
+    }
+
+    // CSR against compressed rows of the same graph, in the generated order and
+    // after an RCM reordering (which shrinks the gaps): adjacency bytes, a DFS
+    // over the component of the highest-degree vertex, and the BFS-based
+    // isConnected / isBipartite with the result cache cleared. Best of 3 runs.
+    void benchCompressed(GraphFamily family, size_t requested, bool unitWeights) {
+        const size_t n = ariel::familyVertices(family, requested);
+        const string path = "bench_compressed.txt";
+        FILE* file = fopen(path.c_str(), "w");
+        vector<size_t> degree(n, 0);
+        ariel::generateGraph(family, n, 42, [&](size_t u, size_t v, int w) {
+            if (unitWeights) w = 1;
+            fprintf(file, "%zu %zu %d\n%zu %zu %d\n", u, v, w, v, u, w);
+            degree[u]++;
+            degree[v]++;
+        });
+        fprintf(file, "%zu %zu 0\n", n - 1, n - 1);
+        fclose(file);
+        const size_t hub = static_cast<size_t>(max_element(degree.begin(), degree.end()) - degree.begin());
+        for (int reordered = 0; reordered < 2; reordered++) {
+            double before[3] = {0, 0, 0};
+            size_t bytes = 0;
+            vector<string> baseline;
+            for (Storage mode : {Storage::Sparse, Storage::Compressed}) {
+                Graph g;
+                g.loadEdgeList(path, mode);
+                if (reordered == 1) g.reorder(VertexOrder::ReverseCuthillMcKee);
+                ariel::GraphView internal = g.view();
+                internal.setOrder(nullptr, nullptr);
+                double ms[3] = {1e300, 1e300, 1e300};
+                vector<string> answers(3);
+                vector<bool> visited;
+                for (int run = 0; run < 3; run++) {
+                    visited.assign(n, false);
+                    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+                    Algorithms::DFS(g.internalId(hub), visited, internal);
+                    ms[0] = min(ms[0], millisSince(start));
+                    answers[0] = to_string(count(visited.begin(), visited.end(), true));
+                    Algorithms::clearResultCache();
+                    start = chrono::steady_clock::now();
+                    answers[1] = to_string(Algorithms::isConnected(g));
+                    ms[1] = min(ms[1], millisSince(start));
+                    Algorithms::clearResultCache();
+                    start = chrono::steady_clock::now();
+                    answers[2] = Algorithms::isBipartite(g);
+                    ms[2] = min(ms[2], millisSince(start));
+                }
+                if (mode == Storage::Sparse) {
+                    baseline = answers;
+                    copy(ms, ms + 3, before);
+                    bytes = g.getStorageBytes();
+                }
+                cout << left << setw(20) << (familyName(family) + " " + to_string(n)) << setw(8) << (unitWeights ? "1" : "1..100")
+                     << setw(8) << (reordered == 1 ? "rcm" : "loaded") << setw(12) << (mode == Storage::Sparse ? "csr" : "compressed")
+                     << fixed << setprecision(1) << setw(9) << static_cast<double>(g.getStorageBytes()) / (1 << 20)
+                     << "x" << setprecision(2) << setw(7) << static_cast<double>(bytes) / static_cast<double>(g.getStorageBytes());
+                for (int m = 0; m < 3; m++) {
+                    cout << setprecision(1) << setw(10) << ms[m] << "x" << setprecision(2) << setw(8) << before[m] / ms[m];
+                }
+                cout << (answers == baseline ? "" : "MISMATCH") << endl;
+            }
+        }
+        remove(path.c_str());
+    }
+
+    // The old way to get a distance table: one shortestPath call per (src, dest)
+    // pair would be V^2 searches, so the baseline is the batch API with one
+    // Dijkstra per source, against allPairsShortestPaths.
+    void benchAllPairs(const string& name, const vector<vector<int>>& matrix, Storage mode) {
+        Graph g;
+        g.loadGraph(const_cast<vector<vector<int>>&>(matrix), mode);
+        size_t n = g.getNumOfVertices();
+        vector<pair<size_t, size_t>> queries;
+        for (size_t u = 0; u < n; u++) queries.push_back(make_pair(u, (u + n / 2) % n));
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        vector<ariel::PathResult> batch = Algorithms::shortestPaths(g, queries, 1);
+        double perSource = millisSince(start);
+        start = chrono::steady_clock::now();
+        DistanceTable table = Algorithms::allPairsShortestPaths(g, false, 1);
+        double apsp = millisSince(start);
+        start = chrono::steady_clock::now();
+        DistanceTable withHops = Algorithms::allPairsShortestPaths(g, true, 1);
+        double apspHops = millisSince(start);
+        bool same = true;
+        for (size_t k = 0; k < queries.size(); k++) {
+            same = same && batch[k].distance == (table.reachable(k, queries[k].second) ? table.distance(k, queries[k].second) : -1);
+        }
+        cout << left << setw(24) << name << fixed << setprecision(1) << setw(16) << perSource << setw(16) << apsp << setw(16) << apspHops
+             << (same && withHops.distances == table.distances ? "" : " MISMATCH") << endl;
+    }
+
+    // Road-like test graph: a side x side grid with random weights 1..100,
+    // written as an edge list and loaded as CSR.
+    void loadGrid(Graph& g, size_t side, unsigned seed) {
+        const string path = "bench_grid.txt";
+        mt19937 rng(seed);
+        uniform_int_distribution<int> weight(1, 100);
+        FILE* file = fopen(path.c_str(), "w");
+        for (size_t r = 0; r < side; r++) {
+            for (size_t c = 0; c < side; c++) {
+                size_t v = r * side + c;
+                if (c + 1 < side) {
+                    int w = weight(rng);
+                    fprintf(file, "%zu %zu %d\n%zu %zu %d\n", v, v + 1, w, v + 1, v, w);
+                }
+                if (r + 1 < side) {
+                    int w = weight(rng);
+                    fprintf(file, "%zu %zu %d\n%zu %zu %d\n", v, v + side, w, v + side, v, w);
+                }
+            }
+        }
+        fclose(file);
+        g.loadEdgeList(path);
+        remove(path.c_str());
+    }
+
+    void benchPointToPoint(size_t side, size_t landmarks, size_t queries) {
+        Graph g;
+        loadGrid(g, side, 8);
+        size_t n = g.getNumOfVertices();
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        PathSearch search(g);
+        double build = millisSince(start);
+        start = chrono::steady_clock::now();
+        search.selectLandmarks(landmarks);
+        double select = millisSince(start);
+        cout << "grid " << side << "x" << side << ": PathSearch copy " << fixed << setprecision(1) << build
+             << " ms, " << landmarks << " landmarks " << select << " ms" << endl;
+        cout << left << setw(16) << "mode" << setw(16) << "us per query" << setw(16) << "settled/query" << endl;
+
+        mt19937 rng(9);
+        uniform_int_distribution<size_t> vertex(0, n - 1);
+        vector<pair<size_t, size_t>> pairs;
+        for (size_t q = 0; q < queries; q++) pairs.push_back(make_pair(vertex(rng), vertex(rng)));
+        vector<int> expected;
+        start = chrono::steady_clock::now();
+        for (size_t q = 0; q < queries; q++) Algorithms::shortestPath(g, pairs[q].first, pairs[q].second);
+        cout << left << setw(16) << "shortestPath" << setw(16) << millisSince(start) * 1000.0 / static_cast<double>(queries) << "-" << endl;
+        for (int mode = 0; mode < 3; mode++) {
+            size_t settled = 0;
+            bool same = true;
+            start = chrono::steady_clock::now();
+            for (size_t q = 0; q < queries; q++) {
+                PathResult r = mode == 0 ? search.dijkstra(pairs[q].first, pairs[q].second)
+                             : mode == 1 ? search.bidirectional(pairs[q].first, pairs[q].second)
+                                         : search.alt(pairs[q].first, pairs[q].second);
+                settled += search.lastSettled();
+                if (mode == 0) expected.push_back(r.distance);
+                same = same && r.distance == expected[q];
+            }
+            double micros = millisSince(start) * 1000.0 / static_cast<double>(queries);
+            cout << left << setw(16) << (mode == 0 ? "dijkstra" : mode == 1 ? "bidirectional" : "ALT") << setw(16) << micros
+                 << setw(16) << settled / queries << (same ? "" : " MISMATCH") << endl;
+        }
+    }
+
+    void benchContraction(size_t side, size_t queries) {
+        Graph g;
+        loadGrid(g, side, 8);
+        size_t n = g.getNumOfVertices();
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        ContractionHierarchy ch(g);
+        double build = millisSince(start);
+        cout << "grid " << side << "x" << side << ": build " << fixed << setprecision(1) << build << " ms, "
+             << ch.getShortcutCount() << " shortcuts" << endl;
+
+        mt19937 rng(10);
+        uniform_int_distribution<size_t> vertex(0, n - 1);
+        vector<pair<size_t, size_t>> pairs;
+        for (size_t q = 0; q < queries; q++) pairs.push_back(make_pair(vertex(rng), vertex(rng)));
+        size_t baselineQueries = min(queries, size_t(100));
+        start = chrono::steady_clock::now();
+        for (size_t q = 0; q < baselineQueries; q++) Algorithms::shortestPath(g, pairs[q].first, pairs[q].second);
+        double baseline = millisSince(start) * 1000.0 / static_cast<double>(baselineQueries);
+
+        size_t settled = 0;
+        start = chrono::steady_clock::now();
+        for (size_t q = 0; q < queries; q++) {
+            ch.distance(pairs[q].first, pairs[q].second);
+            settled += ch.lastSettled();
+        }
+        double distance = millisSince(start) * 1000.0 / static_cast<double>(queries);
+        size_t pathLength = 0;
+        start = chrono::steady_clock::now();
+        for (size_t q = 0; q < queries; q++) pathLength += ch.query(pairs[q].first, pairs[q].second).path.size();
+        double query = millisSince(start) * 1000.0 / static_cast<double>(queries);
+        cout << left << setw(24) << "mode" << setw(16) << "us per query" << endl;
+        cout << left << setw(24) << "shortestPath" << setw(16) << baseline << endl;
+        cout << left << setw(24) << "CH distance" << setw(16) << distance << settled / queries << " settled" << endl;
+        cout << left << setw(24) << "CH query (with path)" << setw(16) << query << pathLength / queries << " vertices" << endl;
+        cout << "build pays off after " << static_cast<size_t>(build * 1000.0 / (baseline - distance)) << " queries" << endl;
+    }
+
+    // One full single-source search (a query to an unreachable vertex settles
+    // everything reachable) on Dijkstra and on delta-stepping.
+    void benchDeltaStepping(size_t n, size_t degree) {
+        const string path = "bench_delta.txt";
+        writeEdgeList(path, n, degree, 12);
+        Graph g;
+        g.loadEdgeList(path);
+        remove(path.c_str());
+        vector<pair<size_t, size_t>> query(1, make_pair(size_t(0), size_t(1)));
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        int expected = Algorithms::shortestPaths(g, query, PathOptions(PathBackend::Dijkstra, 0, 1))[0].distance;
+        double dijkstra = millisSince(start);
+        cout << "V=" << n << " random deg~" << 2 * degree << ", hardware threads " << thread::hardware_concurrency() << endl;
+        cout << left << setw(12) << "threads" << setw(12) << "delta" << setw(12) << "ms" << setw(12) << "vs Dijkstra" << endl;
+        cout << left << setw(12) << "Dijkstra" << setw(12) << "-" << fixed << setprecision(1) << setw(12) << dijkstra << endl;
+        for (int delta : {0, 10, 200}) {
+            for (size_t threads : {size_t(1), size_t(2), size_t(4), size_t(8), size_t(16), size_t(32)}) {
+                if (delta != 0 && threads != 1) continue;
+                start = chrono::steady_clock::now();
+                int distance = Algorithms::shortestPaths(g, query, PathOptions(PathBackend::DeltaStepping, delta, threads))[0].distance;
+                double ms = millisSince(start);
+                cout << left << setw(12) << threads << setw(12) << (delta == 0 ? string("mean") : to_string(delta)) << setw(12) << ms
+                     << setprecision(2) << dijkstra / ms << "x" << setprecision(1) << (distance == expected ? "" : " MISMATCH") << endl;
+            }
+        }
+    }
+
+    // Random graph whose weights w(u, v) + p(u) - p(v) include credits (negative
+    // edges) but no negative cycle; Bellman-Ford against Dijkstra on the plain w.
+    void benchBellmanFord(size_t n, size_t degree) {
+        mt19937 rng(13);
+        uniform_int_distribution<size_t> vertex(0, n - 1);
+        uniform_int_distribution<int> weight(1, 100), potential(0, 60);
+        vector<int> p(n);
+        for (size_t v = 0; v < n; v++) p[v] = potential(rng);
+        const string plainPath = "bench_plain.txt", creditPath = "bench_credit.txt";
+        FILE* plain = fopen(plainPath.c_str(), "w");
+        FILE* credit = fopen(creditPath.c_str(), "w");
+        for (size_t u = 0; u < n; u++) {
+            for (size_t k = 0; k < degree; k++) {
+                size_t v = vertex(rng);
+                int w = weight(rng);
+                if (v == u || w + p[u] - p[v] == 0) continue;
+                fprintf(plain, "%zu %zu %d\n", u, v, w);
+                fprintf(credit, "%zu %zu %d\n", u, v, w + p[u] - p[v]);
+            }
+        }
+        fclose(plain);
+        fclose(credit);
+        Graph positive, negative;
+        positive.loadEdgeList(plainPath);
+        negative.loadEdgeList(creditPath);
+        remove(plainPath.c_str());
+        remove(creditPath.c_str());
+
+        vector<pair<size_t, size_t>> query(1, make_pair(size_t(0), size_t(1)));
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        int expected = Algorithms::shortestPaths(positive, query, PathOptions(PathBackend::Dijkstra, 0, 1))[0].distance;
+        double dijkstra = millisSince(start);
+        cout << "V=" << n << " directed deg~" << degree << ", negative weights " << (negative.hasNegativeWeights() ? "yes" : "no") << endl;
+        cout << left << setw(24) << "Dijkstra, plain weights" << fixed << setprecision(1) << dijkstra << " ms" << endl;
+        for (size_t threads : {size_t(1), size_t(2), size_t(4), size_t(8)}) {
+            start = chrono::steady_clock::now();
+            int distance = Algorithms::shortestPaths(negative, query, PathOptions(PathBackend::Auto, 0, threads))[0].distance;
+            double ms = millisSince(start);
+            // The potentials shift every 0 -> 1 path by p[0] - p[1].
+            bool same = (expected == -1 && distance == -1) || distance == expected + p[0] - p[1];
+            cout << left << setw(24) << ("Bellman-Ford, " + to_string(threads) + " thr") << ms << " ms" << (same ? "" : " MISMATCH") << endl;
+        }
+        start = chrono::steady_clock::now();
+        bool none = Algorithms::negativeCycle(negative).empty();
+        cout << left << setw(24) << "negativeCycle" << millisSince(start) << " ms" << (none ? "" : " MISMATCH") << endl;
+        negative.setWeight(0, 1, -1000000);
+        negative.setWeight(1, 0, 1);
+        start = chrono::steady_clock::now();
+        size_t length = Algorithms::negativeCycle(negative).size();
+        cout << left << setw(24) << "negativeCycle, planted" << millisSince(start) << " ms, cycle of " << (length > 0 ? length - 1 : 0) << " edges" << endl;
+    }
+}
+
+int main()
+{
+    cout << "shortestPath, ms per query" << endl;
+    cout << left << setw(24) << "graph" << setw(16) << "linear scan" << setw(16) << "heap/dense" << setw(16) << "heap/CSR" << endl;
+
+    vector<vector<int>> sparse = randomSparseMatrix(4000, 4, 1);
+    benchShortestPath("sparse V=4000 deg~8", sparse, 20);
+
+    vector<vector<int>> dense = randomDenseMatrix(2000, 2);
+    benchShortestPath("dense V=2000", dense, 20);
+
+    cout << endl << "shortestPaths batch, 200 sources x 20 queries, sparse V=4000" << endl;
+    benchBatch(sparse, 200, 20);
+
+    cout << endl << "isConnected + isBipartite, ms per call" << endl;
+    benchUnweighted("sparse V=4000 deg~8", sparse, 5);
+    benchUnweighted("dense V=2000", dense, 5);
+
+    cout << endl << "parallel isConnected + isBipartite on CSR" << endl;
+    benchParallelBFS("sparse V=4000 deg~8", sparse, 5);
+    benchParallelBFS("dense V=2000", dense, 5);
+
+    cout << endl << "single-source search, delta-stepping scaling" << endl;
+    benchDeltaStepping(500000, 4);
+
+    cout << endl << "single-source search with negative weights" << endl;
+    benchBellmanFord(200000, 4);
+
+    cout << endl << "point-to-point search" << endl;
+    benchPointToPoint(300, 16, 200);
+
+    cout << endl << "contraction hierarchies" << endl;
+    benchContraction(300, 10000);
+
+    cout << endl << "all pairs shortest paths, ms, 1 thread" << endl;
+    cout << left << setw(24) << "graph" << setw(16) << "V x Dijkstra" << setw(16) << "APSP" << setw(16) << "APSP + hops" << endl;
+    benchAllPairs("sparse V=4000 deg~8", sparse, Storage::Sparse);
+    benchAllPairs("dense V=2000", dense, Storage::Dense);
+
+    cout << endl << "loadGraph classification, ms" << endl;
+    cout << left << setw(8) << "V" << setw(12) << "matrix" << setw(14) << "two-pass" << setw(14) << "blocked" << setw(14) << "loadGraph" << endl;
+    benchLoad(10000);
+    benchLoad(20000);
+
+    cout << endl << "binary graph file, ms" << endl;
+    cout << left << setw(8) << "V" << setw(12) << "layout" << setw(14) << "loadGraph" << setw(14) << "saveGraph" << setw(14) << "openGraph" << setw(14) << "isConnected" << endl;
+    benchFile(10000, Storage::Dense);
+    benchFile(20000, Storage::Dense);
+    benchFile(20000, Storage::Sparse);
+
+    cout << endl << "1000 cell updates, ms" << endl;
+    cout << left << setw(8) << "V" << setw(12) << "storage" << setw(16) << "applyUpdates" << setw(16) << "setWeight x1000" << setw(16) << "reload" << endl;
+    benchUpdates(20000, Storage::Dense);
+    benchUpdates(20000, Storage::Sparse);
+
+    cout << endl << "connectivity polled after each batch of 500 edges, ms" << endl;
+    cout << left << setw(8) << "V" << setw(12) << "batches" << setw(16) << "build" << setw(16) << "isConnected" << setw(16) << "addEdges" << endl;
+    benchComponents(100000, 40, 500);
+    benchComponents(1000000, 40, 500);
+
+    cout << endl << "strongly connected components, ms" << endl;
+    cout << left << setw(10) << "V" << setw(8) << "deg" << setw(14) << "method" << setw(10) << "ms" << endl;
+    benchStrongComponents(1000000, 2);
+    benchStrongComponents(1000000, 4);
+
+    cout << endl << "isConnected + isContainsCycle + isBipartite on an unchanged graph, ms per round" << endl;
+    cout << left << setw(10) << "V" << setw(14) << "no cache" << setw(14) << "cache" << setw(16) << "after update" << endl;
+    benchResultCache(100000, 20);
+    benchResultCache(1000000, 5);
+
+    cout << endl << "edge list text, ms" << endl;
+    cout << left << setw(10) << "V" << setw(12) << "lines" << setw(16) << "ifstream only" << setw(16) << "loadEdgeList" << setw(12) << "M lines/s" << endl;
+    benchEdgeList(100000, 4);
+    benchEdgeList(1000000, 4);
+
+    cout << endl << "vertex reordering of shuffled ids, ms (speedup over the loaded order)" << endl;
+    cout << left << setw(20) << "graph" << setw(10) << "order" << setw(12) << "reorder" << setw(19) << "DFS" << setw(19) << "16 x Dijkstra" << endl;
+    benchReordering(GraphFamily::ErdosRenyi, 1000000);
+    benchReordering(GraphFamily::RMat, 1000000);
+    benchReordering(GraphFamily::Grid, 1000000);
+
+    cout << endl << "int32 against narrowed weights, ms (speedup over int32)" << endl;
+    cout << left << setw(20) << "graph" << setw(8) << "storage" << setw(8) << "weights" << setw(10) << "narrow" << setw(10) << "MB"
+         << setw(19) << "DFS" << setw(19) << "8 x Dijkstra" << endl;
+    benchWeightWidths(GraphFamily::ErdosRenyi, 8000, Storage::Dense);
+    benchWeightWidths(GraphFamily::ErdosRenyi, 1000000, Storage::Sparse);
+    benchWeightWidths(GraphFamily::RMat, 1000000, Storage::Sparse);
+
+    cout << endl << "CSR against compressed rows, ms (memory ratio and speedup against CSR)" << endl;
+    cout << left << setw(20) << "graph" << setw(8) << "weights" << setw(8) << "order" << setw(12) << "storage" << setw(17) << "MB"
+         << setw(19) << "DFS" << setw(19) << "isConnected" << setw(19) << "isBipartite" << endl;
+    benchCompressed(GraphFamily::ErdosRenyi, 1000000, false);
+    benchCompressed(GraphFamily::RMat, 1000000, false);
+    benchCompressed(GraphFamily::RMat, 1000000, true);
+    benchCompressed(GraphFamily::Grid, 1000000, false);
+    return 0;
+}
@@ -0,0 +1,246 @@
+/*
+ * Benchmark suite: every Algorithms function and the graph loaders on the
+ * synthetic families of Generators.hpp, one JSON object per line on stdout.
+ * Build and run with: make bench-suite
+ *
+ *   ./bench-suite [--max-vertices N] [--budget-ms MS] [--min-runs K] [--family NAME]...
+ *
+ * Each measurement repeats until it has run at least --min-runs times and for
+ * --budget-ms milliseconds (at most 1000 runs) and reports the median and the
+ * nearest-rank 99th percentile. edges_per_sec is the stored edge count over
+ * the median, so it compares the same function across builds, not functions
+ * with each other. peak_rss_kb is the process high-water mark after the
+ * measurement (getrusage), so it only grows along the run.
+ *
+ * Built with INSTRUMENT=1, the run also prints the per-function counters of
+ * Instrumentation.hpp to stderr and writes bench_trace.json.
+ */
+
+#include "Graph.hpp"
+#include "Algorithms.hpp"
+#include "Generators.hpp"
+#include "Instrumentation.hpp"
+using ariel::Algorithms;
+using ariel::Graph;
+using ariel::Storage;
+using ariel::GraphView;
+using ariel::GraphFamily;
+using ariel::Instrumentation;
+using ariel::PathBackend;
+using ariel::PathOptions;
+
+#include <sys/resource.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+using namespace std;
+
+namespace {
+    const size_t SIZES[] = {1000, 10000, 100000, 1000000};
+    // Dense storage, and loadGraph from a matrix, up to this many vertices.
+    const size_t DENSE_LIMIT = 10000;
+    // allPairsShortestPaths keeps a V x V table.
+    const size_t ALL_PAIRS_LIMIT = 2000;
+    const size_t MAX_RUNS = 1000;
+
+    struct Settings {
+        size_t maxVertices;
+        double budgetMs;
+        size_t minRuns;
+        vector<GraphFamily> families;
+    };
+
+    long peakRssKb() {
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        return usage.ru_maxrss;
+    }
+
+    double millisSince(chrono::steady_clock::time_point start) {
+        return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    }
+
+    // Times run() until the budget is spent and prints one record.
+    void measure(const Settings& settings, const string& family, const string& storage, size_t vertices, size_t edges,
+                 const string& name, const function<void()>& run) {
+        vector<double> samples;
+        double total = 0;
+        while (samples.size() < MAX_RUNS && (samples.size() < settings.minRuns || total < settings.budgetMs)) {
+            chrono::steady_clock::time_point start = chrono::steady_clock::now();
+            run();
+            samples.push_back(millisSince(start));
+            total += samples.back();
+        }
+        sort(samples.begin(), samples.end());
+        double median = samples[samples.size() / 2];
+        double p99 = samples[(samples.size() * 99 + 99) / 100 - 1];
+        double edgesPerSec = median > 0 ? static_cast<double>(edges) / (median / 1000.0) : 0;
+        printf("{\"family\":\"%s\",\"storage\":\"%s\",\"vertices\":%zu,\"edges\":%zu,\"function\":\"%s\",\"runs\":%zu,"
+               "\"median_ms\":%.6f,\"p99_ms\":%.6f,\"edges_per_sec\":%.0f,\"peak_rss_kb\":%ld}\n",
+               family.c_str(), storage.c_str(), vertices, edges, name.c_str(), samples.size(), median, p99, edgesPerSec, peakRssKb());
+        fflush(stdout);
+    }
+
+    // Every Algorithms function on one loaded graph. Queries cycle through a
+    // fixed list of random pairs so each run asks something different.
+    void measureAlgorithms(const Settings& settings, const string& family, const Graph& graph) {
+        const GraphView g = graph.view();
+        const size_t n = g.size();
+        const size_t edges = static_cast<size_t>(graph.getNumOfEdges());
+        const string storage = g.getStorage() == Storage::Dense ? "dense" : "sparse";
+        mt19937 rng(21);
+        uniform_int_distribution<size_t> vertex(0, n - 1);
+        vector<pair<size_t, size_t>> pairs;
+        for (size_t k = 0; k < 64; k++) pairs.push_back(make_pair(vertex(rng), vertex(rng)));
+        const vector<pair<size_t, size_t>> batch(pairs.begin(), pairs.begin() + 16);
+        size_t next = 0;
+        vector<int> distances(n);
+        for (size_t v = 0; v < n; v++) distances[v] = static_cast<int>(vertex(rng));
+        vector<bool> visited;
+
+        typedef pair<string, function<void()>> Case;
+        vector<Case> cases;
+        cases.push_back(Case("isConnected", [&]() { Algorithms::isConnected(g); }));
+        cases.push_back(Case("isConnected(threads)", [&]() { Algorithms::isConnected(g, 0); }));
+        cases.push_back(Case("isBipartite", [&]() { Algorithms::isBipartite(g); }));
+        cases.push_back(Case("isBipartite(threads)", [&]() { Algorithms::isBipartite(g, 0); }));
+        cases.push_back(Case("isContainsCycle", [&]() { Algorithms::isContainsCycle(g); }));
+        cases.push_back(Case("findCycle", [&]() { Algorithms::findCycle(g); }));
+        cases.push_back(Case("negativeCycle", [&]() { Algorithms::negativeCycle(g); }));
+        cases.push_back(Case("shortestPath", [&]() {
+            pair<size_t, size_t> q = pairs[next++ % pairs.size()];
+            Algorithms::shortestPath(g, q.first, q.second);
+        }));
+        cases.push_back(Case("shortestPath(DeltaStepping)", [&]() {
+            pair<size_t, size_t> q = pairs[next++ % pairs.size()];
+            Algorithms::shortestPath(g, q.first, q.second, PathOptions(PathBackend::DeltaStepping));
+        }));
+        cases.push_back(Case("shortestPath(BellmanFord)", [&]() {
+            pair<size_t, size_t> q = pairs[next++ % pairs.size()];
+            Algorithms::shortestPath(g, q.first, q.second, PathOptions(PathBackend::BellmanFord));
+        }));
+        cases.push_back(Case("shortestPaths(16 queries)", [&]() { Algorithms::shortestPaths(g, batch); }));
+        if (n <= ALL_PAIRS_LIMIT) {
+            cases.push_back(Case("allPairsShortestPaths", [&]() { Algorithms::allPairsShortestPaths(g); }));
+        }
+        cases.push_back(Case("DFS", [&]() {
+            visited.assign(n, false);
+            Algorithms::DFS(0, visited, g);
+        }));
+        cases.push_back(Case("dfs", [&]() {
+            visited.assign(n, false);
+            vector<bool> recStack(n, false);
+            Algorithms::dfs(0, visited, recStack, g, -1, g.isDirected());
+        }));
+        cases.push_back(Case("minDistance", [&]() {
+            visited.assign(n, false);
+            Algorithms::minDistance(distances, visited);
+        }));
+        for (size_t k = 0; k < cases.size(); k++) measure(settings, family, storage, n, edges, cases[k].first, cases[k].second);
+    }
+
+    void runFamily(const Settings& settings, GraphFamily family, size_t requested) {
+        const string name = familyName(family);
+        const size_t n = ariel::familyVertices(family, requested);
+        const string path = "bench_suite_" + name + ".txt";
+        FILE* file = fopen(path.c_str(), "w");
+        if (file == nullptr) {
+            fprintf(stderr, "Cannot write %s\n", path.c_str());
+            exit(1);
+        }
+        vector<vector<int>> matrix;
+        if (n <= DENSE_LIMIT) matrix.assign(n, vector<int>(n, 0));
+        ariel::generateGraph(family, n, 42, [&](size_t u, size_t v, int w) {
+            fprintf(file, "%zu %zu %d\n%zu %zu %d\n", u, v, w, v, u, w);
+            if (!matrix.empty()) matrix[u][v] = matrix[v][u] = w;
+        });
+        // Weight 0 stores nothing but fixes the vertex count at n when the last vertex is isolated.
+        fprintf(file, "%zu %zu 0\n", n - 1, n - 1);
+        fclose(file);
+
+        Graph sparse;
+        sparse.loadEdgeList(path);
+        const size_t edges = static_cast<size_t>(sparse.getNumOfEdges());
+        measure(settings, name, "sparse", n, edges, "loadEdgeList", [&]() {
+            Graph g;
+            g.loadEdgeList(path);
+        });
+        remove(path.c_str());
+        if (!matrix.empty()) {
+            measure(settings, name, "dense", n, edges, "loadGraph", [&]() {
+                Graph g;
+                g.loadGraph(matrix);
+            });
+            measure(settings, name, "sparse", n, edges, "loadGraph", [&]() {
+                Graph g;
+                g.loadGraph(matrix, Storage::Sparse);
+            });
+        }
+        measureAlgorithms(settings, name, sparse);
+        if (!matrix.empty()) {
+            Graph dense;
+            dense.loadGraph(matrix);
+            vector<vector<int>>().swap(matrix);
+            measureAlgorithms(settings, name, dense);
+        }
+    }
+
+    bool parseFamily(const string& name, GraphFamily& family) {
+        const GraphFamily all[] = {GraphFamily::ErdosRenyi, GraphFamily::RMat, GraphFamily::Grid, GraphFamily::Chain, GraphFamily::CompleteBipartite};
+        for (size_t k = 0; k < 5; k++) {
+            if (familyName(all[k]) == name) {
+                family = all[k];
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void usage() {
+        fprintf(stderr, "usage: bench-suite [--max-vertices N] [--budget-ms MS] [--min-runs K] [--family "
+                        "erdos-renyi|rmat|grid|chain|complete-bipartite]...\n");
+        exit(2);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Settings settings = {1000000, 300.0, 5, vector<GraphFamily>()};
+    for (int i = 1; i < argc; i++) {
+        string option = argv[i];
+        if (i + 1 >= argc) usage();
+        string value = argv[++i];
+        if (option == "--max-vertices") {
+            settings.maxVertices = strtoul(value.c_str(), nullptr, 10);
+        } else if (option == "--budget-ms") {
+            settings.budgetMs = atof(value.c_str());
+        } else if (option == "--min-runs") {
+            settings.minRuns = max(size_t(1), static_cast<size_t>(strtoul(value.c_str(), nullptr, 10)));
+        } else if (option == "--family") {
+            GraphFamily family;
+            if (!parseFamily(value, family)) usage();
+            settings.families.push_back(family);
+        } else {
+            usage();
+        }
+    }
+    if (settings.families.empty()) {
+        settings.families = {GraphFamily::ErdosRenyi, GraphFamily::RMat, GraphFamily::Grid, GraphFamily::Chain, GraphFamily::CompleteBipartite};
+    }
+    for (size_t s = 0; s < sizeof(SIZES) / sizeof(SIZES[0]); s++) {
+        if (SIZES[s] > settings.maxVertices) break;
+        for (size_t f = 0; f < settings.families.size(); f++) runFamily(settings, settings.families[f], SIZES[s]);
+    }
+    if (Instrumentation::enabled()) {
+        Instrumentation::printSummary(cerr);
+        Instrumentation::writeChromeTrace("bench_trace.json");
+    }
+    return 0;
+}
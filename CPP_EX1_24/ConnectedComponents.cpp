@@ -0,0 +1,91 @@
+#include "ConnectedComponents.hpp"
+#include <limits>
+#include <stdexcept>
+
+using namespace std;
+
+namespace ariel {
+namespace {
+    // Unites in loaded ids, so a reordered graph is queried in the ids the caller knows.
+    template <typename Adjacency>
+    void uniteEdges(const GraphView& g, const Adjacency& adj, DisjointSet& sets) {
+        for (size_t u = 0; u < adj.size(); u++) {
+            for (typename Adjacency::Cursor it = adj.neighbors(u); it.valid(); it.next()) {
+                if (it.weight() > 0) sets.unite(g.originalId(u), g.originalId(it.target()));
+            }
+        }
+    }
+}
+
+    ConnectedComponents::ConnectedComponents(const GraphView& g) : sets(g.size()) {
+        switch (g.getStorage()) {
+            case Storage::Sparse: uniteEdges(g, g.sparseView(), sets); break;
+            case Storage::Compressed: uniteEdges(g, g.compressedView(), sets); break;
+            case Storage::Bitset: uniteEdges(g, g.bitsetView(), sets); break;
+            default: uniteEdges(g, g.denseView(), sets);
+        }
+    }
+
+    void ConnectedComponents::checkVertex(size_t v) const {
+        if (v >= sets.size()) {
+            throw invalid_argument("Invalid vertex: The vertex is not in the graph.");
+        }
+    }
+
+    size_t ConnectedComponents::component(size_t v) {
+        checkVertex(v);
+        return sets.find(v);
+    }
+
+    bool ConnectedComponents::connected(size_t u, size_t v) {
+        checkVertex(u);
+        checkVertex(v);
+        return sets.same(u, v);
+    }
+
+    size_t ConnectedComponents::componentSize(size_t v) {
+        checkVertex(v);
+        return sets.setSize(v);
+    }
+
+    bool ConnectedComponents::addEdge(size_t from, size_t to) {
+        checkVertex(from);
+        checkVertex(to);
+        return sets.unite(from, to);
+    }
+
+    size_t ConnectedComponents::addEdges(const vector<EdgeEntry>& edges) {
+        // Checked up front so a rejected batch leaves the components unchanged.
+        for (size_t k = 0; k < edges.size(); k++) {
+            checkVertex(edges[k].from);
+            checkVertex(edges[k].to);
+            if (edges[k].weight <= 0) {
+                throw invalid_argument("Invalid edge: ConnectedComponents only takes insertions; rebuild it after a removal.");
+            }
+        }
+        size_t merges = 0;
+        for (size_t k = 0; k < edges.size(); k++) {
+            merges += static_cast<size_t>(sets.unite(edges[k].from, edges[k].to));
+        }
+        return merges;
+    }
+
+    vector<size_t> ConnectedComponents::labels() {
+        const size_t none = numeric_limits<size_t>::max();
+        vector<size_t> labelOfRoot(sets.size(), none), result(sets.size());
+        size_t next = 0;
+        for (size_t v = 0; v < sets.size(); v++) {
+            size_t root = sets.find(v);
+            if (labelOfRoot[root] == none) labelOfRoot[root] = next++;
+            result[v] = labelOfRoot[root];
+        }
+        return result;
+    }
+
+    vector<size_t> ConnectedComponents::componentSizes() {
+        vector<size_t> label = labels();
+        vector<size_t> result(sets.setCount(), 0);
+        for (size_t v = 0; v < label.size(); v++) result[label[v]]++;
+        return result;
+    }
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "DisjointSet.hpp"
+#include "EdgeList.hpp"
+#include "GraphView.hpp"
+#include <vector>
+using namespace std;
+
+namespace ariel {
+    // Connected components kept in a disjoint set. The constructor unites the
+    // ends of every positive-weight edge once (the edges the traversals follow),
+    // after which inserting an edge and every query cost near-constant time, so
+    // connectivity can be polled after each batch of updates without a traversal.
+    //
+    // Edges count in both directions: on a directed graph these are the weakly
+    // connected components. A disjoint set cannot split, so removing an edge
+    // (weight <= 0 in a batch) is rejected; build a new object after removals.
+    class ConnectedComponents {
+        private:
+            DisjointSet sets;
+
+            void checkVertex(size_t v) const;
+
+        public:
+            explicit ConnectedComponents(const GraphView& g);
+
+            size_t size() const { return sets.size(); }
+            size_t componentCount() const { return sets.setCount(); }
+            bool isConnected() const { return sets.setCount() == 1; }
+            // Representative vertex of v's component; it changes as components merge.
+            size_t component(size_t v);
+            bool connected(size_t u, size_t v);
+            size_t componentSize(size_t v);
+
+            // Returns true when the edge merged two components.
+            bool addEdge(size_t from, size_t to);
+            // Inserts the entries of a Graph::applyUpdates batch; returns how many
+            // merges happened. Throws invalid_argument on an entry with weight <= 0.
+            size_t addEdges(const vector<EdgeEntry>& edges);
+
+            // labels[v] in [0, componentCount()), numbered by the smallest vertex of each component.
+            vector<size_t> labels();
+            // sizes[label] for the labels above.
+            vector<size_t> componentSizes();
+    };
+}
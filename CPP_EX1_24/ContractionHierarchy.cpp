@@ -0,0 +1,335 @@
+#include "ContractionHierarchy.hpp"
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+
+using namespace std;
+
+namespace ariel {
+namespace {
+    const int INF = numeric_limits<int>::max();
+    const size_t NONE = numeric_limits<size_t>::max();
+
+    // Arcs are kept in loaded ids, so a reordered graph answers in the ids the caller knows.
+    template <typename Arc, typename Adjacency>
+    void copyArcs(const GraphView& g, const Adjacency& adj, vector<vector<Arc>>& out, vector<vector<Arc>>& in) {
+        for (size_t u = 0; u < adj.size(); u++) {
+            for (typename Adjacency::Cursor it = adj.neighbors(g.internalId(u)); it.valid(); it.next()) {
+                if (it.weight() < 0) {
+                    throw invalid_argument("Invalid graph: ContractionHierarchy needs non-negative weights.");
+                }
+                size_t v = g.originalId(it.target());
+                // A self-loop never shortens a path.
+                if (v == u) continue;
+                Arc forward = {v, it.weight(), NONE};
+                Arc backward = {u, it.weight(), NONE};
+                out[u].push_back(forward);
+                in[v].push_back(backward);
+            }
+        }
+    }
+
+    template <typename Arc>
+    void eraseArc(vector<Arc>& arcs, size_t target) {
+        for (size_t k = 0; k < arcs.size(); k++) {
+            if (arcs[k].target == target) {
+                arcs[k] = arcs.back();
+                arcs.pop_back();
+                return;
+            }
+        }
+    }
+
+    // Adds the arc, or lowers the weight of an existing one to the same target.
+    template <typename Arc>
+    void mergeArc(vector<Arc>& arcs, const Arc& arc) {
+        for (size_t k = 0; k < arcs.size(); k++) {
+            if (arcs[k].target == arc.target) {
+                if (arc.weight < arcs[k].weight) arcs[k] = arc;
+                return;
+            }
+        }
+        arcs.push_back(arc);
+    }
+
+    template <typename Arc>
+    bool byTarget(const Arc& a, const Arc& b) { return a.target < b.target; }
+
+    template <typename Arc>
+    void flatten(vector<vector<Arc>>& lists, vector<size_t>& offsets, vector<Arc>& arcs) {
+        offsets.assign(lists.size() + 1, 0);
+        for (size_t u = 0; u < lists.size(); u++) offsets[u + 1] = offsets[u] + lists[u].size();
+        arcs.reserve(offsets.back());
+        for (size_t u = 0; u < lists.size(); u++) {
+            sort(lists[u].begin(), lists[u].end(), byTarget<Arc>);
+            arcs.insert(arcs.end(), lists[u].begin(), lists[u].end());
+            vector<Arc>().swap(lists[u]);
+        }
+    }
+}
+
+    struct ContractionHierarchy::Witness {
+        vector<int> dist;
+        vector<bool> target;
+        vector<size_t> touched;
+        IndexedHeap<int> heap;
+
+        explicit Witness(size_t n) : dist(n, INF), target(n, false), heap(n) {}
+
+        // Bounded Dijkstra from src that never enters `skip`. Stops once every
+        // vertex marked in `target` is settled, the head passes maxDist or
+        // `limit` vertices are settled; the distances left in dist are upper
+        // bounds, which only costs shortcuts.
+        void run(const vector<vector<Arc>>& out, size_t src, size_t skip, size_t targets, int maxDist, size_t limit) {
+            for (size_t k = 0; k < touched.size(); k++) dist[touched[k]] = INF;
+            touched.clear();
+            heap.clear();
+            dist[src] = 0;
+            touched.push_back(src);
+            heap.push(src, 0);
+            for (size_t settled = 0; !heap.empty() && targets > 0 && settled < limit; settled++) {
+                if (heap.topKey() > maxDist) break;
+                size_t u = heap.pop();
+                if (target[u]) targets--;
+                for (size_t k = 0; k < out[u].size(); k++) {
+                    const Arc& arc = out[u][k];
+                    if (arc.target == skip) continue;
+                    int distance = dist[u] + arc.weight;
+                    if (distance < dist[arc.target]) {
+                        if (dist[arc.target] == INF) touched.push_back(arc.target);
+                        dist[arc.target] = distance;
+                        heap.push(arc.target, distance);
+                    }
+                }
+            }
+        }
+    };
+
+    ContractionHierarchy::Side::Side(size_t n) : dist(n, INF), parent(n, NONE), heap(n) {}
+
+    void ContractionHierarchy::Side::reset() {
+        for (size_t k = 0; k < touched.size(); k++) {
+            dist[touched[k]] = INF;
+            parent[touched[k]] = NONE;
+        }
+        touched.clear();
+        heap.clear();
+    }
+
+    void ContractionHierarchy::Side::reach(size_t v, int distance, size_t from) {
+        if (dist[v] == INF) touched.push_back(v);
+        dist[v] = distance;
+        parent[v] = from;
+        heap.push(v, distance);
+    }
+
+    ContractionHierarchy::ContractionHierarchy(const GraphView& g, size_t witnessLimit)
+        : n(g.size()), witnessLimit(max(witnessLimit, size_t(1))), rank(g.size(), 0), shortcutCount(0), forward(g.size()), backward(g.size()), settledCount(0) {
+        vector<vector<Arc>> out(n), in(n);
+        switch (g.getStorage()) {
+            case Storage::Sparse: copyArcs(g, g.sparseView(), out, in); break;
+            case Storage::Compressed: copyArcs(g, g.compressedView(), out, in); break;
+            case Storage::Bitset: copyArcs(g, g.bitsetView(), out, in); break;
+            default: copyArcs(g, g.denseView(), out, in);
+        }
+        contractAll(out, in);
+    }
+
+    // Adds (or, on a dry run, only counts) the shortcuts that contracting v
+    // needs. Both lists only hold arcs between vertices not yet contracted.
+    size_t ContractionHierarchy::contract(size_t v, vector<vector<Arc>>& out, vector<vector<Arc>>& in, Witness& witness, bool dryRun) {
+        size_t added = 0;
+        int longestOut = 0;
+        for (size_t k = 0; k < out[v].size(); k++) {
+            longestOut = max(longestOut, out[v][k].weight);
+            witness.target[out[v][k].target] = true;
+        }
+        for (size_t i = 0; i < in[v].size(); i++) {
+            size_t u = in[v][i].target;
+            int toV = in[v][i].weight;
+            witness.run(out, u, v, out[v].size(), toV + longestOut, witnessLimit);
+            for (size_t k = 0; k < out[v].size(); k++) {
+                size_t w = out[v][k].target;
+                int through = toV + out[v][k].weight;
+                if (w == u || witness.dist[w] <= through) continue;
+                added++;
+                if (dryRun) continue;
+                Arc shortcut = {w, through, v};
+                Arc reverse = {u, through, v};
+                mergeArc(out[u], shortcut);
+                mergeArc(in[w], reverse);
+            }
+        }
+        for (size_t k = 0; k < out[v].size(); k++) witness.target[out[v][k].target] = false;
+        return added;
+    }
+
+    // Contracts the vertices in order of edge difference (shortcuts added
+    // minus arcs removed) plus contracted neighbours, which spreads the
+    // contraction evenly. Priorities are refreshed lazily: a popped vertex is
+    // re-evaluated and put back if it is no longer the cheapest.
+    long long ContractionHierarchy::priority(size_t v, vector<vector<Arc>>& out, vector<vector<Arc>>& in, Witness& witness,
+                                             const vector<size_t>& contractedNeighbours) {
+        long long shortcuts = static_cast<long long>(contract(v, out, in, witness, true));
+        long long removed = static_cast<long long>(out[v].size() + in[v].size());
+        return 2 * (shortcuts - removed) + static_cast<long long>(contractedNeighbours[v]);
+    }
+
+    void ContractionHierarchy::contractAll(vector<vector<Arc>>& out, vector<vector<Arc>>& in) {
+        Witness witness(n);
+        vector<size_t> contractedNeighbours(n, 0);
+        vector<vector<Arc>> up(n), down(n);
+        typedef pair<long long, size_t> Entry;
+        priority_queue<Entry, vector<Entry>, greater<Entry>> queue;
+        for (size_t v = 0; v < n; v++) queue.push(Entry(priority(v, out, in, witness, contractedNeighbours), v));
+
+        vector<bool> contracted(n, false);
+        size_t order = 0;
+        while (!queue.empty()) {
+            size_t v = queue.top().second;
+            queue.pop();
+            if (contracted[v]) continue;
+            long long current = priority(v, out, in, witness, contractedNeighbours);
+            if (!queue.empty() && current > queue.top().first) {
+                queue.push(Entry(current, v));
+                continue;
+            }
+            shortcutCount += contract(v, out, in, witness, false);
+            contracted[v] = true;
+            rank[v] = order++;
+            // Every arc left at v leads to a vertex contracted later, so it
+            // belongs to the search graph as it is now.
+            for (size_t k = 0; k < out[v].size(); k++) {
+                up[v].push_back(out[v][k]);
+                eraseArc(in[out[v][k].target], v);
+                contractedNeighbours[out[v][k].target]++;
+            }
+            for (size_t k = 0; k < in[v].size(); k++) {
+                down[v].push_back(in[v][k]);
+                eraseArc(out[in[v][k].target], v);
+                contractedNeighbours[in[v][k].target]++;
+            }
+            vector<Arc>().swap(out[v]);
+            vector<Arc>().swap(in[v]);
+        }
+        flatten(up, upOffsets, upArcs);
+        flatten(down, downOffsets, downArcs);
+    }
+
+    void ContractionHierarchy::checkVertex(size_t v) const {
+        if (v >= n) {
+            throw invalid_argument("Invalid vertex: The vertex is not in the graph.");
+        }
+    }
+
+    size_t ContractionHierarchy::getRank(size_t v) const {
+        checkVertex(v);
+        return rank[v];
+    }
+
+    // The search-graph arc for the edge from -> to: stored at the less
+    // important end, in the up arcs if that is `from` and the down arcs if not.
+    const ContractionHierarchy::Arc& ContractionHierarchy::findArc(size_t from, size_t to) const {
+        bool upward = rank[from] < rank[to];
+        size_t owner = upward ? from : to;
+        const vector<size_t>& offsets = upward ? upOffsets : downOffsets;
+        const vector<Arc>& arcs = upward ? upArcs : downArcs;
+        Arc key = {upward ? to : from, 0, NONE};
+        vector<Arc>::const_iterator it = lower_bound(arcs.begin() + static_cast<ptrdiff_t>(offsets[owner]),
+                                                     arcs.begin() + static_cast<ptrdiff_t>(offsets[owner + 1]), key, byTarget<Arc>);
+        if (it == arcs.begin() + static_cast<ptrdiff_t>(offsets[owner + 1]) || it->target != key.target) {
+            throw logic_error("ContractionHierarchy: missing arc while unpacking a path.");
+        }
+        return *it;
+    }
+
+    // Stall-on-demand: u cannot be on a shortest up-down path if a more
+    // important vertex already reached by this side offers a shorter way to u.
+    // `arcs` are the arcs into u from above, seen from this side.
+    bool ContractionHierarchy::stalled(const Side& side, const vector<size_t>& offsets, const vector<Arc>& arcs, size_t u) const {
+        for (size_t e = offsets[u]; e < offsets[u + 1]; e++) {
+            int above = side.dist[arcs[e].target];
+            if (above != INF && above + arcs[e].weight < side.dist[u]) return true;
+        }
+        return false;
+    }
+
+    // Bidirectional upward Dijkstra. Each side stops once its head cannot beat
+    // the best meeting found; returns INF and meeting = NONE if dest is unreachable.
+    int ContractionHierarchy::search(size_t src, size_t dest, size_t& meeting) {
+        checkVertex(src);
+        checkVertex(dest);
+        forward.reset();
+        backward.reset();
+        settledCount = 0;
+        forward.reach(src, 0, NONE);
+        backward.reach(dest, 0, NONE);
+        int best = INF;
+        meeting = NONE;
+        while (true) {
+            bool forwardOpen = !forward.heap.empty() && forward.heap.topKey() < best;
+            bool backwardOpen = !backward.heap.empty() && backward.heap.topKey() < best;
+            if (!forwardOpen && !backwardOpen) break;
+            bool growForward = forwardOpen && (!backwardOpen || forward.heap.topKey() <= backward.heap.topKey());
+            Side& side = growForward ? forward : backward;
+            const Side& other = growForward ? backward : forward;
+            size_t u = side.heap.pop();
+            settledCount++;
+            if (other.dist[u] != INF && side.dist[u] + other.dist[u] < best) {
+                best = side.dist[u] + other.dist[u];
+                meeting = u;
+            }
+            if (growForward ? stalled(side, downOffsets, downArcs, u) : stalled(side, upOffsets, upArcs, u)) continue;
+            const vector<size_t>& offsets = growForward ? upOffsets : downOffsets;
+            const vector<Arc>& arcs = growForward ? upArcs : downArcs;
+            for (size_t e = offsets[u]; e < offsets[u + 1]; e++) {
+                int distance = side.dist[u] + arcs[e].weight;
+                if (distance < side.dist[arcs[e].target]) side.reach(arcs[e].target, distance, u);
+            }
+        }
+        return best;
+    }
+
+    // Appends the original vertices after `from` on the arc from -> to,
+    // expanding shortcuts with an explicit stack.
+    void ContractionHierarchy::unpack(size_t from, size_t to, vector<size_t>& path) const {
+        vector<pair<size_t, size_t>> stack(1, make_pair(from, to));
+        while (!stack.empty()) {
+            pair<size_t, size_t> edge = stack.back();
+            stack.pop_back();
+            size_t middle = findArc(edge.first, edge.second).middle;
+            if (middle == NONE) {
+                path.push_back(edge.second);
+                continue;
+            }
+            stack.push_back(make_pair(middle, edge.second));
+            stack.push_back(make_pair(edge.first, middle));
+        }
+    }
+
+    int ContractionHierarchy::distance(size_t src, size_t dest) {
+        size_t meeting;
+        int best = search(src, dest, meeting);
+        return meeting == NONE ? -1 : best;
+    }
+
+    PathResult ContractionHierarchy::query(size_t src, size_t dest) {
+        PathResult answer;
+        size_t meeting;
+        int best = search(src, dest, meeting);
+        answer.src = src;
+        answer.dest = dest;
+        answer.reachable = meeting != NONE;
+        answer.distance = answer.reachable ? best : -1;
+        if (!answer.reachable) return answer;
+        vector<size_t> climb;
+        for (size_t at = meeting; at != NONE; at = forward.parent[at]) climb.push_back(at);
+        answer.path.push_back(src);
+        for (size_t k = climb.size() - 1; k > 0; k--) unpack(climb[k], climb[k - 1], answer.path);
+        for (size_t at = meeting; backward.parent[at] != NONE; at = backward.parent[at]) unpack(at, backward.parent[at], answer.path);
+        return answer;
+    }
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "Algorithms.hpp"
+#include "GraphView.hpp"
+#include "IndexedHeap.hpp"
+#include <vector>
+using namespace std;
+
+namespace ariel {
+    // Contraction hierarchies index for a graph with non-negative weights that
+    // changes rarely and is queried often. The build contracts the vertices one
+    // by one, least important first, and adds a shortcut u -> w around each
+    // contracted v unless a witness search finds a path u ~> w no longer than
+    // u -> v -> w. A query then runs a bidirectional Dijkstra that only climbs
+    // to more important vertices and settles a few hundred vertices even on
+    // large road-like graphs. Shortcuts remember the vertex they skip, so the
+    // path is unpacked back into original edges.
+    //
+    // The index is a snapshot: rebuild it after the graph changes. Like
+    // PathSearch, an index runs one query at a time.
+    class ContractionHierarchy {
+        private:
+            // An edge of the search graph. middle is the contracted vertex a
+            // shortcut skips, NONE for an original edge.
+            struct Arc {
+                size_t target;
+                int weight;
+                size_t middle;
+            };
+
+            // Dist/parent arrays of one query direction, reset through `touched`.
+            struct Side {
+                vector<int> dist;
+                vector<size_t> parent;
+                vector<size_t> touched;
+                IndexedHeap<int> heap;
+
+                explicit Side(size_t n);
+                void reset();
+                void reach(size_t v, int distance, size_t from);
+            };
+
+            // Scratch state of the bounded Dijkstra used during the build.
+            struct Witness;
+
+            size_t n;
+            size_t witnessLimit;
+            vector<size_t> rank;            // contraction order, 0 = contracted first
+            // upOffsets/upArcs: u -> w with rank[u] < rank[w], sorted by target.
+            // downOffsets/downArcs: for w, every u -> w with rank[u] > rank[w],
+            // stored at w with target u, so the backward search also climbs.
+            vector<size_t> upOffsets, downOffsets;
+            vector<Arc> upArcs, downArcs;
+            size_t shortcutCount;
+            Side forward, backward;
+            size_t settledCount;
+
+            void checkVertex(size_t v) const;
+            size_t contract(size_t v, vector<vector<Arc>>& out, vector<vector<Arc>>& in, Witness& witness, bool dryRun);
+            long long priority(size_t v, vector<vector<Arc>>& out, vector<vector<Arc>>& in, Witness& witness,
+                               const vector<size_t>& contractedNeighbours);
+            void contractAll(vector<vector<Arc>>& out, vector<vector<Arc>>& in);
+            const Arc& findArc(size_t from, size_t to) const;
+            bool stalled(const Side& side, const vector<size_t>& offsets, const vector<Arc>& arcs, size_t u) const;
+            int search(size_t src, size_t dest, size_t& meeting);
+            void unpack(size_t from, size_t to, vector<size_t>& path) const;
+
+        public:
+            // Throws invalid_argument on a negative weight. witnessLimit caps the
+            // vertices one witness search may settle; a lower limit builds faster
+            // but adds more (harmless) shortcuts.
+            explicit ContractionHierarchy(const GraphView& g, size_t witnessLimit = 500);
+
+            size_t size() const { return n; }
+            size_t getShortcutCount() const { return shortcutCount; }
+            size_t getRank(size_t v) const;
+            // Shortest distance from src to dest, -1 if dest is unreachable.
+            int distance(size_t src, size_t dest);
+            // Distance and the path over original edges.
+            PathResult query(size_t src, size_t dest);
+            // Vertices settled by the last query, over both directions.
+            size_t lastSettled() const { return settledCount; }
+    };
+}
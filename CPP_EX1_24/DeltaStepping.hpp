@@ -0,0 +1,179 @@
+#pragma once
+
+#include "GraphView.hpp"
+#include "Parallel.hpp"
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <stdexcept>
+#include <vector>
+using namespace std;
+
+namespace ariel {
+    // Parallel delta-stepping single-source shortest paths (Meyer & Sanders),
+    // for non-negative weights. Tentative distances are grouped in buckets of
+    // width delta; a team of threads settles one bucket at a time, relaxing
+    // the edges of its vertices in parallel with an atomic compare-and-swap
+    // minimum, and every improved vertex goes to the caller's local bucket.
+    // Vertices that land back in the current bucket are handled in another
+    // round of the same bucket, so light edges need no separate phase.
+    //
+    // An edge from bucket i reaches at most bucket i + maxWeight / delta, so
+    // the buckets live in a ring of maxWeight / delta + 2 slots.
+    //
+    // delta = 1 gives Dijkstra-like rounds with little parallelism; a delta
+    // as large as the longest path gives Bellman-Ford-like rounds that redo
+    // work. The mean edge weight is a good start.
+    template <typename View>
+    class DeltaStepping {
+        private:
+            static const int INF = INT_MAX;
+            static const size_t NONE = SIZE_MAX;
+            static const size_t CHUNK = 64;
+
+            const View& adj;
+            int delta;
+            size_t threads;
+            size_t ring;
+            vector<atomic<int>> dist;
+            vector<size_t> frontier;
+            vector<vector<vector<size_t>>> bins;  // bins[thread][bucket % ring]
+
+            void relax(size_t u, size_t bucket, size_t id) {
+                int base = dist[u].load(memory_order_relaxed);
+                // Stale entry: u moved to an earlier bucket and was handled there.
+                if (static_cast<size_t>(base / delta) < bucket) return;
+                ARIEL_COUNT_VERTICES(1);
+                for (typename View::Cursor it = adj.neighbors(u); it.valid(); it.next()) {
+                    ARIEL_COUNT_EDGES(1);
+                    int candidate = base + it.weight();
+                    atomic<int>& target = dist[it.target()];
+                    int current = target.load(memory_order_relaxed);
+                    while (candidate < current) {
+                        if (target.compare_exchange_weak(current, candidate, memory_order_relaxed)) {
+                            bins[id][static_cast<size_t>(candidate / delta) % ring].push_back(it.target());
+                            break;
+                        }
+                    }
+                }
+            }
+
+        public:
+            // delta = 0 uses the mean edge weight. Throws invalid_argument on a negative weight.
+            DeltaStepping(const View& view, int bucketWidth, size_t threadCount)
+                : adj(view), delta(bucketWidth), threads(resolveThreads(threadCount)), dist(view.size()) {
+                int longest = 1;
+                long long total = 0, edges = 0;
+                for (size_t u = 0; u < adj.size(); u++) {
+                    for (typename View::Cursor it = adj.neighbors(u); it.valid(); it.next()) {
+                        if (it.weight() < 0) {
+                            throw invalid_argument("Invalid graph: Delta-stepping needs non-negative weights.");
+                        }
+                        longest = max(longest, it.weight());
+                        total += it.weight();
+                        edges++;
+                    }
+                }
+                if (delta <= 0) delta = edges > 0 ? static_cast<int>(max(1LL, total / edges)) : 1;
+                ring = static_cast<size_t>(longest / delta) + 2;
+                bins.assign(threads, vector<vector<size_t>>(ring));
+            }
+
+            int getDelta() const { return delta; }
+
+            // Settles every vertex reachable from src, or stops as soon as
+            // `stopAt` is final (pass SIZE_MAX for a full run).
+            void run(size_t src, size_t stopAt) {
+                for (size_t v = 0; v < dist.size(); v++) dist[v].store(INF, memory_order_relaxed);
+                dist[src].store(0, memory_order_relaxed);
+                frontier.assign(1, src);
+                size_t bucket = 0;
+                atomic<size_t> next(0), nextBucket(NONE), filled(0);
+                Barrier barrier(threads);
+                runTeam(threads, [&](size_t id) {
+                    vector<vector<size_t>>& mine = bins[id];
+                    while (bucket != NONE) {
+                        for (size_t begin = next.fetch_add(CHUNK); begin < frontier.size(); begin = next.fetch_add(CHUNK)) {
+                            size_t end = min(frontier.size(), begin + CHUNK);
+                            for (size_t k = begin; k < end; k++) relax(frontier[k], bucket, id);
+                        }
+                        // The lowest non-empty bucket over every thread is processed next.
+                        for (size_t b = bucket; b < bucket + ring; b++) {
+                            if (mine[b % ring].empty()) continue;
+                            size_t seen = nextBucket.load();
+                            while (b < seen && !nextBucket.compare_exchange_weak(seen, b)) {}
+                            break;
+                        }
+                        barrier.wait();
+                        if (id == 0) {
+                            bucket = nextBucket.load();
+                            int settledBelow = bucket == NONE ? INF : static_cast<int>(min(bucket * static_cast<size_t>(delta), size_t(INF)));
+                            if (stopAt != NONE && dist[stopAt].load(memory_order_relaxed) < settledBelow) bucket = NONE;
+                            nextBucket.store(NONE);
+                            next.store(0);
+                            filled.store(0);
+                            size_t total = 0;
+                            if (bucket != NONE) {
+                                for (size_t t = 0; t < threads; t++) total += bins[t][bucket % ring].size();
+                            }
+                            frontier.resize(total);
+                        }
+                        barrier.wait();
+                        if (bucket == NONE) break;
+                        vector<size_t>& slot = mine[bucket % ring];
+                        size_t at = filled.fetch_add(slot.size());
+                        copy(slot.begin(), slot.end(), frontier.begin() + static_cast<ptrdiff_t>(at));
+                        slot.clear();
+                        barrier.wait();
+                    }
+                });
+                for (size_t t = 0; t < threads; t++) {
+                    for (size_t b = 0; b < ring; b++) bins[t][b].clear();
+                }
+            }
+
+            int distance(size_t v) const { return dist[v].load(memory_order_relaxed); }
+
+            // Copies the distances out, INT_MAX for unreached vertices.
+            void distances(vector<int>& out) const {
+                out.resize(dist.size());
+                for (size_t v = 0; v < dist.size(); v++) out[v] = dist[v].load(memory_order_relaxed);
+            }
+
+            // predecessor[v] = the smallest u with dist[u] + w(u, v) == dist[v], -1 for
+            // the source and unreached vertices. Positive weights make the links
+            // acyclic, and picking the smallest u keeps the paths independent of
+            // thread timing.
+            void predecessors(size_t src, vector<int>& predecessor) const {
+                vector<atomic<int>> best(adj.size());
+                for (size_t v = 0; v < best.size(); v++) best[v].store(INT_MAX, memory_order_relaxed);
+                size_t blocks = (adj.size() + CHUNK - 1) / CHUNK;
+                parallelFor(blocks, threads, [&](size_t block) {
+                    size_t end = min(adj.size(), (block + 1) * CHUNK);
+                    for (size_t u = block * CHUNK; u < end; u++) {
+                        int base = dist[u].load(memory_order_relaxed);
+                        if (base == INF) continue;
+                        for (typename View::Cursor it = adj.neighbors(u); it.valid(); it.next()) {
+                            size_t v = it.target();
+                            if (v == src || v == u || base + it.weight() != dist[v].load(memory_order_relaxed)) continue;
+                            int current = best[v].load(memory_order_relaxed);
+                            int candidate = static_cast<int>(u);
+                            while (candidate < current && !best[v].compare_exchange_weak(current, candidate, memory_order_relaxed)) {}
+                        }
+                    }
+                });
+                predecessor.assign(adj.size(), -1);
+                for (size_t v = 0; v < predecessor.size(); v++) {
+                    int u = best[v].load(memory_order_relaxed);
+                    if (u != INT_MAX) predecessor[v] = u;
+                }
+            }
+    };
+
+    template <typename View>
+    const int DeltaStepping<View>::INF;
+    template <typename View>
+    const size_t DeltaStepping<View>::NONE;
+    template <typename View>
+    const size_t DeltaStepping<View>::CHUNK;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+using namespace std;
+
+namespace ariel {
+    // Disjoint-set forest with path compression and union by rank: any sequence
+    // of m operations on n elements costs O(m α(n)), effectively constant each.
+    // Every root also keeps the size of its set.
+    class DisjointSet {
+        private:
+            vector<size_t> parent;
+            vector<uint8_t> rank;   // upper bound on tree height, at most log2(n)
+            vector<size_t> sizes;   // valid at roots only
+            size_t sets;
+
+        public:
+            explicit DisjointSet(size_t n) : parent(n), rank(n, 0), sizes(n, 1), sets(n) {
+                for (size_t v = 0; v < n; v++) parent[v] = v;
+            }
+
+            size_t size() const { return parent.size(); }
+            size_t setCount() const { return sets; }
+
+            // Root of v's set. Two passes: find the root, then point every vertex on the way at it.
+            size_t find(size_t v) {
+                size_t root = v;
+                while (parent[root] != root) root = parent[root];
+                while (parent[v] != root) {
+                    size_t next = parent[v];
+                    parent[v] = root;
+                    v = next;
+                }
+                return root;
+            }
+
+            // Merges the sets of a and b; false when they were already one set.
+            bool unite(size_t a, size_t b) {
+                a = find(a);
+                b = find(b);
+                if (a == b) return false;
+                if (rank[a] < rank[b]) swap(a, b);
+                parent[b] = a;
+                sizes[a] += sizes[b];
+                if (rank[a] == rank[b]) rank[a]++;
+                sets--;
+                return true;
+            }
+
+            bool same(size_t a, size_t b) { return find(a) == find(b); }
+            size_t setSize(size_t v) { return sizes[find(v)]; }
+    };
+}
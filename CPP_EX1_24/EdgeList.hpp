@@ -0,0 +1,138 @@
+#pragma once
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <utility>
+#include <vector>
+using namespace std;
+
+namespace ariel {
+    // Parser for edge-list text: one `u v w` entry per line, separated by spaces
+    // or tabs. A missing weight means 1, blank lines and lines starting with '#'
+    // or '%' are skipped, and a later line for the same (u, v) overrides an
+    // earlier one, as if the matrix cell were written again (0 clears it).
+    struct EdgeEntry {
+        size_t from;
+        size_t to;
+        int weight;
+    };
+
+    // What one worker learns from its slice of the file.
+    struct EdgeChunk {
+        vector<EdgeEntry> edges;
+        size_t vertices;              // 1 + largest vertex id seen, 0 if none
+        size_t lines;
+        size_t badLine;               // 1-based line within the chunk, 0 if every line parsed
+        bool zeroWeights;
+        // Sum of hash(u, v, w) - hash(v, u, w) over the lines, with and without
+        // weights. A symmetric set of entries sums to zero, so a non-zero sum
+        // proves the graph directed without looking at the built storage.
+        uint64_t fingerprint;
+        uint64_t patternFingerprint;
+
+        EdgeChunk() : vertices(0), lines(0), badLine(0), zeroWeights(false), fingerprint(0), patternFingerprint(0) {}
+    };
+
+    inline uint64_t edgeHash(size_t from, size_t to, int weight) {
+        uint64_t x = from * 0x9E3779B97F4A7C15ULL ^ (to + 0x632BE59BD9B4E019ULL) * 0xC2B2AE3D27D4EB4FULL;
+        x ^= static_cast<uint64_t>(static_cast<uint32_t>(weight)) * 0x165667B19E3779F9ULL;
+        x ^= x >> 31;
+        x *= 0xBF58476D1CE4E5B9ULL;
+        x ^= x >> 29;
+        return x;
+    }
+
+    inline const char* skipBlanks(const char* p, const char* end) {
+        while (p < end && (*p == ' ' || *p == '\t')) p++;
+        return p;
+    }
+
+    inline bool parseVertex(const char*& p, const char* end, size_t& value) {
+        if (p == end || *p < '0' || *p > '9') return false;
+        value = 0;
+        while (p < end && *p >= '0' && *p <= '9') {
+            size_t digit = static_cast<size_t>(*p - '0');
+            if (value > (SIZE_MAX - digit) / 10) return false;
+            value = value * 10 + digit;
+            p++;
+        }
+        return true;
+    }
+
+    inline bool parseWeight(const char*& p, const char* end, int& value) {
+        bool negative = p < end && *p == '-';
+        if (p < end && (*p == '-' || *p == '+')) p++;
+        if (p == end || *p < '0' || *p > '9') return false;
+        // Accumulate the magnitude so INT_MIN still fits.
+        uint64_t limit = negative ? uint64_t(INT_MAX) + 1 : uint64_t(INT_MAX);
+        uint64_t magnitude = 0;
+        while (p < end && *p >= '0' && *p <= '9') {
+            magnitude = magnitude * 10 + static_cast<uint64_t>(*p - '0');
+            if (magnitude > limit) return false;
+            p++;
+        }
+        value = negative ? static_cast<int>(-static_cast<int64_t>(magnitude)) : static_cast<int>(magnitude);
+        return true;
+    }
+
+    // Parses the whole lines in [begin, end). Never throws: a malformed line stops
+    // the chunk and is reported through badLine.
+    inline void parseEdgeChunk(const char* begin, const char* end, EdgeChunk& chunk) {
+        const char* p = begin;
+        while (p < end) {
+            chunk.lines++;
+            p = skipBlanks(p, end);
+            if (p < end && (*p == '#' || *p == '%')) {
+                while (p < end && *p != '\n') p++;
+            }
+            if (p == end || *p == '\n' || *p == '\r') {
+                while (p < end && *p != '\n') p++;
+                if (p < end) p++;
+                continue;
+            }
+            EdgeEntry e;
+            e.weight = 1;
+            bool ok = parseVertex(p, end, e.from);
+            if (ok) {
+                p = skipBlanks(p, end);
+                ok = parseVertex(p, end, e.to);
+            }
+            if (ok) {
+                p = skipBlanks(p, end);
+                if (p < end && *p != '\n' && *p != '\r') ok = parseWeight(p, end, e.weight);
+            }
+            if (ok) {
+                p = skipBlanks(p, end);
+                if (p < end && *p == '\r') p++;
+                ok = p == end || *p == '\n';
+            }
+            if (!ok || e.from == SIZE_MAX || e.to == SIZE_MAX) {
+                chunk.badLine = chunk.lines;
+                return;
+            }
+            if (p < end) p++;
+            chunk.edges.push_back(e);
+            chunk.vertices = max(chunk.vertices, max(e.from, e.to) + 1);
+            chunk.zeroWeights = chunk.zeroWeights || e.weight == 0;
+            chunk.fingerprint += edgeHash(e.from, e.to, e.weight) - edgeHash(e.to, e.from, e.weight);
+            chunk.patternFingerprint += edgeHash(e.from, e.to, 1) - edgeHash(e.to, e.from, 1);
+        }
+    }
+
+    // Cuts [data, data + size) into up to `pieces` ranges that each end right after a newline.
+    inline vector<pair<const char*, const char*>> splitLines(const char* data, size_t size, size_t pieces) {
+        vector<pair<const char*, const char*>> ranges;
+        const char* end = data + size;
+        const char* start = data;
+        for (size_t k = 1; k <= pieces && start < end; k++) {
+            const char* cut = k == pieces ? end : data + size / pieces * k;
+            if (cut < start) cut = start;
+            while (cut < end && cut > data && cut[-1] != '\n') cut++;
+            if (cut == start) continue;
+            ranges.push_back(make_pair(start, cut));
+            start = cut;
+        }
+        return ranges;
+    }
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <utility>
+#include <vector>
+using namespace std;
+
+namespace ariel {
+    // Square int matrix in one contiguous, cache-line aligned allocation.
+    // Rows are padded to a multiple of 16 ints so every row starts on its own
+    // 64-byte boundary; the padding cells are always zero.
+    class FlatMatrix {
+        private:
+            static const size_t ALIGNMENT = 64;
+            static const size_t ROW_ALIGNMENT = ALIGNMENT / sizeof(int);
+
+            int* cells;
+            size_t n;
+            size_t stride;
+
+            void allocate(size_t size) {
+                n = size;
+                stride = (size + ROW_ALIGNMENT - 1) / ROW_ALIGNMENT * ROW_ALIGNMENT;
+                cells = nullptr;
+                if (n == 0) return;
+                void* memory = nullptr;
+                if (posix_memalign(&memory, ALIGNMENT, n * stride * sizeof(int)) != 0) {
+                    throw bad_alloc();
+                }
+                cells = static_cast<int*>(memory);
+                memset(cells, 0, n * stride * sizeof(int));
+            }
+
+        public:
+            FlatMatrix() : cells(nullptr), n(0), stride(0) {}
+
+            explicit FlatMatrix(size_t size) { allocate(size); }
+
+            // Copies a square vector-of-rows matrix.
+            explicit FlatMatrix(const vector<vector<int>>& matrix) {
+                allocate(matrix.size());
+                for (size_t i = 0; i < n; i++) {
+                    memcpy(row(i), matrix[i].data(), n * sizeof(int));
+                }
+            }
+
+            FlatMatrix(const FlatMatrix& other) {
+                allocate(other.n);
+                if (n > 0) memcpy(cells, other.cells, n * stride * sizeof(int));
+            }
+
+            FlatMatrix(FlatMatrix&& other) noexcept : cells(other.cells), n(other.n), stride(other.stride) {
+                other.cells = nullptr;
+                other.n = other.stride = 0;
+            }
+
+            FlatMatrix& operator=(FlatMatrix other) {
+                swap(other);
+                return *this;
+            }
+
+            ~FlatMatrix() { free(cells); }
+
+            void swap(FlatMatrix& other) {
+                std::swap(cells, other.cells);
+                std::swap(n, other.n);
+                std::swap(stride, other.stride);
+            }
+
+            size_t size() const { return n; }
+            bool empty() const { return n == 0; }
+            size_t rowStride() const { return stride; }
+            const int* data() const { return cells; }
+            int* row(size_t i) { return cells + i * stride; }
+            const int* row(size_t i) const { return cells + i * stride; }
+            int& at(size_t i, size_t j) { return cells[i * stride + j]; }
+            int at(size_t i, size_t j) const { return cells[i * stride + j]; }
+
+            vector<vector<int>> toVectors() const {
+                vector<vector<int>> matrix(n);
+                for (size_t i = 0; i < n; i++) matrix[i].assign(row(i), row(i) + n);
+                return matrix;
+            }
+    };
+}
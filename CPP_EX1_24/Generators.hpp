@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cmath>
+#include <random>
+#include <string>
+using namespace std;
+
+namespace ariel {
+    // Synthetic graph families for the benchmark suite.
+    enum class GraphFamily { ErdosRenyi, RMat, Grid, Chain, CompleteBipartite };
+
+    inline string familyName(GraphFamily family) {
+        switch (family) {
+            case GraphFamily::ErdosRenyi: return "erdos-renyi";
+            case GraphFamily::RMat: return "rmat";
+            case GraphFamily::Grid: return "grid";
+            case GraphFamily::Chain: return "chain";
+            default: return "complete-bipartite";
+        }
+    }
+
+    // Vertex count the family actually uses when asked for about n vertices:
+    // a grid is the largest square that fits.
+    inline size_t familyVertices(GraphFamily family, size_t n) {
+        if (family != GraphFamily::Grid) return n;
+        size_t side = static_cast<size_t>(sqrt(static_cast<double>(n)));
+        return side * side;
+    }
+
+    // Calls emit(u, v, w) once per undirected edge u != v, with weights 1..100
+    // drawn from `seed`, so the same arguments always give the same graph.
+    // - ErdosRenyi: G(n, m) with m = 4n edges (mean degree 8), repeats possible.
+    // - RMat: 8n edges from the recursive matrix with (a, b, c, d) = (0.57, 0.19,
+    //   0.19, 0.05), which gives the power-law degrees of social graphs.
+    // - Grid: 4-neighbour lattice on familyVertices(Grid, n) vertices.
+    // - Chain: the path 0 - 1 - ... - n-1, the deepest possible traversal.
+    // - CompleteBipartite: K(k, n - k) with k = min(n / 2, 16), so the edge count
+    //   stays linear in n.
+    template <typename Emit>
+    void generateGraph(GraphFamily family, size_t n, unsigned seed, Emit emit) {
+        mt19937_64 rng(seed);
+        uniform_int_distribution<int> weight(1, 100);
+        if (family == GraphFamily::ErdosRenyi) {
+            uniform_int_distribution<size_t> vertex(0, n - 1);
+            for (size_t k = 0; k < 4 * n; k++) {
+                size_t u = vertex(rng), v = vertex(rng);
+                if (u != v) emit(u, v, weight(rng));
+            }
+        } else if (family == GraphFamily::RMat) {
+            size_t scale = 0;
+            while ((size_t(1) << scale) < n) scale++;
+            uniform_real_distribution<double> coin(0.0, 1.0);
+            for (size_t k = 0; k < 8 * n; k++) {
+                size_t u = 0, v = 0;
+                for (size_t bit = 0; bit < scale; bit++) {
+                    double p = coin(rng);
+                    u = 2 * u + (p >= 0.76 ? 1 : 0);
+                    v = 2 * v + ((p >= 0.57 && p < 0.76) || p >= 0.95 ? 1 : 0);
+                }
+                if (u < n && v < n && u != v) emit(u, v, weight(rng));
+            }
+        } else if (family == GraphFamily::Grid) {
+            size_t side = static_cast<size_t>(sqrt(static_cast<double>(n)));
+            for (size_t r = 0; r < side; r++) {
+                for (size_t c = 0; c < side; c++) {
+                    size_t v = r * side + c;
+                    if (c + 1 < side) emit(v, v + 1, weight(rng));
+                    if (r + 1 < side) emit(v, v + side, weight(rng));
+                }
+            }
+        } else if (family == GraphFamily::Chain) {
+            for (size_t v = 0; v + 1 < n; v++) emit(v, v + 1, weight(rng));
+        } else {
+            size_t left = n / 2 < 16 ? n / 2 : 16;
+            for (size_t u = 0; u < left; u++) {
+                for (size_t v = left; v < n; v++) emit(u, v, weight(rng));
+            }
+        }
+    }
+}
@@ -1,14 +1,148 @@
 #include "Graph.hpp"
+#include "Parallel.hpp"
 #include <stdexcept>
 #include <iostream>
 #include <limits>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
 
 using namespace std;
 
 namespace ariel {
-    Graph::Graph():isDirected(false){} 
+namespace {
+    const size_t CLASSIFY_TILE = 64;
+    const size_t EDGE_LIST_PIECES_PER_THREAD = 4;
+    const ptrdiff_t SMALL_ROW = 32;
+    const size_t CACHE_LINE = 64;
+    atomic<uint64_t> lastVersion(0);
 
-    void Graph::loadGraph(vector<vector<int>>& matrix) {
+    uint64_t nextVersion() {
+        return lastVersion.fetch_add(1, memory_order_relaxed) + 1;
+    }
+
+    size_t countNonZero(const int* cells, size_t count) {
+        size_t nonZero = 0;
+        for (size_t k = 0; k < count; k++) nonZero += static_cast<size_t>(cells[k] != 0);
+        return nonZero;
+    }
+
+    size_t countNegative(const int* cells, size_t count) {
+        size_t negative = 0;
+        for (size_t k = 0; k < count; k++) negative += static_cast<size_t>(cells[k] < 0);
+        return negative;
+    }
+
+    // Transposes a 64 x 64 bit block in place (bit c of word r goes to bit r of
+    // word c) by swapping ever smaller off-diagonal sub-blocks: 32 x 32, 16 x 16, ...
+    void transposeBits(uint64_t* block) {
+        uint64_t mask = 0x00000000FFFFFFFFULL;
+        for (size_t half = 32; half != 0; half >>= 1, mask ^= mask << half) {
+            for (size_t k = 0; k < 64; k = (k + half + 1) & ~half) {
+                uint64_t swap = ((block[k] >> half) ^ block[k + half]) & mask;
+                block[k] ^= swap << half;
+                block[k + half] ^= swap;
+            }
+        }
+    }
+
+    // Copies `rows` rows of `width` int cells (`stride` apart) into rows of Cell
+    // `narrowStride` apart; the caller has checked that every value fits.
+    template <typename Cell>
+    vector<Cell> narrowCells(const int* cells, size_t rows, size_t stride, size_t width, size_t narrowStride) {
+        vector<Cell> out(rows * narrowStride, 0);
+        for (size_t i = 0; i < rows; i++) {
+            for (size_t j = 0; j < width; j++) out[i * narrowStride + j] = static_cast<Cell>(cells[i * stride + j]);
+        }
+        return out;
+    }
+
+    WeightType narrowestType(int low, int high) {
+        if (low >= 0 && high <= numeric_limits<uint8_t>::max()) return WeightType::UInt8;
+        if (low >= numeric_limits<int16_t>::min() && high <= numeric_limits<int16_t>::max()) return WeightType::Int16;
+        return WeightType::Int32;
+    }
+
+    template <typename Cell>
+    void appendCell(vector<uint8_t>& out, int weight) {
+        Cell cell = static_cast<Cell>(weight);
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&cell);
+        out.insert(out.end(), bytes, bytes + sizeof(cell));
+    }
+
+    // Appends row u in the CompressedView layout (GraphView.hpp); `row` holds the
+    // (target, weight) pairs in ascending target order.
+    void appendCompressedRow(vector<uint8_t>& out, size_t u, const vector<pair<size_t, int>>& row, WeightType type, bool weighted) {
+        size_t degree = row.size();
+        do {
+            uint8_t byte = static_cast<uint8_t>(degree & 0x7F);
+            degree >>= 7;
+            out.push_back(degree != 0 ? static_cast<uint8_t>(byte | 0x80) : byte);
+        } while (degree != 0);
+        for (size_t k = 0; weighted && k < row.size(); k++) {
+            switch (type) {
+                case WeightType::UInt8: appendCell<uint8_t>(out, row[k].second); break;
+                case WeightType::Int16: appendCell<int16_t>(out, row[k].second); break;
+                default: appendCell<int>(out, row[k].second);
+            }
+        }
+        const size_t control = out.size();
+        out.resize(out.size() + (row.size() + 3) / 4, 0);
+        for (size_t k = 0; k < row.size(); k++) {
+            uint64_t gap = row[k].first - (k == 0 ? u : row[k - 1].first);
+            if (k == 0) gap = row[0].first >= u ? gap << 1 : ((u - row[0].first) << 1) - 1;  // zigzag
+            unsigned key = gap < (1U << 8) ? 0 : gap < (1U << 16) ? 1 : gap < (1U << 24) ? 2 : 3;
+            out[control + k / 4] = static_cast<uint8_t>(out[control + k / 4] | key << (k % 4 * 2));
+            for (unsigned b = 0; b <= key; b++) out.push_back(static_cast<uint8_t>(gap >> (8 * b)));
+        }
+    }
+
+    // Closes a stream of n rows: the end offset, and the spare bytes the cursors' 4-byte loads may touch.
+    void endCompressedRows(vector<uint8_t>& rows, vector<size_t>& starts) {
+        starts.back() = rows.size();
+        rows.resize(rows.size() + 3, 0);
+        rows.shrink_to_fit();
+    }
+
+    void writeBytes(FILE* file, const void* bytes, size_t count, const string& path) {
+        if (count > 0 && fwrite(bytes, 1, count, file) != count) {
+            fclose(file);
+            throw runtime_error("Cannot write graph file: " + path);
+        }
+    }
+
+    // CSR payload streamed row by row from any view, so nothing is materialized twice.
+    template <typename View>
+    void writeCsr(FILE* file, const View& adj, const string& path) {
+        vector<size_t> offsets(adj.size() + 1, 0);
+        for (size_t u = 0; u < adj.size(); u++) {
+            size_t degree = 0;
+            for (typename View::Cursor it = adj.neighbors(u); it.valid(); it.next()) degree++;
+            offsets[u + 1] = offsets[u] + degree;
+        }
+        writeBytes(file, offsets.data(), offsets.size() * sizeof(size_t), path);
+        vector<size_t> cols;
+        for (size_t u = 0; u < adj.size(); u++) {
+            cols.clear();
+            for (typename View::Cursor it = adj.neighbors(u); it.valid(); it.next()) cols.push_back(it.target());
+            writeBytes(file, cols.data(), cols.size() * sizeof(size_t), path);
+        }
+        vector<int> weights;
+        for (size_t u = 0; u < adj.size(); u++) {
+            weights.clear();
+            for (typename View::Cursor it = adj.neighbors(u); it.valid(); it.next()) weights.push_back(it.weight());
+            writeBytes(file, weights.data(), weights.size() * sizeof(int), path);
+        }
+    }
+}
+
+    Graph::Graph():wordsPerRow(0), numOfVertices(0), numOfEdges(0), isDirected(false), storage(Storage::Dense), mappedEntries(0),
+        nonZeroEntries(0), selfLoops(0), negativeEntries(0), asymmetricPairs(0), asymmetryCounted(true),
+        version(nextVersion()), weightType(WeightType::Int32), compactStride(0), compressedType(WeightType::Int32),
+        compressedWeighted(false), expandedForUpdate(false){}
+
+    void Graph::loadGraph(vector<vector<int>>& matrix, Storage mode) {
         if (matrix.empty()){
             throw invalid_argument("Invalid graph: The graph is not a square matrix.");
         }
@@ -17,45 +151,1205 @@ namespace ariel {
             throw invalid_argument("Invalid graph: The graph is not a square matrix.");
             }
         }
-        matrixGraph = matrix;
+        // A bit cannot tell a negative weight from a positive one, and the traversals skip negative edges.
+        if (mode == Storage::Bitset) {
+            for (size_t i = 0; i < matrix.size(); i++) {
+                for (size_t j = 0; j < matrix.size(); j++) {
+                    if (matrix[i][j] < 0) throw invalid_argument("Invalid graph: Bitset storage cannot hold a negative weight.");
+                }
+            }
+        }
+        clearStorage();
+        storage = mode == Storage::Compressed ? Storage::Sparse : mode;
+        numOfVertices = matrix.size();
+        if (storage == Storage::Sparse) {
+            buildSparse(matrix);
+        } else if (mode == Storage::Bitset) {
+            buildBitset(matrix);
+        } else {
+            matrixGraph = FlatMatrix(matrix);
+        }
         classifyGraph();
+        if (mode == Storage::Compressed) compressRows();
     }
 
-    bool Graph::getIsDirected(){
-        return isDirected; 
+    void Graph::clearStorage() {
+        matrixGraph = FlatMatrix();
+        rowOffsets.clear();
+        colIndices.clear();
+        edgeWeights.clear();
+        adjacencyBits.clear();
+        wordsPerRow = 0;
+        mappedFile.reset();
+        mappedEntries = 0;
+        weightType = WeightType::Int32;
+        vector<uint8_t>().swap(weights8);
+        vector<int16_t>().swap(weights16);
+        compactStride = 0;
+        vector<uint8_t>().swap(compressedRows);
+        vector<size_t>().swap(compressedStarts);
+        expandedForUpdate = false;
+        originalIds.clear();
+        internalIds.clear();
+        version = nextVersion();
+    }
+
+    void Graph::loadEdgeList(const string& path, Storage requested, size_t threads) {
+        const Storage mode = requested == Storage::Compressed ? Storage::Sparse : requested;
+        MappedFile file(path);
+        size_t workers = resolveThreads(threads);
+        vector<pair<const char*, const char*>> pieces = splitLines(file.data(), file.size(), workers * EDGE_LIST_PIECES_PER_THREAD);
+        vector<EdgeChunk> chunks(pieces.size());
+        parallelFor(pieces.size(), workers, [&](size_t c) {
+            parseEdgeChunk(pieces[c].first, pieces[c].second, chunks[c]);
+        });
+        size_t n = 0, line = 0;
+        uint64_t fingerprint = 0;
+        bool zeroWeights = false;
+        for (size_t c = 0; c < chunks.size(); c++) {
+            if (chunks[c].badLine != 0) {
+                throw invalid_argument("Invalid edge list: bad entry on line " + to_string(line + chunks[c].badLine) + " of " + path);
+            }
+            line += chunks[c].lines;
+            n = max(n, chunks[c].vertices);
+            fingerprint += mode == Storage::Bitset ? chunks[c].patternFingerprint : chunks[c].fingerprint;
+            zeroWeights = zeroWeights || chunks[c].zeroWeights;
+        }
+        if (n == 0) {
+            throw invalid_argument("Invalid edge list: no edges in " + path);
+        }
+        if (mode == Storage::Bitset) {
+            for (size_t c = 0; c < chunks.size(); c++) {
+                for (size_t k = 0; k < chunks[c].edges.size(); k++) {
+                    if (chunks[c].edges[k].weight < 0) {
+                        throw invalid_argument("Invalid edge list: Bitset storage cannot hold the negative weights in " + path);
+                    }
+                }
+            }
+        }
+        clearStorage();
+        storage = mode;
+        numOfVertices = n;
+        size_t entries = 0, loops = 0, negatives = 0;
+        bool overridden = mode == Storage::Sparse ? buildSparseFromEdges(chunks, workers, entries, loops)
+                                                  : buildCellsFromEdges(chunks, entries, loops, negatives);
+        if (mode == Storage::Sparse) negatives = countNegative(edgeWeights.data(), edgeWeights.size());
+        // When every line became its own entry, the fingerprint already settles
+        // a directed graph; otherwise each entry is checked against its mirror.
+        if (!overridden && !zeroWeights && fingerprint != 0) {
+            isDirected = true;
+        } else {
+            isDirected = hasAsymmetricEntry(chunks, workers);
+        }
+        nonZeroEntries = entries;
+        selfLoops = loops;
+        negativeEntries = negatives;
+        asymmetricPairs = 0;
+        asymmetryCounted = !isDirected;
+        refreshMetadata();
+        if (requested == Storage::Compressed) compressRows();
+    }
+
+    // Counting sort of the lines straight into colIndices / edgeWeights, in file
+    // order, releasing each chunk's lines once they are placed, so the lines are
+    // never held twice. A parallel pass then sorts every row by column, keeps the
+    // last line for each cell and drops zero weights; the rows are closed up
+    // afterwards only if something was dropped. Returns whether any line
+    // overrode an earlier one.
+    bool Graph::buildSparseFromEdges(vector<EdgeChunk>& chunks, size_t threads, size_t& entries, size_t& loops) {
+        const size_t n = numOfVertices;
+        vector<size_t> slotOffsets(n + 1, 0);
+        for (size_t c = 0; c < chunks.size(); c++) {
+            for (size_t k = 0; k < chunks[c].edges.size(); k++) slotOffsets[chunks[c].edges[k].from + 1]++;
+        }
+        for (size_t u = 0; u < n; u++) slotOffsets[u + 1] += slotOffsets[u];
+        colIndices.resize(slotOffsets[n]);
+        edgeWeights.resize(slotOffsets[n]);
+        vector<size_t> next(slotOffsets.begin(), slotOffsets.end() - 1);
+        for (size_t c = 0; c < chunks.size(); c++) {
+            for (size_t k = 0; k < chunks[c].edges.size(); k++) {
+                const EdgeEntry& e = chunks[c].edges[k];
+                size_t slot = next[e.from]++;
+                colIndices[slot] = e.to;
+                edgeWeights[slot] = e.weight;
+            }
+            vector<EdgeEntry>().swap(chunks[c].edges);
+        }
+        vector<size_t>().swap(next);
+        vector<size_t> kept(n, 0);
+        vector<char> selfLoop(n, 0);
+        atomic<bool> overridden(false);
+        parallelFor(n, threads, [&](size_t u) {
+            size_t* cols = colIndices.data() + slotOffsets[u];
+            int* weights = edgeWeights.data() + slotOffsets[u];
+            const size_t count = slotOffsets[u + 1] - slotOffsets[u];
+            if (count <= static_cast<size_t>(SMALL_ROW)) {
+                // Insertion sort: stable and allocation-free for the typical short row.
+                for (size_t k = 1; k < count; k++) {
+                    size_t col = cols[k];
+                    int weight = weights[k];
+                    size_t hole = k;
+                    for (; hole > 0 && cols[hole - 1] > col; --hole) {
+                        cols[hole] = cols[hole - 1];
+                        weights[hole] = weights[hole - 1];
+                    }
+                    cols[hole] = col;
+                    weights[hole] = weight;
+                }
+            } else {
+                vector<pair<size_t, int>> row(count);
+                for (size_t k = 0; k < count; k++) row[k] = make_pair(cols[k], weights[k]);
+                stable_sort(row.begin(), row.end(), [](const pair<size_t, int>& a, const pair<size_t, int>& b) { return a.first < b.first; });
+                for (size_t k = 0; k < count; k++) {
+                    cols[k] = row[k].first;
+                    weights[k] = row[k].second;
+                }
+            }
+            size_t out = 0;
+            for (size_t k = 0; k < count; k++) {
+                if (k + 1 != count && cols[k + 1] == cols[k]) {
+                    overridden.store(true, memory_order_relaxed);
+                    continue;
+                }
+                if (weights[k] == 0) continue;
+                if (cols[k] == u) selfLoop[u] = 1;
+                cols[out] = cols[k];
+                weights[out] = weights[k];
+                out++;
+            }
+            kept[u] = out;
+        });
+        rowOffsets.assign(n + 1, 0);
+        for (size_t u = 0; u < n; u++) {
+            rowOffsets[u + 1] = rowOffsets[u] + kept[u];
+            loops += static_cast<size_t>(selfLoop[u]);
+        }
+        entries = rowOffsets[n];
+        if (entries != slotOffsets[n]) {
+            // Every row moves left or stays, so closing up in row order never overwrites a row still to move.
+            for (size_t u = 0; u < n; u++) {
+                if (rowOffsets[u] == slotOffsets[u]) continue;
+                copy(colIndices.begin() + static_cast<ptrdiff_t>(slotOffsets[u]), colIndices.begin() + static_cast<ptrdiff_t>(slotOffsets[u] + kept[u]),
+                     colIndices.begin() + static_cast<ptrdiff_t>(rowOffsets[u]));
+                copy(edgeWeights.begin() + static_cast<ptrdiff_t>(slotOffsets[u]), edgeWeights.begin() + static_cast<ptrdiff_t>(slotOffsets[u] + kept[u]),
+                     edgeWeights.begin() + static_cast<ptrdiff_t>(rowOffsets[u]));
+            }
+            colIndices.resize(entries);
+            edgeWeights.resize(entries);
+        }
+        return overridden.load();
+    }
+
+    // Writes the lines into the dense matrix or the bitset in file order, keeping
+    // the non-zero, self-loop and negative counts up to date as cells change.
+    bool Graph::buildCellsFromEdges(const vector<EdgeChunk>& chunks, size_t& entries, size_t& loops, size_t& negatives) {
+        const size_t n = numOfVertices;
+        bool overridden = false;
+        if (storage == Storage::Bitset) {
+            wordsPerRow = (n + 63) / 64;
+            adjacencyBits.assign(n * wordsPerRow, 0);
+        } else {
+            matrixGraph = FlatMatrix(n);
+        }
+        for (size_t c = 0; c < chunks.size(); c++) {
+            for (size_t k = 0; k < chunks[c].edges.size(); k++) {
+                const EdgeEntry& e = chunks[c].edges[k];
+                bool had;
+                if (storage == Storage::Bitset) {
+                    uint64_t& word = adjacencyBits[e.from * wordsPerRow + e.to / 64];
+                    uint64_t mask = uint64_t(1) << (e.to % 64);
+                    had = (word & mask) != 0;
+                    word = e.weight != 0 ? word | mask : word & ~mask;
+                } else {
+                    int& cell = matrixGraph.at(e.from, e.to);
+                    had = cell != 0;
+                    if (cell < 0) negatives--;
+                    if (e.weight < 0) negatives++;
+                    cell = e.weight;
+                }
+                overridden = overridden || had;
+                if (had) {
+                    entries--;
+                    if (e.from == e.to) loops--;
+                }
+                if (e.weight != 0) {
+                    entries++;
+                    if (e.from == e.to) loops++;
+                }
+            }
+        }
+        return overridden;
+    }
+
+    // CSR graphs are checked on the finished rows, whose lines
+    // buildSparseFromEdges has already released: they are compared with their
+    // transpose in one row-order pass, where the entries (u, v) visited in
+    // ascending u must show up in ascending order at the front of row v, which
+    // avoids a binary search per entry. For the other
+    // storages every stored cell came from some line, so checking the mirror of
+    // each line's cell covers the whole graph in O(E) instead of O(V^2).
+    bool Graph::hasAsymmetricEntry(const vector<EdgeChunk>& chunks, size_t threads) const {
+        if (storage == Storage::Sparse) {
+            vector<size_t> next(rowOffsets.begin(), rowOffsets.end() - 1);
+            for (size_t u = 0; u < numOfVertices; u++) {
+                for (size_t e = rowOffsets[u]; e < rowOffsets[u + 1]; e++) {
+                    size_t v = colIndices[e];
+                    size_t mirror = next[v]++;
+                    if (mirror == rowOffsets[v + 1] || colIndices[mirror] != u || edgeWeights[mirror] != edgeWeights[e]) return true;
+                }
+            }
+            return false;
+        }
+        atomic<bool> asymmetric(false);
+        parallelFor(chunks.size(), threads, [&](size_t c) {
+            for (size_t k = 0; k < chunks[c].edges.size() && !asymmetric.load(memory_order_relaxed); k++) {
+                const EdgeEntry& e = chunks[c].edges[k];
+                bool mismatch;
+                if (storage == Storage::Bitset) {
+                    BitsetView bits(adjacencyBits.data(), wordsPerRow, numOfVertices);
+                    mismatch = bits.hasEdge(e.from, e.to) != bits.hasEdge(e.to, e.from);
+                } else {
+                    mismatch = matrixGraph.at(e.from, e.to) != matrixGraph.at(e.to, e.from);
+                }
+                if (mismatch) asymmetric.store(true, memory_order_relaxed);
+            }
+        });
+        return asymmetric.load();
+    }
+
+    void Graph::openGraph(const string& path) {
+        shared_ptr<const MappedFile> file = make_shared<const MappedFile>(path);
+        GraphFileHeader header;
+        if (file->size() < sizeof(header)) {
+            throw invalid_argument("Invalid graph file: " + path);
+        }
+        memcpy(&header, file->data(), sizeof(header));
+        // Only O(1) checks: the payload size must match the header exactly.
+        size_t payload = file->size() - sizeof(header);
+        size_t n = header.numOfVertices, entries = header.entries;
+        bool valid = memcmp(header.magic, GRAPH_FILE_MAGIC, sizeof(header.magic)) == 0 &&
+                     (header.version == GRAPH_FILE_VERSION || header.version == 1) && n > 0;
+        if (valid && header.layout == static_cast<uint32_t>(Storage::Dense)) {
+            valid = entries >= n && entries <= payload / sizeof(int) &&
+                    payload % (entries * sizeof(int)) == 0 && payload / (entries * sizeof(int)) == n;
+        } else if (valid && header.layout == static_cast<uint32_t>(Storage::Sparse)) {
+            valid = n < payload / sizeof(size_t);
+            if (valid) {
+                size_t rest = payload - (n + 1) * sizeof(size_t);
+                const size_t* offsets = reinterpret_cast<const size_t*>(file->data() + sizeof(header));
+                valid = rest % (sizeof(size_t) + sizeof(int)) == 0 && rest / (sizeof(size_t) + sizeof(int)) == entries &&
+                        offsets[0] == 0 && offsets[n] == entries;
+            }
+        } else {
+            valid = false;
+        }
+        if (!valid) {
+            throw invalid_argument("Invalid graph file: " + path);
+        }
+        clearStorage();
+        storage = static_cast<Storage>(header.layout);
+        numOfVertices = n;
+        numOfEdges = static_cast<int>(header.numOfEdges);
+        isDirected = header.isDirected != 0;
+        mappedEntries = entries;
+        mappedFile = file;
+        // The per-cell counters are only needed for mutations, which first copy the mapping.
+        nonZeroEntries = selfLoops = asymmetricPairs = 0;
+        asymmetryCounted = false;
+        // Version 1 headers predate the negative-weight flag, so those weights are read once.
+        negativeEntries = header.hasNegativeWeights;
+        if (header.version == 1) {
+            GraphView g = view();
+            for (size_t u = 0; u < n; u++) {
+                if (storage == Storage::Dense) {
+                    negativeEntries += countNegative(g.denseView().row(u), n);
+                    continue;
+                }
+                for (SparseView::Cursor it = g.sparseView().neighbors(u); it.valid(); it.next()) {
+                    negativeEntries += static_cast<size_t>(it.weight() < 0);
+                }
+            }
+        }
+    }
+
+    void Graph::saveGraph(const string& path) const {
+        if (numOfVertices == 0) {
+            throw invalid_argument("Invalid graph: The graph is empty.");
+        }
+        if (weightType != WeightType::Int32) {
+            // The file format holds int weights.
+            Graph wide = *this;
+            wide.widenWeights();
+            wide.saveGraph(path);
+            return;
+        }
+        GraphView g = view();
+        GraphFileHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, GRAPH_FILE_MAGIC, sizeof(header.magic));
+        header.version = GRAPH_FILE_VERSION;
+        header.numOfVertices = numOfVertices;
+        header.numOfEdges = static_cast<uint64_t>(numOfEdges);
+        header.isDirected = isDirected ? 1U : 0U;
+        header.hasNegativeWeights = negativeEntries > 0 ? 1U : 0U;
+        if (storage == Storage::Dense) {
+            header.layout = static_cast<uint32_t>(Storage::Dense);
+            header.entries = g.denseView().rowStride();
+        } else {
+            header.layout = static_cast<uint32_t>(Storage::Sparse);
+            size_t entries = 0;
+            if (storage == Storage::Sparse) {
+                for (size_t u = 0; u < numOfVertices; u++) entries += g.sparseView().degree(u);
+            } else if (storage == Storage::Compressed) {
+                for (size_t u = 0; u < numOfVertices; u++) entries += g.compressedView().degree(u);
+            } else {
+                for (size_t w = 0; w < numOfVertices * wordsPerRow; w++) {
+                    entries += static_cast<size_t>(__builtin_popcountll(adjacencyBits[w]));
+                }
+            }
+            header.entries = entries;
+        }
+        FILE* file = fopen(path.c_str(), "wb");
+        if (file == nullptr) {
+            throw runtime_error("Cannot write graph file: " + path);
+        }
+        writeBytes(file, &header, sizeof(header), path);
+        if (storage == Storage::Dense) {
+            // Rows go out with their zero padding, so the file mirrors the FlatMatrix layout.
+            writeBytes(file, g.denseView().row(0), numOfVertices * g.denseView().rowStride() * sizeof(int), path);
+        } else if (storage == Storage::Sparse) {
+            writeCsr(file, g.sparseView(), path);
+        } else if (storage == Storage::Compressed) {
+            writeCsr(file, g.compressedView(), path);
+        } else {
+            writeCsr(file, g.bitsetView(), path);
+        }
+        if (fclose(file) != 0) {
+            throw runtime_error("Cannot write graph file: " + path);
+        }
+    }
+
+    void Graph::buildSparse(const vector<vector<int>>& matrix) {
+        size_t nonZero = 0;
+        for (size_t i = 0; i < matrix.size(); ++i) {
+            for (size_t j = 0; j < matrix.size(); ++j) {
+                if (matrix[i][j] != 0) nonZero++;
+            }
+        }
+        rowOffsets.assign(matrix.size() + 1, 0);
+        colIndices.clear();
+        edgeWeights.clear();
+        colIndices.reserve(nonZero);
+        edgeWeights.reserve(nonZero);
+        for (size_t i = 0; i < matrix.size(); ++i) {
+            for (size_t j = 0; j < matrix.size(); ++j) {
+                if (matrix[i][j] != 0) {
+                    colIndices.push_back(j);
+                    edgeWeights.push_back(matrix[i][j]);
+                }
+            }
+            rowOffsets[i + 1] = colIndices.size();
+        }
+    }
+
+    // Any non-zero cell becomes an edge; the weight itself is dropped.
+    void Graph::buildBitset(const vector<vector<int>>& matrix) {
+        wordsPerRow = (matrix.size() + 63) / 64;
+        adjacencyBits.assign(matrix.size() * wordsPerRow, 0);
+        for (size_t i = 0; i < matrix.size(); ++i) {
+            uint64_t* row = &adjacencyBits[i * wordsPerRow];
+            for (size_t j = 0; j < matrix.size(); ++j) {
+                if (matrix[i][j] != 0) {
+                    row[j / 64] |= uint64_t(1) << (j % 64);
+                }
+            }
+        }
+    }
+
+    // Rows are stored with ascending column indices, so a lookup is a binary search.
+    bool Graph::hasSparseEdge(size_t from, size_t to, int weight) const {
+        vector<size_t>::const_iterator first = colIndices.begin() + static_cast<ptrdiff_t>(rowOffsets[from]);
+        vector<size_t>::const_iterator last = colIndices.begin() + static_cast<ptrdiff_t>(rowOffsets[from + 1]);
+        vector<size_t>::const_iterator it = lower_bound(first, last, to);
+        if (it == last || *it != to) return false;
+        return edgeWeights[static_cast<size_t>(it - colIndices.begin())] == weight;
+    }
+
+    bool Graph::getIsDirected() const {
+        return isDirected;
+    }
+
+    bool Graph::hasNegativeWeights() const {
+        return negativeEntries > 0;
+    }
+
+    uint64_t Graph::getVersion() const {
+        return version;
+    }
+
+    int Graph::getNumOfEdges() const {
+        return numOfEdges;
     }
 
     void Graph::classifyGraph() {
+        // A mapped file carries its metadata in the header and is never scanned.
+        if (mappedFile) return;
+        if (storage == Storage::Compressed) {
+            expandRows();
+            classifyGraph();
+            compressRows();
+            return;
+        }
+        // The scans below read the int cells, which a narrowed graph has dropped.
+        if (weightType != WeightType::Int32) {
+            WeightType narrowed = weightType;
+            widenWeights();
+            classifyGraph();
+            narrowWeights(narrowed);
+            return;
+        }
         isDirected = false;
-        numOfEdges = 0;
-        for (size_t i = 0; i < matrixGraph.size(); ++i) {
-            for (size_t j = 0; j < matrixGraph.size(); ++j) {
-                if (matrixGraph[i][j] != matrixGraph[j][i]) {
-                    isDirected = true;
-                }
-            }
-        }
-        for (size_t i = 0; i < matrixGraph.size(); ++i) {
-            for (size_t j = 0; j < matrixGraph.size(); ++j) {
-                if (matrixGraph[i][j] != 0) {
-                    if (isDirected) {
-                        numOfEdges++;
-                    } else {
-                        if (i < j) {
-                            numOfEdges++;
-                            numOfEdges++;
+        if (storage == Storage::Sparse) {
+            // Every stored entry needs a mirror with the same weight for the graph to be undirected.
+            for (size_t i = 0; i < numOfVertices && !isDirected; ++i) {
+                for (size_t e = rowOffsets[i]; e < rowOffsets[i + 1]; ++e) {
+                    if (!hasSparseEdge(colIndices[e], i, edgeWeights[e])) {
+                        isDirected = true;
+                        break;
+                    }
+                }
+            }
+            nonZeroEntries = colIndices.size();
+            negativeEntries = countNegative(edgeWeights.data(), edgeWeights.size());
+            selfLoops = 0;
+            for (size_t i = 0; i < numOfVertices; ++i) {
+                selfLoops += static_cast<size_t>(storedWeight(i, i) != 0);
+            }
+        } else if (storage == Storage::Bitset) {
+            classifyBitset();
+        } else {
+            classifyDense();
+        }
+        // Asymmetric pairs are only counted once a mutation needs them.
+        asymmetricPairs = 0;
+        asymmetryCounted = !isDirected;
+        refreshMetadata();
+    }
+
+    // Undirected graphs count both directions of an edge but not self-loops.
+    void Graph::refreshMetadata() {
+        if (asymmetryCounted) isDirected = asymmetricPairs > 0;
+        numOfEdges = static_cast<int>(isDirected ? nonZeroEntries : nonZeroEntries - selfLoops);
+    }
+
+    int Graph::getWeight(size_t from, size_t to) const {
+        if (!originalIds.empty()) return storedWeight(internalIds[from], internalIds[to]);
+        return storedWeight(from, to);
+    }
+
+    int Graph::storedWeight(size_t from, size_t to) const {
+        GraphView g = storageView();
+        if (storage == Storage::Sparse) return g.sparseView().weight(from, to);
+        if (storage == Storage::Bitset) return g.bitsetView().hasEdge(from, to) ? 1 : 0;
+        if (storage == Storage::Compressed) return g.compressedView().weight(from, to);
+        return g.denseView().weight(from, to);
+    }
+
+    void Graph::checkVertex(size_t v) const {
+        if (v >= numOfVertices) {
+            throw invalid_argument("Invalid vertex: The vertex is not in the graph.");
+        }
+    }
+
+    void Graph::checkBitsetWeight(int weight) const {
+        if (storage == Storage::Bitset && weight < 0) {
+            throw invalid_argument("Invalid weight: Bitset storage cannot hold a negative weight.");
+        }
+    }
+
+    void Graph::addEdge(size_t from, size_t to, int weight) {
+        checkVertex(from);
+        checkVertex(to);
+        if (weight == 0) {
+            throw invalid_argument("Invalid edge: The weight must be non-zero.");
+        }
+        if (getWeight(from, to) != 0) {
+            throw invalid_argument("Invalid edge: The edge already exists.");
+        }
+        setWeight(from, to, weight);
+    }
+
+    void Graph::removeEdge(size_t from, size_t to) {
+        checkVertex(from);
+        checkVertex(to);
+        if (getWeight(from, to) == 0) {
+            throw invalid_argument("Invalid edge: The edge is not in the graph.");
+        }
+        setWeight(from, to, 0);
+    }
+
+    void Graph::setWeight(size_t from, size_t to, int weight) {
+        checkVertex(from);
+        checkVertex(to);
+        checkBitsetWeight(weight);
+        if (!originalIds.empty()) {
+            from = internalIds[from];
+            to = internalIds[to];
+        }
+        prepareMutation();
+        if (storage == Storage::Bitset) weight = weight != 0 ? 1 : 0;
+        int old = storedWeight(from, to);
+        if (old != weight) {
+            trackCell(from, to, old, weight, storedWeight(to, from));
+            storeCell(from, to, weight);
+            refreshMetadata();
+        }
+        finishMutation();
+    }
+
+    void Graph::applyUpdates(const vector<EdgeEntry>& requested) {
+        for (size_t k = 0; k < requested.size(); k++) {
+            checkVertex(requested[k].from);
+            checkVertex(requested[k].to);
+            checkBitsetWeight(requested[k].weight);
+        }
+        vector<EdgeEntry> translated;
+        if (!originalIds.empty()) {
+            translated = requested;
+            for (size_t k = 0; k < translated.size(); k++) {
+                translated[k].from = internalIds[translated[k].from];
+                translated[k].to = internalIds[translated[k].to];
+            }
+        }
+        const vector<EdgeEntry>& updates = originalIds.empty() ? requested : translated;
+        prepareMutation();
+        if (storage != Storage::Sparse) {
+            for (size_t k = 0; k < updates.size(); k++) {
+                const EdgeEntry& e = updates[k];
+                int weight = storage == Storage::Bitset ? (e.weight != 0 ? 1 : 0) : e.weight;
+                int old = storedWeight(e.from, e.to);
+                if (old == weight) continue;
+                trackCell(e.from, e.to, old, weight, storedWeight(e.to, e.from));
+                storeCell(e.from, e.to, weight);
+            }
+            refreshMetadata();
+            return;
+        }
+        // CSR: the updates are played against an ordered overlay, then merged
+        // into the rows at once instead of shifting the arrays per update.
+        map<pair<size_t, size_t>, int> pending;
+        for (size_t k = 0; k < updates.size(); k++) {
+            const EdgeEntry& e = updates[k];
+            map<pair<size_t, size_t>, int>::const_iterator cell = pending.find(make_pair(e.from, e.to));
+            map<pair<size_t, size_t>, int>::const_iterator mirror = pending.find(make_pair(e.to, e.from));
+            int old = cell != pending.end() ? cell->second : storedWeight(e.from, e.to);
+            if (old == e.weight) continue;
+            trackCell(e.from, e.to, old, e.weight, mirror != pending.end() ? mirror->second : storedWeight(e.to, e.from));
+            pending[make_pair(e.from, e.to)] = e.weight;
+        }
+        mergeSparseUpdates(pending);
+        refreshMetadata();
+        finishMutation();
+    }
+
+    // Every update takes a new version stamp. Mapped graphs are copied into owned
+    // storage, narrowed weights go back to int, and a directed graph gets its
+    // asymmetric pairs counted, before the first update. Compressed rows are
+    // unpacked into CSR for the update and packed again by finishMutation.
+    void Graph::prepareMutation() {
+        version = nextVersion();
+        detachMapping();
+        widenWeights();
+        if (storage == Storage::Compressed) {
+            expandRows();
+            expandedForUpdate = true;
+        }
+        if (!asymmetryCounted) countAsymmetricPairs();
+    }
+
+    void Graph::finishMutation() {
+        if (!expandedForUpdate) return;
+        expandedForUpdate = false;
+        compressRows();
+    }
+
+    // Packs the CSR arrays into compressed rows and frees them. The weights take
+    // the narrowest type that holds them all, or no bytes when every one is 1.
+    void Graph::compressRows() {
+        const size_t n = numOfVertices;
+        if (n > (size_t(1) << 31)) {
+            throw invalid_argument("Invalid graph: Compressed storage holds at most 2^31 vertices.");
+        }
+        int low = 0, high = 0;
+        bool unit = true;
+        for (size_t e = 0; e < edgeWeights.size(); e++) {
+            low = min(low, edgeWeights[e]);
+            high = max(high, edgeWeights[e]);
+            unit = unit && edgeWeights[e] == 1;
+        }
+        compressedType = narrowestType(low, high);
+        compressedWeighted = !unit;
+        vector<uint8_t> rows;
+        vector<size_t> starts(n + 1, 0);
+        vector<pair<size_t, int>> row;
+        for (size_t u = 0; u < n; u++) {
+            starts[u] = rows.size();
+            row.clear();
+            for (size_t e = rowOffsets[u]; e < rowOffsets[u + 1]; e++) row.push_back(make_pair(colIndices[e], edgeWeights[e]));
+            appendCompressedRow(rows, u, row, compressedType, compressedWeighted);
+        }
+        endCompressedRows(rows, starts);
+        compressedRows.swap(rows);
+        compressedStarts.swap(starts);
+        vector<size_t>().swap(rowOffsets);
+        vector<size_t>().swap(colIndices);
+        vector<int>().swap(edgeWeights);
+        storage = Storage::Compressed;
+    }
+
+    void Graph::expandRows() {
+        const CompressedView adj = storageView().compressedView();
+        rowOffsets.assign(numOfVertices + 1, 0);
+        colIndices.clear();
+        edgeWeights.clear();
+        for (size_t u = 0; u < numOfVertices; u++) {
+            for (CompressedView::Cursor it = adj.neighbors(u); it.valid(); it.next()) {
+                colIndices.push_back(it.target());
+                edgeWeights.push_back(it.weight());
+            }
+            rowOffsets[u + 1] = colIndices.size();
+        }
+        vector<uint8_t>().swap(compressedRows);
+        vector<size_t>().swap(compressedStarts);
+        storage = Storage::Sparse;
+    }
+
+    void Graph::detachMapping() {
+        if (!mappedFile) return;
+        GraphView g = view();
+        const size_t n = numOfVertices;
+        if (storage == Storage::Sparse) {
+            const SparseView& adj = g.sparseView();
+            rowOffsets.assign(n + 1, 0);
+            colIndices.clear();
+            edgeWeights.clear();
+            colIndices.reserve(mappedEntries);
+            edgeWeights.reserve(mappedEntries);
+            for (size_t u = 0; u < n; u++) {
+                for (SparseView::Cursor it = adj.neighbors(u); it.valid(); it.next()) {
+                    colIndices.push_back(it.target());
+                    edgeWeights.push_back(it.weight());
+                }
+                rowOffsets[u + 1] = colIndices.size();
+            }
+        } else {
+            FlatMatrix copy(n);
+            for (size_t u = 0; u < n; u++) memcpy(copy.row(u), g.denseView().row(u), n * sizeof(int));
+            matrixGraph.swap(copy);
+        }
+        mappedFile.reset();
+        mappedEntries = 0;
+        selfLoops = 0;
+        for (size_t u = 0; u < n; u++) selfLoops += static_cast<size_t>(storedWeight(u, u) != 0);
+        negativeEntries = 0;
+        if (storage == Storage::Sparse) {
+            negativeEntries = countNegative(edgeWeights.data(), edgeWeights.size());
+        } else {
+            for (size_t u = 0; u < n; u++) negativeEntries += countNegative(matrixGraph.row(u), n);
+        }
+        nonZeroEntries = isDirected ? static_cast<size_t>(numOfEdges) : static_cast<size_t>(numOfEdges) + selfLoops;
+        asymmetricPairs = 0;
+        asymmetryCounted = !isDirected;
+    }
+
+    // One full pass, paid once per directed graph. The dense matrix is walked in
+    // TILE x TILE blocks so both a cell and its mirror stay in cache.
+    void Graph::countAsymmetricPairs() {
+        const size_t n = numOfVertices;
+        asymmetricPairs = 0;
+        if (storage == Storage::Dense) {
+            for (size_t bi = 0; bi < n; bi += CLASSIFY_TILE) {
+                for (size_t bj = bi; bj < n; bj += CLASSIFY_TILE) {
+                    for (size_t i = bi; i < min(n, bi + CLASSIFY_TILE); i++) {
+                        const int* row = matrixGraph.row(i);
+                        for (size_t j = max(bj, i + 1); j < min(n, bj + CLASSIFY_TILE); j++) {
+                            asymmetricPairs += static_cast<size_t>(row[j] != matrixGraph.at(j, i));
                         }
                     }
                 }
             }
+        } else {
+            // A pair is asymmetric when its lower-to-higher entry differs from the
+            // mirror, or when only the higher-to-lower entry exists.
+            GraphView g = view();
+            for (size_t u = 0; u < n; u++) {
+                if (storage == Storage::Sparse) {
+                    for (SparseView::Cursor it = g.sparseView().neighbors(u); it.valid(); it.next()) {
+                        countAsymmetricEntry(u, it.target(), it.weight(), g.sparseView().weight(it.target(), u));
+                    }
+                } else {
+                    for (BitsetView::Cursor it = g.bitsetView().neighbors(u); it.valid(); it.next()) {
+                        countAsymmetricEntry(u, it.target(), 1, g.bitsetView().hasEdge(it.target(), u) ? 1 : 0);
+                    }
+                }
+            }
+        }
+        asymmetryCounted = true;
+    }
+
+    void Graph::countAsymmetricEntry(size_t from, size_t to, int weight, int mirrorWeight) {
+        if (from < to) {
+            asymmetricPairs += static_cast<size_t>(mirrorWeight != weight);
+        } else if (from > to) {
+            asymmetricPairs += static_cast<size_t>(mirrorWeight == 0);
+        }
+    }
+
+    void Graph::trackCell(size_t from, size_t to, int oldWeight, int newWeight, int mirrorWeight) {
+        if (oldWeight != 0) nonZeroEntries--;
+        if (newWeight != 0) nonZeroEntries++;
+        if (oldWeight < 0) negativeEntries--;
+        if (newWeight < 0) negativeEntries++;
+        if (from == to) {
+            if (oldWeight != 0) selfLoops--;
+            if (newWeight != 0) selfLoops++;
+        } else {
+            if (oldWeight != mirrorWeight) asymmetricPairs--;
+            if (newWeight != mirrorWeight) asymmetricPairs++;
+        }
+    }
+
+    void Graph::storeCell(size_t from, size_t to, int weight) {
+        if (storage == Storage::Dense) {
+            matrixGraph.at(from, to) = weight;
+        } else if (storage == Storage::Bitset) {
+            uint64_t mask = uint64_t(1) << (to % 64);
+            uint64_t& word = adjacencyBits[from * wordsPerRow + to / 64];
+            word = weight != 0 ? word | mask : word & ~mask;
+        } else {
+            vector<size_t>::iterator first = colIndices.begin() + static_cast<ptrdiff_t>(rowOffsets[from]);
+            vector<size_t>::iterator last = colIndices.begin() + static_cast<ptrdiff_t>(rowOffsets[from + 1]);
+            vector<size_t>::iterator it = lower_bound(first, last, to);
+            vector<int>::iterator weightIt = edgeWeights.begin() + (it - colIndices.begin());
+            if (it != last && *it == to) {
+                if (weight != 0) {
+                    *weightIt = weight;
+                    return;
+                }
+                colIndices.erase(it);
+                edgeWeights.erase(weightIt);
+                for (size_t u = from + 1; u <= numOfVertices; u++) rowOffsets[u]--;
+            } else {
+                colIndices.insert(it, to);
+                edgeWeights.insert(weightIt, weight);
+                for (size_t u = from + 1; u <= numOfVertices; u++) rowOffsets[u]++;
+            }
+        }
+    }
+
+    // pending is ordered by (row, column), so each touched row is a plain merge.
+    void Graph::mergeSparseUpdates(const map<pair<size_t, size_t>, int>& pending) {
+        if (pending.empty()) return;
+        vector<size_t> offsets(numOfVertices + 1, 0);
+        vector<size_t> cols;
+        vector<int> weights;
+        cols.reserve(colIndices.size() + pending.size());
+        weights.reserve(colIndices.size() + pending.size());
+        map<pair<size_t, size_t>, int>::const_iterator update = pending.begin();
+        for (size_t u = 0; u < numOfVertices; u++) {
+            size_t e = rowOffsets[u], last = rowOffsets[u + 1];
+            while (update != pending.end() && update->first.first == u) {
+                size_t v = update->first.second;
+                while (e < last && colIndices[e] < v) {
+                    cols.push_back(colIndices[e]);
+                    weights.push_back(edgeWeights[e++]);
+                }
+                if (e < last && colIndices[e] == v) e++;
+                if (update->second != 0) {
+                    cols.push_back(v);
+                    weights.push_back(update->second);
+                }
+                ++update;
+            }
+            cols.insert(cols.end(), colIndices.begin() + static_cast<ptrdiff_t>(e), colIndices.begin() + static_cast<ptrdiff_t>(last));
+            weights.insert(weights.end(), edgeWeights.begin() + static_cast<ptrdiff_t>(e), edgeWeights.begin() + static_cast<ptrdiff_t>(last));
+            offsets[u + 1] = cols.size();
+        }
+        rowOffsets.swap(offsets);
+        colIndices.swap(cols);
+        edgeWeights.swap(weights);
+    }
+
+    // Single blocked pass over the matrix: for every pair of TILE x TILE tiles
+    // (I, J) and (J, I) above the diagonal, the (J, I) tile is transposed into a
+    // small buffer so both sides are compared and counted with contiguous loads,
+    // which the compiler vectorizes. Once an asymmetric cell shows up the
+    // comparisons stop and the remaining tiles are only counted.
+    void Graph::classifyDense() {
+        const size_t n = numOfVertices;
+        size_t nonZero = 0, loops = 0, negatives = 0;
+        bool asymmetric = false;
+        vector<int> transposed(CLASSIFY_TILE * CLASSIFY_TILE);
+        for (size_t bi = 0; bi < n; bi += CLASSIFY_TILE) {
+            size_t ei = min(n, bi + CLASSIFY_TILE);
+            for (size_t i = bi; i < ei; i++) {
+                loops += static_cast<size_t>(matrixGraph.at(i, i) != 0);
+            }
+            for (size_t bj = bi; bj < n; bj += CLASSIFY_TILE) {
+                size_t ej = min(n, bj + CLASSIFY_TILE);
+                size_t width = ej - bj;
+                bool diagonalTile = bj == bi;
+                if (asymmetric) {
+                    for (size_t i = bi; i < ei; i++) {
+                        nonZero += countNonZero(matrixGraph.row(i) + bj, width);
+                        negatives += countNegative(matrixGraph.row(i) + bj, width);
+                    }
+                    if (!diagonalTile) {
+                        for (size_t j = bj; j < ej; j++) {
+                            nonZero += countNonZero(matrixGraph.row(j) + bi, ei - bi);
+                            negatives += countNegative(matrixGraph.row(j) + bi, ei - bi);
+                        }
+                    }
+                    continue;
+                }
+                for (size_t j = bj; j < ej; j++) {
+                    const int* row = matrixGraph.row(j);
+                    for (size_t i = bi; i < ei; i++) {
+                        transposed[(i - bi) * CLASSIFY_TILE + (j - bj)] = row[i];
+                    }
+                }
+                int diff = 0;
+                for (size_t i = bi; i < ei; i++) {
+                    const int* row = matrixGraph.row(i) + bj;
+                    const int* mirror = &transposed[(i - bi) * CLASSIFY_TILE];
+                    size_t count = 0, negative = 0;
+                    for (size_t k = 0; k < width; k++) {
+                        diff |= row[k] ^ mirror[k];
+                        count += static_cast<size_t>(row[k] != 0);
+                        negative += static_cast<size_t>(row[k] < 0);
+                    }
+                    if (!diagonalTile) {
+                        count += countNonZero(mirror, width);
+                        negative += countNegative(mirror, width);
+                    }
+                    nonZero += count;
+                    negatives += negative;
+                }
+                asymmetric = diff != 0;
+            }
+        }
+        isDirected = asymmetric;
+        nonZeroEntries = nonZero;
+        selfLoops = loops;
+        negativeEntries = negatives;
+    }
+
+    // Without weights the graph is undirected exactly when the bit pattern is
+    // symmetric. As in classifyDense, the check runs on tiles: every 64 x 64
+    // block on or above the diagonal is compared word by word with its mirror
+    // block transposed, so no column is walked bit by bit.
+    void Graph::classifyBitset() {
+        const size_t n = numOfVertices;
+        BitsetView bits(adjacencyBits.data(), wordsPerRow, n);
+        size_t nonZero = 0, loops = 0;
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t w = 0; w < wordsPerRow; ++w) {
+                nonZero += static_cast<size_t>(__builtin_popcountll(bits.row(i)[w]));
+            }
+            if (bits.hasEdge(i, i)) loops++;
+        }
+        bool asymmetric = false;
+        uint64_t mirror[64];
+        for (size_t bi = 0; bi < wordsPerRow && !asymmetric; bi++) {
+            size_t rows = min(size_t(64), n - bi * 64);
+            for (size_t bj = bi; bj < wordsPerRow && !asymmetric; bj++) {
+                size_t mirrorRows = min(size_t(64), n - bj * 64);
+                for (size_t r = 0; r < 64; r++) mirror[r] = r < mirrorRows ? bits.row(bj * 64 + r)[bi] : 0;
+                transposeBits(mirror);
+                for (size_t r = 0; r < rows; r++) {
+                    if (bits.row(bi * 64 + r)[bj] != mirror[r]) {
+                        asymmetric = true;
+                        break;
+                    }
+                }
+            }
         }
+        isDirected = asymmetric;
+        nonZeroEntries = nonZero;
+        selfLoops = loops;
+        negativeEntries = 0;
+    }
+
+    void Graph::reorder(VertexOrder order) {
+        if (numOfVertices == 0) return;
+        reorder(vertexOrder(storageView(), order));
+    }
+
+    // Gathers every row into its new place, with the columns renumbered, in
+    // whichever storage the graph uses. The counters that drive numOfEdges and
+    // isDirected do not depend on the numbering and are kept.
+    void Graph::reorder(const vector<size_t>& order) {
+        const size_t n = numOfVertices;
+        const size_t NONE = numeric_limits<size_t>::max();
+        if (order.size() != n) {
+            throw invalid_argument("Invalid order: The order is not a permutation of the vertices.");
+        }
+        vector<size_t> position(n, NONE);
+        for (size_t k = 0; k < n; k++) {
+            if (order[k] >= n || position[order[k]] != NONE) {
+                throw invalid_argument("Invalid order: The order is not a permutation of the vertices.");
+            }
+            position[order[k]] = k;
+        }
+        version = nextVersion();
+        detachMapping();
+        WeightType narrowed = weightType;
+        widenWeights();
+        if (storage == Storage::Sparse) {
+            vector<size_t> offsets(n + 1, 0), cols(colIndices.size());
+            vector<int> weights(edgeWeights.size());
+            vector<pair<size_t, int>> row;
+            for (size_t i = 0; i < n; i++) {
+                row.clear();
+                for (size_t e = rowOffsets[order[i]]; e < rowOffsets[order[i] + 1]; e++) {
+                    row.push_back(make_pair(position[colIndices[e]], edgeWeights[e]));
+                }
+                sort(row.begin(), row.end());
+                offsets[i + 1] = offsets[i] + row.size();
+                for (size_t k = 0; k < row.size(); k++) {
+                    cols[offsets[i] + k] = row[k].first;
+                    weights[offsets[i] + k] = row[k].second;
+                }
+            }
+            rowOffsets.swap(offsets);
+            colIndices.swap(cols);
+            edgeWeights.swap(weights);
+        } else if (storage == Storage::Compressed) {
+            // Decoded and re-packed row by row, so the rows never exist as CSR.
+            const CompressedView adj = storageView().compressedView();
+            vector<uint8_t> rows;
+            rows.reserve(compressedRows.size());
+            vector<size_t> starts(n + 1, 0);
+            vector<pair<size_t, int>> row;
+            for (size_t i = 0; i < n; i++) {
+                starts[i] = rows.size();
+                row.clear();
+                for (CompressedView::Cursor it = adj.neighbors(order[i]); it.valid(); it.next()) {
+                    row.push_back(make_pair(position[it.target()], it.weight()));
+                }
+                sort(row.begin(), row.end());
+                appendCompressedRow(rows, i, row, compressedType, compressedWeighted);
+            }
+            endCompressedRows(rows, starts);
+            compressedRows.swap(rows);
+            compressedStarts.swap(starts);
+        } else if (storage == Storage::Bitset) {
+            BitsetView bits(adjacencyBits.data(), wordsPerRow, n);
+            vector<uint64_t> next(adjacencyBits.size(), 0);
+            for (size_t i = 0; i < n; i++) {
+                uint64_t* row = &next[i * wordsPerRow];
+                for (BitsetView::Cursor it = bits.neighbors(order[i]); it.valid(); it.next()) {
+                    row[position[it.target()] / 64] |= uint64_t(1) << (position[it.target()] % 64);
+                }
+            }
+            adjacencyBits.swap(next);
+        } else {
+            FlatMatrix next(n);
+            for (size_t i = 0; i < n; i++) {
+                const int* cells = matrixGraph.row(order[i]);
+                int* target = next.row(i);
+                for (size_t j = 0; j < n; j++) target[j] = cells[order[j]];
+            }
+            matrixGraph.swap(next);
+        }
+        vector<size_t> original(n);
+        for (size_t i = 0; i < n; i++) original[i] = originalIds.empty() ? order[i] : originalIds[order[i]];
+        originalIds.swap(original);
+        internalIds.assign(n, 0);
+        for (size_t i = 0; i < n; i++) internalIds[originalIds[i]] = i;
+        narrowWeights(narrowed);
+    }
+
+    bool Graph::isReordered() const {
+        return !originalIds.empty();
+    }
+
+    size_t Graph::originalId(size_t v) const {
+        checkVertex(v);
+        return originalIds.empty() ? v : originalIds[v];
+    }
+
+    size_t Graph::internalId(size_t v) const {
+        checkVertex(v);
+        return internalIds.empty() ? v : internalIds[v];
     }
 
     void Graph::printGraph(){
-        cout << "Graph with " << matrixGraph.size() << " vertices and " << numOfEdges << " edges";
+        cout << "Graph with " << numOfVertices << " vertices and " << numOfEdges << " edges";
         cout << (isDirected ? " (Directed)." : " (Undirected).") << endl;
     }
-    vector<vector<int>>& Graph::getMatrixGraph(){
-        return matrixGraph;
+
+    vector<vector<int>> Graph::getMatrixGraph() const {
+        if (storage != Storage::Dense) {
+            throw logic_error("The graph is not stored as a dense matrix.");
+        }
+        if (!mappedFile && originalIds.empty() && weightType == WeightType::Int32) return matrixGraph.toVectors();
+        DenseView dense = storageView().denseView();
+        vector<vector<int>> matrix(numOfVertices, vector<int>(numOfVertices));
+        for (size_t i = 0; i < numOfVertices; i++) {
+            vector<int>& target = matrix[originalIds.empty() ? i : originalIds[i]];
+            for (size_t j = 0; j < numOfVertices; j++) target[originalIds.empty() ? j : originalIds[j]] = dense.weight(i, j);
+        }
+        return matrix;
+    }
+
+    const int* Graph::row(size_t u) const {
+        if (storage != Storage::Dense) {
+            throw logic_error("The graph is not stored as a dense matrix.");
+        }
+        if (weightType != WeightType::Int32) {
+            throw logic_error("The weights are stored narrower than int.");
+        }
+        return view().denseView().row(u);
+    }
+
+    size_t Graph::getRowStride() const {
+        if (storage != Storage::Dense) {
+            throw logic_error("The graph is not stored as a dense matrix.");
+        }
+        if (weightType != WeightType::Int32) {
+            throw logic_error("The weights are stored narrower than int.");
+        }
+        return view().denseView().rowStride();
+    }
+
+    Storage Graph::getStorage() const {
+        return storage;
+    }
+
+    size_t Graph::getNumOfVertices() const {
+        return numOfVertices;
+    }
+
+    const vector<size_t>& Graph::getRowOffsets() const {
+        return rowOffsets;
+    }
+
+    const vector<size_t>& Graph::getColIndices() const {
+        return colIndices;
+    }
+
+    const vector<int>& Graph::getEdgeWeights() const {
+        if (weightType != WeightType::Int32) {
+            throw logic_error("The weights are stored narrower than int.");
+        }
+        return edgeWeights;
+    }
+
+    void Graph::narrowWeights(WeightType type) {
+        if (storage == Storage::Bitset || storage == Storage::Compressed || numOfVertices == 0) return;
+        detachMapping();
+        widenWeights();
+        const int* cells = storage == Storage::Sparse ? edgeWeights.data() : matrixGraph.data();
+        const size_t count = storage == Storage::Sparse ? edgeWeights.size() : numOfVertices * matrixGraph.rowStride();
+        int low = 0, high = 0;
+        for (size_t k = 0; k < count; k++) {
+            low = min(low, cells[k]);
+            high = max(high, cells[k]);
+        }
+        const WeightType fits = narrowestType(low, high);
+        if (type == WeightType::Auto) type = fits;
+        if (static_cast<int>(type) < static_cast<int>(fits)) {
+            throw invalid_argument("Invalid weight type: A weight does not fit in the requested type.");
+        }
+        if (type == WeightType::Int32) return;
+        if (storage == Storage::Sparse) {
+            if (type == WeightType::UInt8) {
+                weights8 = narrowCells<uint8_t>(edgeWeights.data(), 1, 0, edgeWeights.size(), edgeWeights.size());
+            } else {
+                weights16 = narrowCells<int16_t>(edgeWeights.data(), 1, 0, edgeWeights.size(), edgeWeights.size());
+            }
+            vector<int>().swap(edgeWeights);
+        } else {
+            const size_t cellsPerLine = CACHE_LINE / (type == WeightType::UInt8 ? sizeof(uint8_t) : sizeof(int16_t));
+            compactStride = (numOfVertices + cellsPerLine - 1) / cellsPerLine * cellsPerLine;
+            if (type == WeightType::UInt8) {
+                weights8 = narrowCells<uint8_t>(matrixGraph.data(), numOfVertices, matrixGraph.rowStride(), numOfVertices, compactStride);
+            } else {
+                weights16 = narrowCells<int16_t>(matrixGraph.data(), numOfVertices, matrixGraph.rowStride(), numOfVertices, compactStride);
+            }
+            matrixGraph = FlatMatrix();
+        }
+        // Same contents, so the version stamp (and the cached answers) stay.
+        weightType = type;
+    }
+
+    void Graph::widenWeights() {
+        if (weightType == WeightType::Int32) return;
+        GraphView g = storageView();
+        if (storage == Storage::Sparse) {
+            edgeWeights.resize(colIndices.size());
+            for (size_t e = 0; e < edgeWeights.size(); e++) {
+                edgeWeights[e] = weightType == WeightType::UInt8 ? weights8[e] : weights16[e];
+            }
+        } else {
+            FlatMatrix wide(numOfVertices);
+            for (size_t i = 0; i < numOfVertices; i++) {
+                for (size_t j = 0; j < numOfVertices; j++) wide.at(i, j) = g.denseView().weight(i, j);
+            }
+            matrixGraph.swap(wide);
+        }
+        weightType = WeightType::Int32;
+        vector<uint8_t>().swap(weights8);
+        vector<int16_t>().swap(weights16);
+        compactStride = 0;
+    }
+
+    WeightType Graph::getWeightType() const {
+        return storage == Storage::Compressed ? compressedType : weightType;
+    }
+
+    size_t Graph::getStorageBytes() const {
+        if (mappedFile) return mappedFile->size() - sizeof(GraphFileHeader);
+        return matrixGraph.size() * matrixGraph.rowStride() * sizeof(int) + rowOffsets.size() * sizeof(size_t) +
+               colIndices.size() * sizeof(size_t) + edgeWeights.size() * sizeof(int) + adjacencyBits.size() * sizeof(uint64_t) +
+               weights8.size() + weights16.size() * sizeof(int16_t) + compressedRows.size() + compressedStarts.size() * sizeof(size_t);
+    }
+
+    GraphView Graph::view() const {
+        GraphView g = storageView();
+        if (!originalIds.empty()) g.setOrder(originalIds.data(), internalIds.data());
+        return g;
+    }
+
+    GraphView Graph::storageView() const {
+        if (mappedFile) {
+            const char* payload = mappedFile->data() + sizeof(GraphFileHeader);
+            if (storage == Storage::Sparse) {
+                const size_t* offsets = reinterpret_cast<const size_t*>(payload);
+                const size_t* cols = offsets + numOfVertices + 1;
+                const int* weights = reinterpret_cast<const int*>(cols + mappedEntries);
+                return GraphView(SparseView(offsets, cols, weights, numOfVertices), isDirected, negativeEntries > 0, version);
+            }
+            return GraphView(DenseView(reinterpret_cast<const int*>(payload), mappedEntries, numOfVertices), isDirected, negativeEntries > 0, version);
+        }
+        const void* narrow = weightType == WeightType::UInt8 ? static_cast<const void*>(weights8.data()) : static_cast<const void*>(weights16.data());
+        if (storage == Storage::Sparse) {
+            if (weightType != WeightType::Int32) {
+                return GraphView(SparseView(rowOffsets.data(), colIndices.data(), narrow, weightType, numOfVertices), isDirected, negativeEntries > 0, version);
+            }
+            return GraphView(SparseView(rowOffsets.data(), colIndices.data(), edgeWeights.data(), numOfVertices), isDirected, negativeEntries > 0, version);
+        }
+        if (storage == Storage::Compressed) {
+            return GraphView(CompressedView(compressedRows.data(), compressedStarts.data(), compressedType, compressedWeighted, numOfVertices),
+                             isDirected, negativeEntries > 0, version);
+        }
+        if (storage == Storage::Bitset) {
+            return GraphView(BitsetView(adjacencyBits.data(), wordsPerRow, numOfVertices), isDirected, version);
+        }
+        if (weightType != WeightType::Int32) {
+            return GraphView(DenseView(narrow, weightType, compactStride, numOfVertices), isDirected, negativeEntries > 0, version);
+        }
+        return GraphView(DenseView(matrixGraph.data(), matrixGraph.rowStride(), numOfVertices), isDirected, negativeEntries > 0, version);
     }
 }
@@ -1,5 +1,13 @@
 #pragma once
 
+#include "EdgeList.hpp"
+#include "FlatMatrix.hpp"
+#include "GraphFile.hpp"
+#include "GraphView.hpp"
+#include "Reordering.hpp"
+#include <map>
+#include <memory>
+#include <string>
 #include <vector>
 #include <iostream>
 using namespace std;
@@ -7,16 +15,144 @@ using namespace std;
 namespace ariel {
     class Graph {
         private:
-            vector<vector<int>> matrixGraph;
+            FlatMatrix matrixGraph;
+            vector<size_t> rowOffsets;
+            vector<size_t> colIndices;
+            vector<int> edgeWeights;
+            vector<uint64_t> adjacencyBits;
+            size_t wordsPerRow;
+            size_t numOfVertices;
             int numOfEdges;
-            bool isDirected; 
+            bool isDirected;
+            Storage storage;
+            shared_ptr<const MappedFile> mappedFile;  // set by openGraph; copies of the Graph share it
+            size_t mappedEntries;                      // header entries field of the mapped file
+            // Kept up to date by the mutation API. isDirected is asymmetricPairs > 0
+            // once the pairs of a directed graph have been counted.
+            size_t nonZeroEntries;
+            size_t selfLoops;
+            size_t negativeEntries;                    // for a mapped graph: non-zero when the header says so
+            size_t asymmetricPairs;                    // pairs u < v whose two cells differ
+            bool asymmetryCounted;
+            uint64_t version;                          // see getVersion
+            // Set by narrowWeights: the dense cells (compactStride per row) or the CSR
+            // weights in weightType; matrixGraph / edgeWeights are then empty.
+            WeightType weightType;
+            vector<uint8_t> weights8;
+            vector<int16_t> weights16;
+            size_t compactStride;
+            // Storage::Compressed: row u starts at compressedRows[compressedStarts[u]], in
+            // the CompressedView layout, with its weights in compressedType unless all
+            // of them are 1. An update works on CSR arrays in between (expandedForUpdate).
+            vector<uint8_t> compressedRows;
+            vector<size_t> compressedStarts;
+            WeightType compressedType;
+            bool compressedWeighted;
+            bool expandedForUpdate;
+            // Set by reorder: originalIds[internal] and internalIds[original]; empty otherwise.
+            vector<size_t> originalIds;
+            vector<size_t> internalIds;
+
+            void buildSparse(const vector<vector<int>>& matrix);
+            bool hasSparseEdge(size_t from, size_t to, int weight) const;
+            void buildBitset(const vector<vector<int>>& matrix);
+            void clearStorage();
+            void classifyDense();
+            void classifyBitset();
+            bool buildSparseFromEdges(vector<EdgeChunk>& chunks, size_t threads, size_t& entries, size_t& loops);
+            bool buildCellsFromEdges(const vector<EdgeChunk>& chunks, size_t& entries, size_t& loops, size_t& negatives);
+            bool hasAsymmetricEntry(const vector<EdgeChunk>& chunks, size_t threads) const;
+            void refreshMetadata();
+            void prepareMutation();
+            void finishMutation();
+            void compressRows();
+            void expandRows();
+            void detachMapping();
+            void countAsymmetricPairs();
+            void countAsymmetricEntry(size_t from, size_t to, int weight, int mirrorWeight);
+            void checkVertex(size_t v) const;
+            void checkBitsetWeight(int weight) const;
+            void trackCell(size_t from, size_t to, int oldWeight, int newWeight, int mirrorWeight);
+            void storeCell(size_t from, size_t to, int weight);
+            void mergeSparseUpdates(const map<pair<size_t, size_t>, int>& pending);
+            int storedWeight(size_t from, size_t to) const;
+            void widenWeights();
+            GraphView storageView() const;
 
         public:
             Graph();
-            void loadGraph(vector<vector<int>>& matrix);
+            // Storage::Bitset has no sign bit, so it throws invalid_argument on a
+            // negative weight, as do loadEdgeList and the updates below.
+            void loadGraph(vector<vector<int>>& matrix, Storage mode = Storage::Dense);
+            // Storage::Compressed builds the CSR rows first and then packs them.
+            // Reads a `u v w` edge-list text file (see EdgeList.hpp) straight into
+            // the requested storage. The file is parsed in parallel chunks and the
+            // edge count and directedness come out of the build, without classifyGraph.
+            // The vertex count is one more than the largest id in the file.
+            void loadEdgeList(const string& path, Storage mode = Storage::Sparse, size_t threads = 0);
+            // Maps a file written by saveGraph. Nothing is parsed or copied: the
+            // views point into the mapping and the metadata comes from the header.
+            void openGraph(const string& path);
+            // Dense graphs are written as a dense payload, the other storages as CSR.
+            // A reordered graph is written in its new ids.
+            void saveGraph(const string& path) const;
+            // Renumbers the vertices so that the ones traversed together sit together
+            // in memory, and keeps the mapping: the edge API below, getMatrixGraph, the
+            // Algorithms functions and the classes built from a view (PathSearch,
+            // ConnectedComponents, ...) keep taking and returning the loaded ids, while
+            // row, the CSR arrays and the views see the new ones. Calls compose; the
+            // next load drops the mapping.
+            void reorder(VertexOrder order);
+            // order[newId] = current id; throws invalid_argument unless it is a permutation.
+            void reorder(const vector<size_t>& order);
+            bool isReordered() const;
+            // Stores the weights of a Dense or Sparse graph in the narrowest WeightType
+            // that holds them all (Auto), or in the given one, for a quarter or half
+            // of the weight bytes. Throws invalid_argument when a weight does not fit.
+            // Algorithms read them widened to int. Mutations and saveGraph go back to
+            // Int32 first; row, getRowStride and getEdgeWeights need Int32 and throw
+            // logic_error otherwise. Bitset graphs have no weights and Compressed ones
+            // already hold the narrowest type, so both are left alone.
+            void narrowWeights(WeightType type = WeightType::Auto);
+            WeightType getWeightType() const;
+            // Bytes held by the adjacency arrays (a mapped file counts as its payload).
+            size_t getStorageBytes() const;
+            size_t originalId(size_t v) const;  // loaded id of internal vertex v
+            size_t internalId(size_t v) const;  // internal id of loaded vertex v
+            // Single-cell updates that keep numOfEdges and isDirected current in O(1)
+            // (plus the row shift on CSR, and re-packing every row when Compressed,
+            // so batch those through applyUpdates). The first update of a directed graph
+            // counts its asymmetric pairs once; a mapped graph is copied first.
+            // Like loadGraph, cells are directed: an undirected edge is two calls.
+            void addEdge(size_t from, size_t to, int weight);
+            void removeEdge(size_t from, size_t to);
+            void setWeight(size_t from, size_t to, int weight);  // 0 removes the edge
+            // Applies setWeight for each entry in order; CSR rows are merged in one pass.
+            void applyUpdates(const vector<EdgeEntry>& updates);
+            int getWeight(size_t from, size_t to) const;  // 0 when there is no edge
             void printGraph();
             void classifyGraph();
-            bool getIsDirected(); 
-            vector<vector<int>>& getMatrixGraph();
+            bool getIsDirected() const;
+            // True while some cell holds a negative weight; kept current like numOfEdges.
+            bool hasNegativeWeights() const;
+            // Stamp of the current contents, drawn from a process-wide counter by every
+            // load and mutation. Equal stamps mean equal contents (a copy keeps the
+            // stamp of its source), so Algorithms can cache answers under it.
+            uint64_t getVersion() const;
+            int getNumOfEdges() const;
+            // Copy of the dense matrix as rows; the algorithms read it in place through view().
+            vector<vector<int>> getMatrixGraph() const;
+            // Row u of a dense graph, padded to getRowStride() cells; both throw
+            // logic_error on the other storages, like getMatrixGraph.
+            const int* row(size_t u) const;
+            size_t getRowStride() const;
+            Storage getStorage() const;
+            size_t getNumOfVertices() const;
+            // The CSR arrays of a graph built by loadGraph; mapped graphs are read through view().
+            const vector<size_t>& getRowOffsets() const;
+            const vector<size_t>& getColIndices() const;
+            const vector<int>& getEdgeWeights() const;
+            GraphView view() const;
+            operator GraphView() const { return view(); }
         };
-}
\ No newline at end of file
+}
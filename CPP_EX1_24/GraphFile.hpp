@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+using namespace std;
+
+namespace ariel {
+    // Binary graph file, native byte order:
+    //   GraphFileHeader (64 bytes)
+    //   Dense:  numOfVertices rows of rowStride int32 cells (padding cells are zero)
+    //   Sparse: (numOfVertices + 1) uint64 row offsets, entries uint64 column
+    //           indices, entries int32 weights
+    // The payload starts 64 bytes into the file, so a mapped dense file keeps
+    // the same 64-byte row alignment as FlatMatrix.
+    struct GraphFileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t layout;        // static_cast<uint32_t>(Storage::Dense or Storage::Sparse)
+        uint64_t numOfVertices;
+        uint64_t numOfEdges;
+        uint64_t entries;       // Dense: row stride in cells; Sparse: stored (non-zero) entries
+        uint32_t isDirected;
+        uint32_t hasNegativeWeights;   // version 2 on; version 1 files are scanned on open
+        uint32_t reserved[4];
+    };
+    static_assert(sizeof(GraphFileHeader) == 64, "graph file header must stay 64 bytes");
+    static_assert(sizeof(size_t) == sizeof(uint64_t), "CSR payload is mapped as size_t");
+
+    const char GRAPH_FILE_MAGIC[8] = {'A', 'R', 'G', 'R', 'A', 'P', 'H', '\0'};
+    const uint32_t GRAPH_FILE_VERSION = 2;
+
+    // Read-only private mapping of a whole file. Pages are faulted in on first
+    // touch, so opening costs the same for any file size.
+    class MappedFile {
+        private:
+            const char* base;
+            size_t length;
+
+        public:
+            explicit MappedFile(const string& path) : base(nullptr), length(0) {
+                int fd = open(path.c_str(), O_RDONLY);
+                if (fd < 0) {
+                    throw runtime_error("Cannot open graph file: " + path);
+                }
+                struct stat info;
+                if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+                    close(fd);
+                    throw invalid_argument("Invalid graph file: " + path);
+                }
+                length = static_cast<size_t>(info.st_size);
+                void* memory = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+                close(fd);
+                if (memory == MAP_FAILED) {
+                    throw runtime_error("Cannot map graph file: " + path);
+                }
+                base = static_cast<const char*>(memory);
+            }
+
+            MappedFile(const MappedFile&) = delete;
+            MappedFile& operator=(const MappedFile&) = delete;
+
+            ~MappedFile() { munmap(const_cast<char*>(base), length); }
+
+            const char* data() const { return base; }
+            size_t size() const { return length; }
+    };
+}
@@ -0,0 +1,329 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+using namespace std;
+
+namespace ariel {
+    // Dense keeps the full adjacency matrix, Sparse keeps a CSR layout
+    // (row offsets + column indices + weights) holding only the non-zero cells,
+    // Bitset keeps one bit per cell (64 vertices per word) and drops the weights,
+    // Compressed keeps each CSR row gap-encoded in a byte stream (CompressedView).
+    enum class Storage { Dense, Sparse, Bitset, Compressed };
+
+    // Width of the stored weights of a Dense or Sparse graph (Graph::narrowWeights).
+    // Auto only appears in a request: it picks the narrowest width that fits.
+    enum class WeightType { Auto, UInt8, Int16, Int32 };
+
+    // Reads cell k of an array of the given width, widened to int.
+    inline int readWeight(const void* cells, WeightType type, size_t k) {
+        switch (type) {
+            case WeightType::UInt8: return static_cast<const uint8_t*>(cells)[k];
+            case WeightType::Int16: return static_cast<const int16_t*>(cells)[k];
+            default: return static_cast<const int*>(cells)[k];
+        }
+    }
+
+    // Non-owning, read-only views over a Graph's storage. They hold plain
+    // pointers into the Graph (a dense view is a base pointer plus row stride), so handing one out never copies the matrix and
+    // any number of threads can read through views of the same const Graph.
+    // A view stays valid until the Graph it came from is reloaded or destroyed.
+    //
+    // Every view type hands out a cursor over the non-zero cells of a row, so an
+    // algorithm written once against a cursor costs O(V^2) on a dense matrix,
+    // O(V+E) on a CSR graph or compressed rows and O(V^2/64 + E) on a bitset. Cursors read weights
+    // of any WeightType and hand them out as int, so distances always sum in a
+    // type at least as wide as the stored weights.
+    class DenseView {
+        private:
+            const void* cells;
+            WeightType type;
+            size_t stride;
+            size_t n;
+
+            size_t cellBytes() const {
+                return type == WeightType::UInt8 ? 1 : type == WeightType::Int16 ? sizeof(int16_t) : sizeof(int);
+            }
+
+        public:
+            class Cursor {
+                private:
+                    const void* row;
+                    WeightType type;
+                    size_t col;
+                    size_t n;
+                    template <typename Cell>
+                    void skipZerosIn(const Cell* cells) {
+                        while (col < n && cells[col] == 0) col++;
+                    }
+                    void skipZeros() {
+                        switch (type) {
+                            case WeightType::UInt8: skipZerosIn(static_cast<const uint8_t*>(row)); break;
+                            case WeightType::Int16: skipZerosIn(static_cast<const int16_t*>(row)); break;
+                            default: skipZerosIn(static_cast<const int*>(row));
+                        }
+                    }
+
+                public:
+                    Cursor(const void* r, WeightType cellType, size_t size) : row(r), type(cellType), col(0), n(size) { skipZeros(); }
+                    bool valid() const { return col < n; }
+                    void next() { col++; skipZeros(); }
+                    size_t target() const { return col; }
+                    int weight() const { return readWeight(row, type, col); }
+            };
+
+            DenseView() : cells(nullptr), type(WeightType::Int32), stride(0), n(0) {}
+            DenseView(const int* firstCell, size_t rowStride, size_t size) : cells(firstCell), type(WeightType::Int32), stride(rowStride), n(size) {}
+            DenseView(const void* firstCell, WeightType cellType, size_t rowStride, size_t size)
+                : cells(firstCell), type(cellType), stride(rowStride), n(size) {}
+            size_t size() const { return n; }
+            size_t rowStride() const { return stride; }
+            WeightType weightType() const { return type; }
+            // Int32 cells only; the other widths are read through weight and the cursors.
+            const int* row(size_t u) const { return static_cast<const int*>(cells) + u * stride; }
+            int weight(size_t u, size_t v) const { return readWeight(cells, type, u * stride + v); }
+            Cursor neighbors(size_t u) const {
+                return Cursor(static_cast<const char*>(cells) + u * stride * cellBytes(), type, n);
+            }
+    };
+
+    class SparseView {
+        private:
+            const size_t* offsets;
+            const size_t* cols;
+            const void* weights;
+            WeightType type;
+            size_t n;
+
+        public:
+            class Cursor {
+                private:
+                    const size_t* cols;
+                    const void* weights;
+                    WeightType type;
+                    size_t e;
+                    size_t last;
+
+                public:
+                    Cursor(const size_t* c, const void* w, WeightType weightType, size_t first, size_t end)
+                        : cols(c), weights(w), type(weightType), e(first), last(end) {}
+                    bool valid() const { return e < last; }
+                    void next() { e++; }
+                    size_t target() const { return cols[e]; }
+                    int weight() const { return readWeight(weights, type, e); }
+            };
+
+            SparseView() : offsets(nullptr), cols(nullptr), weights(nullptr), type(WeightType::Int32), n(0) {}
+            SparseView(const size_t* rowOffsets, const size_t* colIndices, const int* edgeWeights, size_t size)
+                : offsets(rowOffsets), cols(colIndices), weights(edgeWeights), type(WeightType::Int32), n(size) {}
+            SparseView(const size_t* rowOffsets, const size_t* colIndices, const void* edgeWeights, WeightType weightType, size_t size)
+                : offsets(rowOffsets), cols(colIndices), weights(edgeWeights), type(weightType), n(size) {}
+            size_t size() const { return n; }
+            WeightType weightType() const { return type; }
+            size_t degree(size_t u) const { return offsets[u + 1] - offsets[u]; }
+            // Columns are ascending within a row, so a lookup is a binary search; 0 if absent.
+            int weight(size_t u, size_t v) const {
+                const size_t* last = cols + offsets[u + 1];
+                const size_t* it = lower_bound(cols + offsets[u], last, v);
+                return it != last && *it == v ? readWeight(weights, type, static_cast<size_t>(it - cols)) : 0;
+            }
+            Cursor neighbors(size_t u) const { return Cursor(cols, weights, type, offsets[u], offsets[u + 1]); }
+    };
+
+    // Unweighted adjacency rows of wordsPerRow 64-bit words each. Every edge
+    // reads back with weight 1.
+    class BitsetView {
+        private:
+            const uint64_t* words;
+            size_t stride;
+            size_t n;
+
+        public:
+            class Cursor {
+                private:
+                    const uint64_t* row;
+                    size_t wordCount;
+                    size_t word;
+                    uint64_t pending;
+                    void skipEmpty() {
+                        while (pending == 0 && ++word < wordCount) pending = row[word];
+                    }
+
+                public:
+                    Cursor(const uint64_t* r, size_t count) : row(r), wordCount(count), word(0), pending(count > 0 ? r[0] : 0) { skipEmpty(); }
+                    bool valid() const { return pending != 0; }
+                    void next() { pending &= pending - 1; skipEmpty(); }
+                    size_t target() const { return word * 64 + static_cast<size_t>(__builtin_ctzll(pending)); }
+                    int weight() const { return 1; }
+            };
+
+            BitsetView() : words(nullptr), stride(0), n(0) {}
+            BitsetView(const uint64_t* bits, size_t wordsPerRow, size_t size) : words(bits), stride(wordsPerRow), n(size) {}
+            size_t size() const { return n; }
+            size_t wordsPerRow() const { return stride; }
+            const uint64_t* row(size_t u) const { return words + u * stride; }
+            bool hasEdge(size_t u, size_t v) const { return (row(u)[v / 64] >> (v % 64)) & 1; }
+            Cursor neighbors(size_t u) const { return Cursor(row(u), stride); }
+    };
+
+    // CSR rows packed into one byte stream, row u starting at starts[u]:
+    // - the degree d as a LEB128 varint;
+    // - unless every weight is 1, the d weights in the row's WeightType;
+    // - ceil(d / 4) control bytes, 2 bits per target giving its byte length - 1;
+    // - the d gaps, 1 to 4 little-endian bytes each. The first is the distance
+    //   from u itself, zigzag-encoded; the rest are differences between
+    //   consecutive (ascending) targets.
+    // This is the stream-vbyte layout, with the controls kept apart from the data
+    // so a cursor decodes a gap with one masked 4-byte load and no branches on
+    // its length. The stream ends with 3 spare bytes for the last load. Gaps are
+    // 32-bit, so the vertex count is at most 2^31.
+    class CompressedView {
+        private:
+            const uint8_t* bytes;
+            const size_t* starts;
+            WeightType type;
+            bool weighted;
+            size_t n;
+
+            size_t cellBytes() const {
+                return type == WeightType::UInt8 ? 1 : type == WeightType::Int16 ? sizeof(int16_t) : sizeof(int);
+            }
+            static size_t readDegree(const uint8_t*& p) {
+                size_t degree = 0;
+                for (unsigned shift = 0;; shift += 7) {
+                    degree |= static_cast<size_t>(*p & 0x7F) << shift;
+                    if ((*p++ & 0x80) == 0) return degree;
+                }
+            }
+
+        public:
+            class Cursor {
+                private:
+                    const uint8_t* control;
+                    const uint8_t* data;
+                    const uint8_t* weights;  // null when every weight is 1
+                    WeightType type;
+                    size_t e;
+                    size_t count;
+                    size_t current;
+                    uint32_t decodeGap() {
+                        unsigned key = static_cast<unsigned>(control[e / 4] >> (e % 4 * 2)) & 3;
+                        uint32_t gap;
+                        memcpy(&gap, data, sizeof(gap));
+                        data += key + 1;
+                        return gap & (0xFFFFFFFFu >> (8 * (3 - key)));
+                    }
+
+                public:
+                    Cursor(const uint8_t* controls, const uint8_t* w, WeightType weightType, size_t degree, size_t u)
+                        : control(controls), data(controls + (degree + 3) / 4), weights(w), type(weightType), e(0), count(degree), current(u) {
+                        if (count == 0) return;
+                        uint32_t gap = decodeGap();
+                        current += static_cast<size_t>(static_cast<int64_t>(gap >> 1) ^ -static_cast<int64_t>(gap & 1));
+                    }
+                    bool valid() const { return e < count; }
+                    void next() {
+                        if (++e < count) current += decodeGap();
+                    }
+                    size_t target() const { return current; }
+                    int weight() const {
+                        if (weights == nullptr) return 1;
+                        switch (type) {
+                            case WeightType::UInt8: return weights[e];
+                            case WeightType::Int16: {
+                                int16_t cell;
+                                memcpy(&cell, weights + e * sizeof(cell), sizeof(cell));
+                                return cell;
+                            }
+                            default: {
+                                int cell;
+                                memcpy(&cell, weights + e * sizeof(cell), sizeof(cell));
+                                return cell;
+                            }
+                        }
+                    }
+            };
+
+            CompressedView() : bytes(nullptr), starts(nullptr), type(WeightType::Int32), weighted(false), n(0) {}
+            CompressedView(const uint8_t* stream, const size_t* rowStarts, WeightType weightType, bool hasWeights, size_t size)
+                : bytes(stream), starts(rowStarts), type(weightType), weighted(hasWeights), n(size) {}
+            size_t size() const { return n; }
+            WeightType weightType() const { return type; }
+            bool isWeighted() const { return weighted; }
+            size_t degree(size_t u) const {
+                const uint8_t* p = bytes + starts[u];
+                return readDegree(p);
+            }
+            // Decodes the row up to v; 0 if absent.
+            int weight(size_t u, size_t v) const {
+                for (Cursor it = neighbors(u); it.valid() && it.target() <= v; it.next()) {
+                    if (it.target() == v) return it.weight();
+                }
+                return 0;
+            }
+            Cursor neighbors(size_t u) const {
+                const uint8_t* p = bytes + starts[u];
+                size_t d = readDegree(p);
+                const uint8_t* w = weighted ? p : nullptr;
+                if (weighted) p += d * cellBytes();
+                return Cursor(p, w, type, d, u);
+            }
+    };
+
+    // What Graph hands out to the algorithms: the storage in use plus the metadata
+    // computed at load time. The storage of a reordered Graph (Graph::reorder) is
+    // in the new ids; originalId and internalId translate between the two.
+    class GraphView {
+        private:
+            Storage storage;
+            bool directed;
+            bool negative;
+            DenseView dense;
+            SparseView sparse;
+            BitsetView bitset;
+            CompressedView compressed;
+            uint64_t version;
+            const size_t* originalIds;  // null when the ids are the loaded ones
+            const size_t* internalIds;
+
+        public:
+            // `contentVersion` is the Graph's stamp (see Graph::getVersion); 0 means
+            // unknown, and such views are never answered from the result cache.
+            GraphView(const DenseView& view, bool isDirected, bool negativeWeights = false, uint64_t contentVersion = 0)
+                : storage(Storage::Dense), directed(isDirected), negative(negativeWeights), dense(view), version(contentVersion),
+                  originalIds(nullptr), internalIds(nullptr) {}
+            GraphView(const SparseView& view, bool isDirected, bool negativeWeights = false, uint64_t contentVersion = 0)
+                : storage(Storage::Sparse), directed(isDirected), negative(negativeWeights), sparse(view), version(contentVersion),
+                  originalIds(nullptr), internalIds(nullptr) {}
+            GraphView(const BitsetView& view, bool isDirected, uint64_t contentVersion = 0)
+                : storage(Storage::Bitset), directed(isDirected), negative(false), bitset(view), version(contentVersion),
+                  originalIds(nullptr), internalIds(nullptr) {}
+            GraphView(const CompressedView& view, bool isDirected, bool negativeWeights = false, uint64_t contentVersion = 0)
+                : storage(Storage::Compressed), directed(isDirected), negative(negativeWeights), compressed(view), version(contentVersion),
+                  originalIds(nullptr), internalIds(nullptr) {}
+            // Both arrays have size() entries and are inverse permutations of each other.
+            void setOrder(const size_t* toOriginal, const size_t* toInternal) {
+                originalIds = toOriginal;
+                internalIds = toInternal;
+            }
+            Storage getStorage() const { return storage; }
+            bool isDirected() const { return directed; }
+            bool hasNegativeWeights() const { return negative; }
+            uint64_t getVersion() const { return version; }
+            bool isReordered() const { return originalIds != nullptr; }
+            size_t originalId(size_t v) const { return originalIds != nullptr ? originalIds[v] : v; }
+            size_t internalId(size_t v) const { return internalIds != nullptr ? internalIds[v] : v; }
+            size_t size() const {
+                if (storage == Storage::Sparse) return sparse.size();
+                if (storage == Storage::Bitset) return bitset.size();
+                if (storage == Storage::Compressed) return compressed.size();
+                return dense.size();
+            }
+            const DenseView& denseView() const { return dense; }
+            const SparseView& sparseView() const { return sparse; }
+            const BitsetView& bitsetView() const { return bitset; }
+            const CompressedView& compressedView() const { return compressed; }
+    };
+}
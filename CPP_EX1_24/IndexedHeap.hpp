@@ -0,0 +1,104 @@
+#pragma once
+
+#include "Instrumentation.hpp"
+#include <vector>
+#include <limits>
+#include <stdexcept>
+using namespace std;
+
+namespace ariel {
+    // A d-ary min-heap over the vertex ids 0..capacity-1 that supports
+    // decrease-key, so every vertex sits in the heap at most once.
+    // Arity 4 keeps the tree shallow while a node's children still share a cache line.
+    template <typename Key, size_t Arity = 4>
+    class IndexedHeap {
+        private:
+            static const size_t NOT_IN_HEAP = numeric_limits<size_t>::max();
+            vector<size_t> heap;
+            vector<size_t> position;
+            vector<Key> keys;
+
+            void place(size_t index, size_t vertex) {
+                heap[index] = vertex;
+                position[vertex] = index;
+            }
+
+            void siftUp(size_t index) {
+                size_t vertex = heap[index];
+                while (index > 0) {
+                    size_t parent = (index - 1) / Arity;
+                    if (!(keys[vertex] < keys[heap[parent]])) break;
+                    place(index, heap[parent]);
+                    index = parent;
+                }
+                place(index, vertex);
+            }
+
+            void siftDown(size_t index) {
+                size_t vertex = heap[index];
+                while (true) {
+                    size_t first = index * Arity + 1;
+                    if (first >= heap.size()) break;
+                    size_t last = first + Arity < heap.size() ? first + Arity : heap.size();
+                    size_t best = first;
+                    for (size_t child = first + 1; child < last; child++) {
+                        if (keys[heap[child]] < keys[heap[best]]) best = child;
+                    }
+                    if (!(keys[heap[best]] < keys[vertex])) break;
+                    place(index, heap[best]);
+                    index = best;
+                }
+                place(index, vertex);
+            }
+
+        public:
+            explicit IndexedHeap(size_t capacity) : position(capacity, NOT_IN_HEAP), keys(capacity) {
+                heap.reserve(capacity);
+            }
+
+            bool empty() const { return heap.empty(); }
+            size_t size() const { return heap.size(); }
+            bool contains(size_t vertex) const { return position[vertex] != NOT_IN_HEAP; }
+            size_t top() const { return heap.front(); }
+            Key topKey() const { return keys[heap.front()]; }
+
+            // Inserts the vertex, or lowers its key if it is already queued.
+            void push(size_t vertex, Key key) {
+                ARIEL_COUNT_HEAP_OPS(1);
+                if (contains(vertex)) {
+                    if (!(key < keys[vertex])) return;
+                    keys[vertex] = key;
+                    siftUp(position[vertex]);
+                    return;
+                }
+                keys[vertex] = key;
+                heap.push_back(vertex);
+                siftUp(heap.size() - 1);
+            }
+
+            // Empties the heap in O(size), so one heap can serve many searches.
+            void clear() {
+                for (size_t k = 0; k < heap.size(); k++) position[heap[k]] = NOT_IN_HEAP;
+                heap.clear();
+            }
+
+            size_t pop() {
+                if (heap.empty()) {
+                    throw out_of_range("Heap is empty.");
+                }
+                ARIEL_COUNT_HEAP_OPS(1);
+                size_t vertex = heap.front();
+                position[vertex] = NOT_IN_HEAP;
+                size_t last = heap.back();
+                heap.pop_back();
+                if (!heap.empty()) {
+                    heap[0] = last;
+                    siftDown(0);
+                }
+                return vertex;
+            }
+        };
+
+    template <typename Key, size_t Arity>
+    const size_t IndexedHeap<Key, Arity>::NOT_IN_HEAP;
+}
@@ -0,0 +1,205 @@
+#include "Instrumentation.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+
+using namespace std;
+
+#ifdef ARIEL_INSTRUMENT
+namespace ariel {
+namespace {
+    const size_t MAX_TRACE_EVENTS = 1000000;
+
+    struct TraceEvent {
+        const char* name;
+        double startUs;
+        double durationUs;
+        uint32_t thread;
+        CallCounters counters;
+    };
+
+    struct Log {
+        mutex lock;
+        chrono::steady_clock::time_point origin;
+        map<string, FunctionStats> functions;
+        vector<TraceEvent> events;
+
+        Log() : origin(chrono::steady_clock::now()) {}
+    };
+
+    Log& callLog() {
+        static Log* instance = new Log();  // never destroyed, so calls during static destruction still work
+        return *instance;
+    }
+
+    atomic<uint32_t> nextThread(0);
+    thread_local uint32_t threadNumber = UINT32_MAX;
+
+    uint32_t currentThread() {
+        if (threadNumber == UINT32_MAX) threadNumber = nextThread.fetch_add(1);
+        return threadNumber;
+    }
+
+    void addCounters(CallCounters& total, const CallCounters& counts) {
+        total.verticesVisited += counts.verticesVisited;
+        total.edgesScanned += counts.edgesScanned;
+        total.heapOperations += counts.heapOperations;
+        total.allocations += counts.allocations;
+    }
+}
+
+namespace instrumentation {
+    thread_local CallCounters local = {0, 0, 0, 0};
+    thread_local ActiveCall* active = nullptr;
+
+    void ActiveCall::add(const CallCounters& counts) {
+        vertices.fetch_add(counts.verticesVisited, memory_order_relaxed);
+        edges.fetch_add(counts.edgesScanned, memory_order_relaxed);
+        heapOperations.fetch_add(counts.heapOperations, memory_order_relaxed);
+        allocations.fetch_add(counts.allocations, memory_order_relaxed);
+    }
+
+    CallScope::CallScope(const char* function) : name(function), outermost(active == nullptr) {
+        if (!outermost) return;
+        callLog();  // fixes the trace origin before the first start time
+        active = &call;
+        local = CallCounters{0, 0, 0, 0};
+        start = chrono::steady_clock::now();
+    }
+
+    CallScope::~CallScope() {
+        if (!outermost) return;
+        chrono::steady_clock::time_point end = chrono::steady_clock::now();
+        call.add(local);
+        active = nullptr;
+        CallCounters counts = {call.vertices.load(), call.edges.load(), call.heapOperations.load(), call.allocations.load()};
+        double ms = chrono::duration<double, milli>(end - start).count();
+        uint32_t thread = currentThread();
+        Log& l = callLog();
+        lock_guard<mutex> guard(l.lock);
+        FunctionStats& stats = l.functions[name];
+        if (stats.calls == 0) {
+            stats.name = name;
+            stats.maxMs = 0;
+        }
+        stats.calls++;
+        stats.totalMs += ms;
+        stats.maxMs = max(stats.maxMs, ms);
+        addCounters(stats.totals, counts);
+        if (l.events.size() < MAX_TRACE_EVENTS) {
+            double startUs = chrono::duration<double, micro>(start - l.origin).count();
+            TraceEvent event = {name, startUs, ms * 1000.0, thread, counts};
+            l.events.push_back(event);
+        }
+    }
+
+    WorkerScope::WorkerScope(ActiveCall* call) : parent(call) {
+        if (parent == nullptr) return;
+        active = parent;
+        local = CallCounters{0, 0, 0, 0};
+    }
+
+    WorkerScope::~WorkerScope() {
+        if (parent == nullptr) return;
+        parent->add(local);
+        active = nullptr;
+    }
+}
+
+    bool Instrumentation::enabled() {
+        return true;
+    }
+
+    vector<FunctionStats> Instrumentation::summary() {
+        Log& l = callLog();
+        lock_guard<mutex> guard(l.lock);
+        vector<FunctionStats> result;
+        for (map<string, FunctionStats>::const_iterator it = l.functions.begin(); it != l.functions.end(); ++it) {
+            result.push_back(it->second);
+        }
+        return result;
+    }
+
+    void Instrumentation::printSummary(ostream& out) {
+        vector<FunctionStats> stats = summary();
+        out << left << setw(24) << "function" << right << setw(8) << "calls" << setw(12) << "total ms" << setw(12) << "mean ms"
+            << setw(12) << "max ms" << setw(14) << "vertices" << setw(14) << "edges" << setw(12) << "heap ops" << setw(12) << "allocs" << endl;
+        for (size_t k = 0; k < stats.size(); k++) {
+            const FunctionStats& s = stats[k];
+            out << left << setw(24) << s.name << right << setw(8) << s.calls << fixed << setprecision(3) << setw(12) << s.totalMs
+                << setw(12) << s.totalMs / static_cast<double>(s.calls) << setw(12) << s.maxMs << setw(14) << s.totals.verticesVisited
+                << setw(14) << s.totals.edgesScanned << setw(12) << s.totals.heapOperations << setw(12) << s.totals.allocations << endl;
+        }
+    }
+
+    void Instrumentation::writeChromeTrace(const string& path) {
+        FILE* file = fopen(path.c_str(), "w");
+        if (file == nullptr) {
+            throw runtime_error("Cannot write trace file: " + path);
+        }
+        Log& l = callLog();
+        lock_guard<mutex> guard(l.lock);
+        fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", file);
+        for (size_t k = 0; k < l.events.size(); k++) {
+            const TraceEvent& e = l.events[k];
+            fprintf(file, "%s\n{\"name\":\"%s\",\"cat\":\"Algorithms\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,"
+                          "\"args\":{\"vertices\":%llu,\"edges\":%llu,\"heapOperations\":%llu,\"allocations\":%llu}}",
+                    k == 0 ? "" : ",", e.name, e.thread, e.startUs, e.durationUs,
+                    static_cast<unsigned long long>(e.counters.verticesVisited), static_cast<unsigned long long>(e.counters.edgesScanned),
+                    static_cast<unsigned long long>(e.counters.heapOperations), static_cast<unsigned long long>(e.counters.allocations));
+        }
+        fputs("\n]}\n", file);
+        fclose(file);
+    }
+
+    void Instrumentation::reset() {
+        Log& l = callLog();
+        lock_guard<mutex> guard(l.lock);
+        l.functions.clear();
+        l.events.clear();
+    }
+}
+
+// Every allocation in the process bumps the counter of the thread that made it.
+void* operator new(size_t size) {
+    ariel::instrumentation::local.allocations++;
+    void* memory = malloc(size > 0 ? size : 1);
+    if (memory == nullptr) throw bad_alloc();
+    return memory;
+}
+
+void operator delete(void* memory) noexcept {
+    free(memory);
+}
+
+#else
+namespace ariel {
+    bool Instrumentation::enabled() {
+        return false;
+    }
+
+    vector<FunctionStats> Instrumentation::summary() {
+        return vector<FunctionStats>();
+    }
+
+    void Instrumentation::printSummary(ostream& out) {
+        out << "Instrumentation is off; rebuild with -DARIEL_INSTRUMENT (make INSTRUMENT=1)." << endl;
+    }
+
+    void Instrumentation::writeChromeTrace(const string& path) {
+        FILE* file = fopen(path.c_str(), "w");
+        if (file == nullptr) {
+            throw runtime_error("Cannot write trace file: " + path);
+        }
+        fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[]}\n", file);
+        fclose(file);
+    }
+
+    void Instrumentation::reset() {}
+}
+#endif
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+using namespace std;
+
+namespace ariel {
+    // Work counted during calls.
+    struct CallCounters {
+        uint64_t verticesVisited;
+        uint64_t edgesScanned;
+        uint64_t heapOperations;
+        uint64_t allocations;
+    };
+
+    // Totals over every recorded call of one function.
+    struct FunctionStats {
+        string name;
+        uint64_t calls;
+        double totalMs;
+        double maxMs;
+        CallCounters totals;
+    };
+
+    // Per-call counters for the Algorithms entry points, compiled in only with
+    // -DARIEL_INSTRUMENT (`make INSTRUMENT=1 ...` after a `make clean`). Without it
+    // the ARIEL_* macros below expand to nothing, so the hot loops are unchanged,
+    // and the report functions return empty results.
+    //
+    // Each outermost Algorithms call on a thread is one record. The record holds
+    // the wall time and the vertices, edges, heap operations and allocations
+    // counted while the call ran, both on its own thread and on the workers it
+    // started through Parallel.hpp. A call made inside another one (isContainsCycle
+    // calling findCycle) counts towards the outer call.
+    class Instrumentation {
+        public:
+            static bool enabled();
+            // One entry per function, sorted by name.
+            static vector<FunctionStats> summary();
+            static void printSummary(ostream& out);
+            // Chrome trace-event JSON with one complete ("X") event per call and the
+            // counters as args; open it in chrome://tracing or ui.perfetto.dev. Keeps
+            // the first million calls.
+            static void writeChromeTrace(const string& path);
+            static void reset();
+    };
+
+#ifdef ARIEL_INSTRUMENT
+    namespace instrumentation {
+        // Shared record of the call a thread is working for; workers add their
+        // counts to it once, when they finish.
+        struct ActiveCall {
+            atomic<uint64_t> vertices;
+            atomic<uint64_t> edges;
+            atomic<uint64_t> heapOperations;
+            atomic<uint64_t> allocations;
+
+            ActiveCall() : vertices(0), edges(0), heapOperations(0), allocations(0) {}
+            void add(const CallCounters& counts);
+        };
+
+        // Plain per-thread counters the hot loops bump; zeroed when a scope starts.
+        extern thread_local CallCounters local;
+        extern thread_local ActiveCall* active;
+
+        class CallScope {
+            private:
+                const char* name;
+                bool outermost;
+                ActiveCall call;
+                chrono::steady_clock::time_point start;
+
+            public:
+                explicit CallScope(const char* function);
+                ~CallScope();
+        };
+
+        class WorkerScope {
+            private:
+                ActiveCall* parent;
+
+            public:
+                explicit WorkerScope(ActiveCall* call);
+                ~WorkerScope();
+        };
+    }
+
+#define ARIEL_PROFILE_CALL(name) ::ariel::instrumentation::CallScope arielCallScope(name)
+#define ARIEL_COUNT_VERTICES(count) (::ariel::instrumentation::local.verticesVisited += (count))
+#define ARIEL_COUNT_EDGES(count) (::ariel::instrumentation::local.edgesScanned += (count))
+#define ARIEL_COUNT_HEAP_OPS(count) (::ariel::instrumentation::local.heapOperations += (count))
+// Parallel.hpp: capture the caller's call before starting workers, adopt it in each worker.
+#define ARIEL_PARENT_CALL(var) ::ariel::instrumentation::ActiveCall* var = ::ariel::instrumentation::active
+#define ARIEL_WORKER_SCOPE(parent) ::ariel::instrumentation::WorkerScope arielWorkerScope(parent)
+#else
+#define ARIEL_PROFILE_CALL(name) ((void)0)
+#define ARIEL_COUNT_VERTICES(count) ((void)0)
+#define ARIEL_COUNT_EDGES(count) ((void)0)
+#define ARIEL_COUNT_HEAP_OPS(count) ((void)0)
+#define ARIEL_PARENT_CALL(var) ((void)0)
+#define ARIEL_WORKER_SCOPE(parent) ((void)0)
+#endif
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "Instrumentation.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+using namespace std;
+
+namespace ariel {
+    // Number of workers to use when the caller asks for `requested` (0 = all hardware threads).
+    inline size_t resolveThreads(size_t requested) {
+        if (requested > 0) return requested;
+        size_t hardware = thread::hardware_concurrency();
+        return hardware > 0 ? hardware : 1;
+    }
+
+    // Runs task(i) for every i in [0, count) on up to `threads` workers.
+    // Workers pull indices from a shared counter, so uneven tasks still balance.
+    // Tasks must not throw.
+    template <typename Task>
+    void parallelFor(size_t count, size_t threads, Task task) {
+        size_t workers = resolveThreads(threads);
+        if (workers > count) workers = count;
+        if (workers <= 1) {
+            for (size_t i = 0; i < count; i++) task(i);
+            return;
+        }
+        atomic<size_t> next(0);
+        ARIEL_PARENT_CALL(parent);
+        vector<thread> pool;
+        pool.reserve(workers);
+        for (size_t w = 0; w < workers; w++) {
+            pool.push_back(thread([&]() {
+                ARIEL_WORKER_SCOPE(parent);
+                for (size_t i = next++; i < count; i = next++) task(i);
+            }));
+        }
+        for (size_t w = 0; w < pool.size(); w++) pool[w].join();
+    }
+
+    // Reusable barrier for a fixed team of threads (std::barrier is C++20).
+    class Barrier {
+        private:
+            mutex lock;
+            condition_variable released;
+            size_t parties;
+            size_t waiting;
+            size_t generation;
+
+        public:
+            explicit Barrier(size_t count) : parties(count), waiting(0), generation(0) {}
+
+            void wait() {
+                unique_lock<mutex> guard(lock);
+                size_t current = generation;
+                if (++waiting == parties) {
+                    waiting = 0;
+                    generation++;
+                    released.notify_all();
+                    return;
+                }
+                released.wait(guard, [&]() { return generation != current; });
+            }
+    };
+
+    // Runs worker(id) for id in [0, threads) and waits for all of them; worker 0
+    // runs on the calling thread. Workers must not throw.
+    template <typename Worker>
+    void runTeam(size_t threads, Worker worker) {
+        ARIEL_PARENT_CALL(parent);
+        vector<thread> team;
+        team.reserve(threads > 0 ? threads - 1 : 0);
+        for (size_t id = 1; id < threads; id++) {
+            team.push_back(thread([&, id]() {
+                ARIEL_WORKER_SCOPE(parent);
+                worker(id);
+            }));
+        }
+        worker(0);
+        for (size_t t = 0; t < team.size(); t++) team[t].join();
+    }
+}
@@ -0,0 +1,196 @@
+#pragma once
+
+#include "GraphView.hpp"
+#include "Parallel.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+using namespace std;
+
+namespace ariel {
+    // Level-synchronous parallel BFS with direction optimization (Beamer et al.).
+    // A team of threads expands one level at a time:
+    //  - top-down: the frontier is split between the threads and each claims its
+    //    unvisited neighbors with an atomic fetch_or on the visited bitmap;
+    //  - bottom-up: the vertex range is split instead and every unvisited vertex
+    //    looks for any neighbor in the frontier bitmap, stopping at the first hit.
+    // Bottom-up pays off once the frontier covers a large part of the graph. It
+    // reads a vertex's own row as its in-edges, so it is only used on undirected graphs.
+    // Only edges with a positive weight are followed, as in the sequential traversals.
+    //
+    // A run takes a list of sources and grows a tree from each one that no earlier
+    // tree reached, all with one thread team; that is how isBipartite walks every
+    // component. Levels under SHARED_FRONTIER vertices are not worth a team step,
+    // so one thread expands them alone, and a graph of small components never
+    // wakes the team.
+    template <typename View>
+    class ParallelBFS {
+        private:
+            static const size_t ALPHA = 14;  // go bottom-up once the frontier holds more than n/ALPHA vertices
+            static const size_t BETA = 24;   // go back top-down once it drops under n/BETA vertices
+            static const size_t SHARED_FRONTIER = 256;  // smaller top-down levels are expanded by one thread
+
+            const View& adj;
+            bool bottomUpAllowed;
+            size_t threads;
+            vector<atomic<uint64_t>> visited;
+            vector<uint64_t> frontierBits;
+            vector<int> depth;
+            vector<size_t> frontier;
+            vector<size_t> discovered;
+            vector<vector<size_t>> local;
+
+            bool isVisited(size_t v) const {
+                return (visited[v / 64].load(memory_order_relaxed) >> (v % 64)) & 1;
+            }
+
+            // True for exactly one caller per vertex.
+            bool tryVisit(size_t v) {
+                uint64_t mask = uint64_t(1) << (v % 64);
+                if (visited[v / 64].load(memory_order_relaxed) & mask) return false;
+                return (visited[v / 64].fetch_or(mask, memory_order_relaxed) & mask) == 0;
+            }
+
+            void topDownRange(size_t first, size_t last, vector<size_t>& found) {
+                for (size_t k = first; k < last; k++) {
+                    for (typename View::Cursor it = adj.neighbors(frontier[k]); it.valid(); it.next()) {
+                        ARIEL_COUNT_EDGES(1);
+                        if (it.weight() > 0 && tryVisit(it.target())) found.push_back(it.target());
+                    }
+                }
+                ARIEL_COUNT_VERTICES(last - first);
+            }
+
+            void topDownStep(size_t id) {
+                size_t chunk = (frontier.size() + threads - 1) / threads;
+                size_t first = min(frontier.size(), id * chunk), last = min(frontier.size(), first + chunk);
+                topDownRange(first, last, local[id]);
+            }
+
+            void bottomUpStep(size_t id) {
+                size_t chunk = (adj.size() + threads - 1) / threads;
+                size_t first = min(adj.size(), id * chunk), last = min(adj.size(), first + chunk);
+                for (size_t v = first; v < last; v++) {
+                    if (isVisited(v)) continue;
+                    for (typename View::Cursor it = adj.neighbors(v); it.valid(); it.next()) {
+                        size_t u = it.target();
+                        ARIEL_COUNT_EDGES(1);
+                        if (it.weight() > 0 && ((frontierBits[u / 64] >> (u % 64)) & 1)) {
+                            tryVisit(v);
+                            local[id].push_back(v);
+                            ARIEL_COUNT_VERTICES(1);
+                            break;
+                        }
+                    }
+                }
+            }
+
+            void buildFrontierBits() {
+                fill(frontierBits.begin(), frontierBits.end(), 0);
+                for (size_t k = 0; k < frontier.size(); k++) {
+                    frontierBits[frontier[k] / 64] |= uint64_t(1) << (frontier[k] % 64);
+                }
+            }
+
+            // Starts a tree at the next source no earlier tree reached; false when none is left.
+            bool seed(const vector<size_t>& sources, size_t& next) {
+                while (next < sources.size()) {
+                    size_t source = sources[next++];
+                    if (!tryVisit(source)) continue;
+                    depth[source] = 0;
+                    discovered.push_back(source);
+                    frontier.assign(1, source);
+                    return true;
+                }
+                return false;
+            }
+
+            // Turns the vertices found by the last step into the next level.
+            void gather(int& level, bool& bottomUp) {
+                // Bottom-up slices are disjoint ascending ranges, so only top-down needs a sort.
+                frontier.clear();
+                for (size_t t = 0; t < threads; t++) {
+                    frontier.insert(frontier.end(), local[t].begin(), local[t].end());
+                    local[t].clear();
+                }
+                if (!bottomUp) sort(frontier.begin(), frontier.end());
+                level++;
+                for (size_t k = 0; k < frontier.size(); k++) {
+                    depth[frontier[k]] = level;
+                    discovered.push_back(frontier[k]);
+                }
+                if (bottomUpAllowed) {
+                    if (!bottomUp && frontier.size() * ALPHA > adj.size()) {
+                        bottomUp = true;
+                    } else if (bottomUp && frontier.size() * BETA < adj.size()) {
+                        bottomUp = false;
+                    }
+                    if (bottomUp) buildFrontierBits();
+                }
+            }
+
+        public:
+            ParallelBFS(const View& view, bool undirected, size_t threadCount)
+                : adj(view), bottomUpAllowed(undirected), threads(resolveThreads(threadCount)),
+                  visited((view.size() + 63) / 64), frontierBits((view.size() + 63) / 64, 0),
+                  depth(view.size(), -1), local(threads) {
+                for (size_t w = 0; w < visited.size(); w++) visited[w].store(0);
+                discovered.reserve(view.size());
+            }
+
+            // BFS from each source in turn over the vertices no earlier tree reached.
+            // Returns how many vertices this run reached, sources included.
+            size_t run(const vector<size_t>& sources) {
+                size_t before = discovered.size();
+                size_t next = 0;
+                int level = 0;
+                bool bottomUp = false;
+                // Runs on one thread between team steps: expands the levels too small
+                // to share and moves on to the next source once a tree is done.
+                // Returns false when every source has been handled.
+                auto advance = [&]() -> bool {
+                    while (true) {
+                        if (frontier.empty()) {
+                            if (!seed(sources, next)) return false;
+                            level = 0;
+                            bottomUp = false;
+                        }
+                        if (bottomUp || frontier.size() >= SHARED_FRONTIER) return true;
+                        topDownRange(0, frontier.size(), local[0]);
+                        gather(level, bottomUp);
+                    }
+                };
+                if (!advance()) return discovered.size() - before;
+                bool done = false;
+                Barrier barrier(threads);
+                runTeam(threads, [&](size_t id) {
+                    while (true) {
+                        if (bottomUp) {
+                            bottomUpStep(id);
+                        } else {
+                            topDownStep(id);
+                        }
+                        barrier.wait();
+                        if (id == 0) {
+                            gather(level, bottomUp);
+                            done = !advance();
+                        }
+                        barrier.wait();
+                        if (done) break;
+                    }
+                });
+                return discovered.size() - before;
+            }
+
+            size_t run(size_t source) { return run(vector<size_t>(1, source)); }
+
+            // BFS level of v in the tree that reached it, -1 if none did.
+            int level(size_t v) const { return depth[v]; }
+
+            // Every vertex reached so far, tree by tree and level by level, ascending within a level.
+            const vector<size_t>& order() const { return discovered; }
+
+            size_t threadCount() const { return threads; }
+    };
+}
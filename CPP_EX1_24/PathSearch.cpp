@@ -0,0 +1,311 @@
+#include "PathSearch.hpp"
+#include "Parallel.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+using namespace std;
+
+namespace ariel {
+namespace {
+    const int INF = numeric_limits<int>::max();
+    const size_t NONE = numeric_limits<size_t>::max();
+    const char LANDMARK_FILE_MAGIC[8] = {'A', 'R', 'L', 'A', 'N', 'D', 'M', '\0'};
+
+    // Rows are copied in loaded order with loaded targets, so a reordered
+    // graph is searched in the ids the caller knows.
+    template <typename Adjacency>
+    void copyRows(const GraphView& g, const Adjacency& adj, vector<size_t>& offsets, vector<size_t>& targets, vector<int>& weights) {
+        offsets.assign(adj.size() + 1, 0);
+        for (size_t u = 0; u < adj.size(); u++) {
+            for (typename Adjacency::Cursor it = adj.neighbors(g.internalId(u)); it.valid(); it.next()) {
+                if (it.weight() < 0) {
+                    throw invalid_argument("Invalid graph: PathSearch needs non-negative weights.");
+                }
+                targets.push_back(g.originalId(it.target()));
+                weights.push_back(it.weight());
+            }
+            offsets[u + 1] = targets.size();
+        }
+    }
+
+    void writeBytes(FILE* file, const void* bytes, size_t count, const string& path) {
+        if (count > 0 && fwrite(bytes, 1, count, file) != count) {
+            fclose(file);
+            throw runtime_error("Cannot write landmark file: " + path);
+        }
+    }
+
+    bool readBytes(FILE* file, void* bytes, size_t count) {
+        return count == 0 || fread(bytes, 1, count, file) == count;
+    }
+}
+
+    PathSearch::Side::Side(size_t n) : dist(n, INF), parent(n, NONE), settled(n, false), heap(n) {}
+
+    void PathSearch::Side::reset() {
+        for (size_t k = 0; k < touched.size(); k++) {
+            dist[touched[k]] = INF;
+            parent[touched[k]] = NONE;
+            settled[touched[k]] = false;
+        }
+        touched.clear();
+        heap.clear();
+    }
+
+    // Lowers v's distance if `distance` is better; the caller queues v with its own key.
+    bool PathSearch::Side::reach(size_t v, int distance, size_t from) {
+        if (distance >= dist[v]) return false;
+        if (dist[v] == INF) touched.push_back(v);
+        dist[v] = distance;
+        parent[v] = from;
+        return true;
+    }
+
+    PathSearch::PathSearch(const GraphView& g) : n(g.size()), forward(g.size()), backward(g.size()), settledCount(0) {
+        switch (g.getStorage()) {
+            case Storage::Sparse: copyRows(g, g.sparseView(), forwardOffsets, forwardTargets, forwardWeights); break;
+            case Storage::Compressed: copyRows(g, g.compressedView(), forwardOffsets, forwardTargets, forwardWeights); break;
+            case Storage::Bitset: copyRows(g, g.bitsetView(), forwardOffsets, forwardTargets, forwardWeights); break;
+            default: copyRows(g, g.denseView(), forwardOffsets, forwardTargets, forwardWeights);
+        }
+        // Reverse adjacency by counting sort on the targets; rows stay ordered by source.
+        backwardOffsets.assign(n + 1, 0);
+        for (size_t e = 0; e < forwardTargets.size(); e++) backwardOffsets[forwardTargets[e] + 1]++;
+        for (size_t v = 0; v < n; v++) backwardOffsets[v + 1] += backwardOffsets[v];
+        backwardTargets.resize(forwardTargets.size());
+        backwardWeights.resize(forwardTargets.size());
+        vector<size_t> next(backwardOffsets.begin(), backwardOffsets.end() - 1);
+        for (size_t u = 0; u < n; u++) {
+            for (size_t e = forwardOffsets[u]; e < forwardOffsets[u + 1]; e++) {
+                size_t slot = next[forwardTargets[e]]++;
+                backwardTargets[slot] = u;
+                backwardWeights[slot] = forwardWeights[e];
+            }
+        }
+    }
+
+    void PathSearch::checkVertex(size_t v) const {
+        if (v >= n) {
+            throw invalid_argument("Invalid vertex: The vertex is not in the graph.");
+        }
+    }
+
+    PathResult PathSearch::result(size_t src, size_t dest, int distance, size_t meeting) const {
+        PathResult answer;
+        answer.src = src;
+        answer.dest = dest;
+        answer.reachable = meeting != NONE;
+        answer.distance = answer.reachable ? distance : -1;
+        if (!answer.reachable) return answer;
+        for (size_t at = meeting; at != NONE; at = forward.parent[at]) answer.path.push_back(at);
+        reverse(answer.path.begin(), answer.path.end());
+        for (size_t at = backward.parent[meeting]; at != NONE; at = backward.parent[at]) answer.path.push_back(at);
+        return answer;
+    }
+
+    PathResult PathSearch::dijkstra(size_t src, size_t dest) {
+        checkVertex(src);
+        checkVertex(dest);
+        forward.reset();
+        backward.reset();
+        settledCount = 0;
+        forward.reach(src, 0, NONE);
+        forward.heap.push(src, 0);
+        while (!forward.heap.empty()) {
+            size_t u = forward.heap.pop();
+            forward.settled[u] = true;
+            settledCount++;
+            if (u == dest) return result(src, dest, forward.dist[u], u);
+            for (size_t e = forwardOffsets[u]; e < forwardOffsets[u + 1]; e++) {
+                size_t v = forwardTargets[e];
+                if (!forward.settled[v] && forward.reach(v, forward.dist[u] + forwardWeights[e], u)) {
+                    forward.heap.push(v, forward.dist[v]);
+                }
+            }
+        }
+        return result(src, dest, -1, NONE);
+    }
+
+    PathResult PathSearch::bidirectional(size_t src, size_t dest) {
+        checkVertex(src);
+        checkVertex(dest);
+        forward.reset();
+        backward.reset();
+        settledCount = 0;
+        forward.reach(src, 0, NONE);
+        forward.heap.push(src, 0);
+        backward.reach(dest, 0, NONE);
+        backward.heap.push(dest, 0);
+        int best = src == dest ? 0 : INF;
+        size_t meeting = src == dest ? src : NONE;
+        while (!forward.heap.empty() && !backward.heap.empty()) {
+            int forwardHead = forward.heap.topKey(), backwardHead = backward.heap.topKey();
+            if (best != INF && forwardHead + backwardHead >= best) break;
+            bool growForward = forwardHead <= backwardHead;
+            Side& side = growForward ? forward : backward;
+            const Side& other = growForward ? backward : forward;
+            const vector<size_t>& offsets = growForward ? forwardOffsets : backwardOffsets;
+            const vector<size_t>& targets = growForward ? forwardTargets : backwardTargets;
+            const vector<int>& weights = growForward ? forwardWeights : backwardWeights;
+            size_t u = side.heap.pop();
+            side.settled[u] = true;
+            settledCount++;
+            for (size_t e = offsets[u]; e < offsets[u + 1]; e++) {
+                size_t v = targets[e];
+                if (side.settled[v]) continue;
+                int distance = side.dist[u] + weights[e];
+                if (side.reach(v, distance, u)) side.heap.push(v, distance);
+                if (other.dist[v] != INF && distance + other.dist[v] < best) {
+                    best = distance + other.dist[v];
+                    meeting = v;
+                }
+            }
+        }
+        return result(src, dest, best, meeting);
+    }
+
+    // d(v, dest) >= d(L, dest) - d(L, v) and d(v, dest) >= d(v, L) - d(dest, L)
+    // for every landmark L; terms with an unreachable side are skipped.
+    int PathSearch::lowerBound(size_t v, size_t dest) const {
+        int bound = 0;
+        for (size_t l = 0; l < landmarks.size(); l++) {
+            const int* from = &fromLandmark[l * n];
+            const int* to = &toLandmark[l * n];
+            if (from[dest] != INF && from[v] != INF) bound = max(bound, from[dest] - from[v]);
+            if (to[v] != INF && to[dest] != INF) bound = max(bound, to[v] - to[dest]);
+        }
+        return bound;
+    }
+
+    PathResult PathSearch::alt(size_t src, size_t dest) {
+        checkVertex(src);
+        checkVertex(dest);
+        if (landmarks.empty()) {
+            throw logic_error("No landmarks: call selectLandmarks or loadLandmarks first.");
+        }
+        forward.reset();
+        backward.reset();
+        settledCount = 0;
+        forward.reach(src, 0, NONE);
+        forward.heap.push(src, lowerBound(src, dest));
+        while (!forward.heap.empty()) {
+            size_t u = forward.heap.pop();
+            forward.settled[u] = true;
+            settledCount++;
+            if (u == dest) return result(src, dest, forward.dist[u], u);
+            for (size_t e = forwardOffsets[u]; e < forwardOffsets[u + 1]; e++) {
+                size_t v = forwardTargets[e];
+                if (!forward.settled[v] && forward.reach(v, forward.dist[u] + forwardWeights[e], u)) {
+                    forward.heap.push(v, forward.dist[v] + lowerBound(v, dest));
+                }
+            }
+        }
+        return result(src, dest, -1, NONE);
+    }
+
+    // Full Dijkstra from src over the forward or the reverse edges into dist[0..n).
+    void PathSearch::fullSearch(size_t src, bool reverse, int* dist) const {
+        const vector<size_t>& offsets = reverse ? backwardOffsets : forwardOffsets;
+        const vector<size_t>& targets = reverse ? backwardTargets : forwardTargets;
+        const vector<int>& weights = reverse ? backwardWeights : forwardWeights;
+        fill(dist, dist + n, INF);
+        vector<bool> settled(n, false);
+        IndexedHeap<int> heap(n);
+        dist[src] = 0;
+        heap.push(src, 0);
+        while (!heap.empty()) {
+            size_t u = heap.pop();
+            settled[u] = true;
+            for (size_t e = offsets[u]; e < offsets[u + 1]; e++) {
+                size_t v = targets[e];
+                if (!settled[v] && dist[u] + weights[e] < dist[v]) {
+                    dist[v] = dist[u] + weights[e];
+                    heap.push(v, dist[v]);
+                }
+            }
+        }
+    }
+
+    void PathSearch::selectLandmarks(size_t count, size_t threads) {
+        count = min(count, n);
+        landmarks.clear();
+        fromLandmark.assign(count * n, INF);
+        toLandmark.assign(count * n, INF);
+        if (count == 0) return;
+        // Vertices no landmark reaches count as infinitely far, so every
+        // component gets a landmark before any gets a second one.
+        vector<int> nearest(n, INF);
+        vector<int> scratch(n);
+        fullSearch(0, false, scratch.data());
+        const vector<int>* farthestFrom = &scratch;
+        vector<bool> chosen(n, false);
+        for (size_t l = 0; l < count; l++) {
+            size_t pick = NONE;
+            for (size_t v = 0; v < n; v++) {
+                if (!chosen[v] && (pick == NONE || (*farthestFrom)[v] > (*farthestFrom)[pick])) pick = v;
+            }
+            chosen[pick] = true;
+            landmarks.push_back(pick);
+            int* row = &fromLandmark[l * n];
+            fullSearch(pick, false, row);
+            for (size_t v = 0; v < n; v++) nearest[v] = min(nearest[v], row[v]);
+            farthestFrom = &nearest;
+        }
+        parallelFor(count, threads, [&](size_t l) {
+            fullSearch(landmarks[l], true, &toLandmark[l * n]);
+        });
+    }
+
+    // Layout: 8-byte magic, uint64 vertex count, uint64 landmark count, the
+    // landmark ids as uint64, then the from and to tables as int32 rows.
+    void PathSearch::saveLandmarks(const string& path) const {
+        FILE* file = fopen(path.c_str(), "wb");
+        if (file == nullptr) {
+            throw runtime_error("Cannot write landmark file: " + path);
+        }
+        uint64_t header[2] = {n, landmarks.size()};
+        vector<uint64_t> ids(landmarks.begin(), landmarks.end());
+        writeBytes(file, LANDMARK_FILE_MAGIC, sizeof(LANDMARK_FILE_MAGIC), path);
+        writeBytes(file, header, sizeof(header), path);
+        writeBytes(file, ids.data(), ids.size() * sizeof(uint64_t), path);
+        writeBytes(file, fromLandmark.data(), fromLandmark.size() * sizeof(int), path);
+        writeBytes(file, toLandmark.data(), toLandmark.size() * sizeof(int), path);
+        if (fclose(file) != 0) {
+            throw runtime_error("Cannot write landmark file: " + path);
+        }
+    }
+
+    void PathSearch::loadLandmarks(const string& path) {
+        FILE* file = fopen(path.c_str(), "rb");
+        if (file == nullptr) {
+            throw runtime_error("Cannot open landmark file: " + path);
+        }
+        char magic[8];
+        uint64_t header[2];
+        bool valid = readBytes(file, magic, sizeof(magic)) && memcmp(magic, LANDMARK_FILE_MAGIC, sizeof(magic)) == 0 &&
+                     readBytes(file, header, sizeof(header)) && header[0] == n && header[1] <= n;
+        vector<uint64_t> ids;
+        vector<int> from, to;
+        if (valid) {
+            size_t count = static_cast<size_t>(header[1]);
+            ids.resize(count);
+            from.resize(count * n);
+            to.resize(count * n);
+            valid = readBytes(file, ids.data(), ids.size() * sizeof(uint64_t)) &&
+                    readBytes(file, from.data(), from.size() * sizeof(int)) &&
+                    readBytes(file, to.data(), to.size() * sizeof(int)) && fgetc(file) == EOF;
+            for (size_t l = 0; valid && l < count; l++) valid = ids[l] < n;
+        }
+        fclose(file);
+        if (!valid) {
+            throw invalid_argument("Invalid landmark file: " + path);
+        }
+        landmarks.assign(ids.begin(), ids.end());
+        fromLandmark.swap(from);
+        toLandmark.swap(to);
+    }
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "Algorithms.hpp"
+#include "GraphView.hpp"
+#include "IndexedHeap.hpp"
+#include <string>
+#include <vector>
+using namespace std;
+
+namespace ariel {
+    // Point-to-point shortest paths on a fixed graph with non-negative weights.
+    // The constructor copies the graph into forward and reverse CSR arrays once,
+    // so every mode can walk edges in both directions whatever the storage.
+    // Queries reuse the search state and only reset what they touched, so a
+    // query that settles k vertices costs O(k log k), not O(V).
+    //
+    // A PathSearch runs one query at a time; give each thread its own.
+    class PathSearch {
+        private:
+            // One direction of a search: tentative distances, parents and a heap,
+            // plus the list of vertices to reset before the next query.
+            struct Side {
+                vector<int> dist;
+                vector<size_t> parent;
+                vector<bool> settled;
+                vector<size_t> touched;
+                IndexedHeap<int> heap;
+
+                explicit Side(size_t n);
+                void reset();
+                bool reach(size_t v, int distance, size_t from);
+            };
+
+            size_t n;
+            vector<size_t> forwardOffsets, forwardTargets;
+            vector<int> forwardWeights;
+            vector<size_t> backwardOffsets, backwardTargets;
+            vector<int> backwardWeights;
+            vector<size_t> landmarks;
+            vector<int> fromLandmark;  // fromLandmark[l * n + v] = d(landmark l, v)
+            vector<int> toLandmark;    // toLandmark[l * n + v] = d(v, landmark l)
+            Side forward, backward;
+            size_t settledCount;
+
+            void checkVertex(size_t v) const;
+            void fullSearch(size_t src, bool reverse, int* dist) const;
+            int lowerBound(size_t v, size_t dest) const;
+            PathResult result(size_t src, size_t dest, int distance, size_t meeting) const;
+
+        public:
+            // Throws invalid_argument on a negative weight.
+            explicit PathSearch(const GraphView& g);
+
+            size_t size() const { return n; }
+            // Plain Dijkstra stopping at dest.
+            PathResult dijkstra(size_t src, size_t dest);
+            // Searches forward from src and backward from dest, always growing the
+            // side with the smaller head, and stops once the two heads together
+            // cannot beat the best meeting found.
+            PathResult bidirectional(size_t src, size_t dest);
+            // A* whose estimate of d(v, dest) is the best triangle-inequality bound
+            // over the landmarks. Needs selectLandmarks or loadLandmarks first.
+            PathResult alt(size_t src, size_t dest);
+            // Vertices settled by the last query, over both directions.
+            size_t lastSettled() const { return settledCount; }
+
+            // Farthest-point selection: every next landmark is the vertex farthest
+            // from the ones already chosen. The distance tables from and to every
+            // landmark are then filled on up to `threads` workers.
+            void selectLandmarks(size_t count, size_t threads = 0);
+            size_t landmarkCount() const { return landmarks.size(); }
+            const vector<size_t>& getLandmarks() const { return landmarks; }
+            void saveLandmarks(const string& path) const;
+            // Throws invalid_argument if the file was written for a graph of another size.
+            void loadLandmarks(const string& path);
+    };
+}
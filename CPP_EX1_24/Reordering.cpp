@@ -0,0 +1,87 @@
+#include "Reordering.hpp"
+#include <algorithm>
+
+using namespace std;
+
+namespace ariel {
+namespace {
+    template <typename Adjacency>
+    vector<size_t> degrees(const Adjacency& adj) {
+        vector<size_t> degree(adj.size(), 0);
+        for (size_t u = 0; u < adj.size(); u++) {
+            for (typename Adjacency::Cursor it = adj.neighbors(u); it.valid(); it.next()) degree[u]++;
+        }
+        return degree;
+    }
+
+    vector<size_t> byDegree(const vector<size_t>& degree, bool descending) {
+        vector<size_t> order(degree.size());
+        for (size_t v = 0; v < order.size(); v++) order[v] = v;
+        stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return descending ? degree[a] > degree[b] : degree[a] < degree[b];
+        });
+        return order;
+    }
+
+    // Breadth-first numbering that starts a new tree at each unvisited vertex of
+    // `starts`. With `degree` set, the neighbours of a vertex are queued in
+    // increasing degree (Cuthill-McKee); otherwise in stored order.
+    template <typename Adjacency>
+    vector<size_t> breadthFirst(const Adjacency& adj, const vector<size_t>& starts, const vector<size_t>* degree) {
+        vector<size_t> order;
+        order.reserve(adj.size());
+        vector<bool> placed(adj.size(), false);
+        vector<size_t> neighbours;
+        for (size_t s = 0; s < starts.size(); s++) {
+            if (placed[starts[s]]) continue;
+            placed[starts[s]] = true;
+            order.push_back(starts[s]);
+            for (size_t head = order.size() - 1; head < order.size(); head++) {
+                neighbours.clear();
+                for (typename Adjacency::Cursor it = adj.neighbors(order[head]); it.valid(); it.next()) {
+                    if (!placed[it.target()]) {
+                        placed[it.target()] = true;
+                        neighbours.push_back(it.target());
+                    }
+                }
+                if (degree != nullptr) {
+                    stable_sort(neighbours.begin(), neighbours.end(), [&](size_t a, size_t b) { return (*degree)[a] < (*degree)[b]; });
+                }
+                order.insert(order.end(), neighbours.begin(), neighbours.end());
+            }
+        }
+        return order;
+    }
+
+    template <typename Adjacency>
+    vector<size_t> orderOf(const Adjacency& adj, VertexOrder order) {
+        if (order == VertexOrder::BFS) {
+            vector<size_t> starts(adj.size());
+            for (size_t v = 0; v < starts.size(); v++) starts[v] = v;
+            return breadthFirst(adj, starts, nullptr);
+        }
+        vector<size_t> degree = degrees(adj);
+        if (order == VertexOrder::DegreeSort) return byDegree(degree, true);
+        vector<size_t> numbering = breadthFirst(adj, byDegree(degree, false), &degree);
+        reverse(numbering.begin(), numbering.end());
+        return numbering;
+    }
+}
+
+    string orderName(VertexOrder order) {
+        switch (order) {
+            case VertexOrder::DegreeSort: return "degree";
+            case VertexOrder::BFS: return "bfs";
+            default: return "rcm";
+        }
+    }
+
+    vector<size_t> vertexOrder(const GraphView& g, VertexOrder order) {
+        switch (g.getStorage()) {
+            case Storage::Sparse: return orderOf(g.sparseView(), order);
+            case Storage::Compressed: return orderOf(g.compressedView(), order);
+            case Storage::Bitset: return orderOf(g.bitsetView(), order);
+            default: return orderOf(g.denseView(), order);
+        }
+    }
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "GraphView.hpp"
+#include <string>
+#include <vector>
+using namespace std;
+
+namespace ariel {
+    // Vertex numberings that put vertices visited together next to each other
+    // in memory (see Graph::reorder).
+    // - DegreeSort: highest degree first, so the hubs most searches touch share
+    //   a few cache lines.
+    // - BFS: breadth-first order from the lowest unvisited vertex of each component.
+    // - ReverseCuthillMcKee: BFS from a minimum-degree vertex of each component,
+    //   neighbours in increasing degree, then reversed; keeps the edges close to
+    //   the diagonal of the matrix.
+    enum class VertexOrder { DegreeSort, BFS, ReverseCuthillMcKee };
+
+    string orderName(VertexOrder order);
+
+    // The new numbering as order[newId] = oldId. Every stored edge counts, in the
+    // direction it is stored, so a directed graph is walked along its out-edges.
+    vector<size_t> vertexOrder(const GraphView& g, VertexOrder order);
+}
@@ -0,0 +1,315 @@
+#include "StronglyConnectedComponents.hpp"
+#include "Parallel.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+
+using namespace std;
+
+namespace ariel {
+namespace {
+    const size_t NONE = numeric_limits<size_t>::max();
+    const size_t CHUNK = 256;
+    // Forward-backward hands the rest to Tarjan below this many open vertices or after this many rounds.
+    const size_t SMALL_REST = 4096;
+    const size_t MAX_ROUNDS = 64;
+    const uint8_t FORWARD = 1;
+    const uint8_t BACKWARD = 2;
+
+    // Rows in loaded order with loaded targets, so components of a reordered graph use the loaded ids.
+    template <typename Adjacency>
+    void copyRows(const GraphView& g, const Adjacency& adj, vector<size_t>& offsets, vector<size_t>& targets) {
+        offsets.assign(adj.size() + 1, 0);
+        for (size_t u = 0; u < adj.size(); u++) {
+            for (typename Adjacency::Cursor it = adj.neighbors(g.internalId(u)); it.valid(); it.next()) {
+                if (it.weight() > 0) targets.push_back(g.originalId(it.target()));
+            }
+            offsets[u + 1] = targets.size();
+        }
+    }
+
+    void transpose(const vector<size_t>& offsets, const vector<size_t>& targets,
+                   vector<size_t>& reverseOffsets, vector<size_t>& reverseTargets) {
+        size_t n = offsets.size() - 1;
+        reverseOffsets.assign(n + 1, 0);
+        for (size_t k = 0; k < targets.size(); k++) reverseOffsets[targets[k] + 1]++;
+        for (size_t v = 0; v < n; v++) reverseOffsets[v + 1] += reverseOffsets[v];
+        reverseTargets.resize(targets.size());
+        vector<size_t> fill(reverseOffsets.begin(), reverseOffsets.end() - 1);
+        for (size_t u = 0; u < n; u++) {
+            for (size_t k = offsets[u]; k < offsets[u + 1]; k++) reverseTargets[fill[targets[k]]++] = u;
+        }
+    }
+
+    // State of one forward-backward decomposition. A vertex is open while its
+    // label is NONE; open vertices in different parts never share a component.
+    struct Split {
+        const vector<size_t>& outOffsets;
+        const vector<size_t>& outTargets;
+        const vector<size_t>& inOffsets;
+        const vector<size_t>& inTargets;
+        size_t threads;
+        vector<size_t>& label;
+        size_t& next;
+        vector<size_t> part;
+        vector<size_t> open;
+        vector<atomic<uint8_t>> marks;
+        vector<size_t> outDegree, inDegree;
+
+        Split(const vector<size_t>& outOff, const vector<size_t>& outTgt, const vector<size_t>& inOff, const vector<size_t>& inTgt,
+              size_t threadCount, vector<size_t>& labels, size_t& nextLabel)
+            : outOffsets(outOff), outTargets(outTgt), inOffsets(inOff), inTargets(inTgt), threads(threadCount),
+              label(labels), next(nextLabel), part(labels.size(), 0), marks(labels.size()),
+              outDegree(labels.size(), 0), inDegree(labels.size(), 0) {
+            for (size_t v = 0; v < label.size(); v++) {
+                marks[v].store(0, memory_order_relaxed);
+                if (label[v] == NONE) open.push_back(v);
+            }
+        }
+
+        bool sameOpenPart(size_t v, size_t w) const { return label[w] == NONE && part[w] == part[v]; }
+
+        // Peels every open vertex with no in- or out-edge inside its part into a
+        // singleton component, and the vertices that exposes, then drops the
+        // finished vertices from `open`.
+        void trim() {
+            size_t blocks = (open.size() + CHUNK - 1) / CHUNK;
+            parallelFor(blocks, threads, [&](size_t block) {
+                size_t end = min(open.size(), (block + 1) * CHUNK);
+                for (size_t k = block * CHUNK; k < end; k++) {
+                    size_t v = open[k];
+                    size_t out = 0, in = 0;
+                    for (size_t e = outOffsets[v]; e < outOffsets[v + 1]; e++) out += static_cast<size_t>(sameOpenPart(v, outTargets[e]));
+                    for (size_t e = inOffsets[v]; e < inOffsets[v + 1]; e++) in += static_cast<size_t>(sameOpenPart(v, inTargets[e]));
+                    outDegree[v] = out;
+                    inDegree[v] = in;
+                }
+            });
+            vector<size_t> peel;
+            for (size_t k = 0; k < open.size(); k++) {
+                if (outDegree[open[k]] == 0 || inDegree[open[k]] == 0) peel.push_back(open[k]);
+            }
+            while (!peel.empty()) {
+                size_t v = peel.back();
+                peel.pop_back();
+                if (label[v] != NONE) continue;
+                label[v] = next++;
+                for (size_t e = outOffsets[v]; e < outOffsets[v + 1]; e++) {
+                    size_t w = outTargets[e];
+                    if (sameOpenPart(v, w) && --inDegree[w] == 0) peel.push_back(w);
+                }
+                for (size_t e = inOffsets[v]; e < inOffsets[v + 1]; e++) {
+                    size_t w = inTargets[e];
+                    if (sameOpenPart(v, w) && --outDegree[w] == 0) peel.push_back(w);
+                }
+            }
+            size_t kept = 0;
+            for (size_t k = 0; k < open.size(); k++) {
+                if (label[open[k]] == NONE) open[kept++] = open[k];
+            }
+            open.resize(kept);
+        }
+
+        // Marks with `bit` everything the frontier reaches inside its own parts.
+        void reach(vector<size_t> frontier, const vector<size_t>& offsets, const vector<size_t>& targets, uint8_t bit) {
+            while (!frontier.empty()) {
+                size_t blocks = (frontier.size() + CHUNK - 1) / CHUNK;
+                vector<vector<size_t>> found(blocks);
+                parallelFor(blocks, threads, [&](size_t block) {
+                    size_t end = min(frontier.size(), (block + 1) * CHUNK);
+                    for (size_t k = block * CHUNK; k < end; k++) {
+                        size_t v = frontier[k];
+                        for (size_t e = offsets[v]; e < offsets[v + 1]; e++) {
+                            size_t w = targets[e];
+                            if (!sameOpenPart(v, w) || (marks[w].load(memory_order_relaxed) & bit) != 0) continue;
+                            if ((marks[w].fetch_or(bit, memory_order_relaxed) & bit) == 0) found[block].push_back(w);
+                        }
+                    }
+                });
+                frontier.clear();
+                for (size_t b = 0; b < blocks; b++) frontier.insert(frontier.end(), found[b].begin(), found[b].end());
+            }
+        }
+
+        // One forward-backward step on every open part at once. Trimming can
+        // empty a part, so the pivots number the remaining ones densely.
+        void round() {
+            size_t bound = 0;
+            for (size_t k = 0; k < open.size(); k++) bound = max(bound, part[open[k]] + 1);
+            vector<size_t> slot(bound, NONE), pivots;
+            for (size_t k = 0; k < open.size(); k++) {
+                size_t p = part[open[k]];
+                if (slot[p] != NONE) continue;
+                slot[p] = pivots.size();
+                pivots.push_back(open[k]);
+            }
+            for (size_t k = 0; k < pivots.size(); k++) marks[pivots[k]].store(FORWARD | BACKWARD, memory_order_relaxed);
+            reach(pivots, outOffsets, outTargets, FORWARD);
+            reach(pivots, inOffsets, inTargets, BACKWARD);
+
+            // Each pivot closes its component; the rest of its part splits in three.
+            vector<size_t> split(3 * bound, NONE);
+            size_t splitCount = 0;
+            vector<size_t> remaining;
+            for (size_t k = 0; k < open.size(); k++) {
+                size_t v = open[k];
+                uint8_t mark = marks[v].load(memory_order_relaxed);
+                marks[v].store(0, memory_order_relaxed);
+                if (mark == (FORWARD | BACKWARD)) {
+                    label[v] = next + slot[part[v]];
+                    continue;
+                }
+                size_t key = 3 * part[v] + (mark == FORWARD ? 0 : mark == BACKWARD ? 1 : 2);
+                if (split[key] == NONE) split[key] = splitCount++;
+                part[v] = split[key];
+                remaining.push_back(v);
+            }
+            next += pivots.size();
+            open.swap(remaining);
+        }
+    };
+}
+
+    StronglyConnectedComponents::StronglyConnectedComponents(const GraphView& g, size_t threads) : n(g.size()) {
+        switch (g.getStorage()) {
+            case Storage::Sparse: copyRows(g, g.sparseView(), outOffsets, outTargets); break;
+            case Storage::Compressed: copyRows(g, g.compressedView(), outOffsets, outTargets); break;
+            case Storage::Bitset: copyRows(g, g.bitsetView(), outOffsets, outTargets); break;
+            default: copyRows(g, g.denseView(), outOffsets, outTargets);
+        }
+        transpose(outOffsets, outTargets, inOffsets, inTargets);
+        vector<size_t> label(n, NONE);
+        size_t count = 0;
+        if (threads != 1) forwardBackward(resolveThreads(threads), label, count);
+        tarjan(label, count);
+        number(label, count);
+    }
+
+    // Tarjan over the vertices that have no label yet. Labelled vertices are
+    // finished components, so edges into them are skipped; that also makes
+    // "visited and unlabelled" the same as "on the component stack".
+    void StronglyConnectedComponents::tarjan(vector<size_t>& label, size_t& next) const {
+        vector<size_t> index(n, NONE), low(n, NONE);
+        vector<size_t> stack;
+        vector<pair<size_t, size_t>> calls;  // (vertex, next edge to scan)
+        size_t counter = 0;
+        for (size_t root = 0; root < n; root++) {
+            if (label[root] != NONE || index[root] != NONE) continue;
+            index[root] = low[root] = counter++;
+            stack.push_back(root);
+            calls.push_back(make_pair(root, outOffsets[root]));
+            while (!calls.empty()) {
+                size_t v = calls.back().first;
+                size_t& edge = calls.back().second;
+                if (edge < outOffsets[v + 1]) {
+                    size_t w = outTargets[edge++];
+                    if (label[w] != NONE) continue;
+                    if (index[w] == NONE) {
+                        index[w] = low[w] = counter++;
+                        stack.push_back(w);
+                        calls.push_back(make_pair(w, outOffsets[w]));
+                    } else {
+                        low[v] = min(low[v], index[w]);
+                    }
+                    continue;
+                }
+                calls.pop_back();
+                if (!calls.empty()) {
+                    size_t parent = calls.back().first;
+                    low[parent] = min(low[parent], low[v]);
+                }
+                if (low[v] != index[v]) continue;
+                size_t w;
+                do {
+                    w = stack.back();
+                    stack.pop_back();
+                    label[w] = next;
+                } while (w != v);
+                next++;
+            }
+        }
+    }
+
+    void StronglyConnectedComponents::forwardBackward(size_t threads, vector<size_t>& label, size_t& next) const {
+        Split split(outOffsets, outTargets, inOffsets, inTargets, threads, label, next);
+        split.trim();
+        for (size_t rounds = 0; split.open.size() >= SMALL_REST && rounds < MAX_ROUNDS; rounds++) {
+            split.round();
+            split.trim();
+        }
+    }
+
+    // Renumbers the components in topological order of the condensation, taking
+    // the component with the smallest vertex among those ready, and builds the DAG.
+    void StronglyConnectedComponents::number(const vector<size_t>& label, size_t count) {
+        vector<pair<size_t, size_t>> arcs;
+        for (size_t u = 0; u < n; u++) {
+            for (size_t e = outOffsets[u]; e < outOffsets[u + 1]; e++) {
+                if (label[u] != label[outTargets[e]]) arcs.push_back(make_pair(label[u], label[outTargets[e]]));
+            }
+        }
+        sort(arcs.begin(), arcs.end());
+        arcs.erase(unique(arcs.begin(), arcs.end()), arcs.end());
+
+        vector<size_t> smallest(count, NONE), inArcs(count, 0), firstArc(count + 1, 0);
+        for (size_t v = 0; v < n; v++) {
+            if (smallest[label[v]] == NONE) smallest[label[v]] = v;
+        }
+        for (size_t k = 0; k < arcs.size(); k++) {
+            inArcs[arcs[k].second]++;
+            firstArc[arcs[k].first + 1]++;
+        }
+        for (size_t c = 0; c < count; c++) firstArc[c + 1] += firstArc[c];
+
+        priority_queue<pair<size_t, size_t>, vector<pair<size_t, size_t>>, greater<pair<size_t, size_t>>> ready;
+        for (size_t c = 0; c < count; c++) {
+            if (inArcs[c] == 0) ready.push(make_pair(smallest[c], c));
+        }
+        vector<size_t> id(count);
+        size_t placed = 0;
+        while (!ready.empty()) {
+            size_t c = ready.top().second;
+            ready.pop();
+            id[c] = placed++;
+            for (size_t k = firstArc[c]; k < firstArc[c + 1]; k++) {
+                if (--inArcs[arcs[k].second] == 0) ready.push(make_pair(smallest[arcs[k].second], arcs[k].second));
+            }
+        }
+
+        componentOf.resize(n);
+        sizes.assign(count, 0);
+        for (size_t v = 0; v < n; v++) {
+            componentOf[v] = id[label[v]];
+            sizes[componentOf[v]]++;
+        }
+        for (size_t k = 0; k < arcs.size(); k++) arcs[k] = make_pair(id[arcs[k].first], id[arcs[k].second]);
+        sort(arcs.begin(), arcs.end());
+        dagOffsets.assign(count + 1, 0);
+        dagTargets.resize(arcs.size());
+        for (size_t k = 0; k < arcs.size(); k++) {
+            dagOffsets[arcs[k].first + 1]++;
+            dagTargets[k] = arcs[k].second;
+        }
+        for (size_t c = 0; c < count; c++) dagOffsets[c + 1] += dagOffsets[c];
+    }
+
+    size_t StronglyConnectedComponents::component(size_t v) const {
+        if (v >= n) {
+            throw invalid_argument("Invalid vertex: The vertex is not in the graph.");
+        }
+        return componentOf[v];
+    }
+
+    vector<size_t> StronglyConnectedComponents::successors(size_t c) const {
+        if (c >= sizes.size()) {
+            throw invalid_argument("Invalid component: The component is not in the graph.");
+        }
+        return vector<size_t>(dagTargets.begin() + static_cast<ptrdiff_t>(dagOffsets[c]),
+                              dagTargets.begin() + static_cast<ptrdiff_t>(dagOffsets[c + 1]));
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "GraphView.hpp"
+#include <vector>
+using namespace std;
+
+namespace ariel {
+    // Strongly connected components of a directed graph over its positive-weight
+    // edges (the edges the traversals follow), with the condensation DAG. The
+    // constructor copies the edges into forward and reverse CSR arrays and
+    // decomposes the graph in O(V + E):
+    //
+    // - threads = 1 runs Tarjan's algorithm with an explicit stack, so deep graphs
+    //   cannot overflow the call stack.
+    // - Any other value (0 = all hardware threads) runs the forward-backward
+    //   decomposition. Vertices with no in- or out-edges are trimmed as
+    //   singletons. Then every open part picks a pivot. The vertices both
+    //   reachable from it and reaching it are its component. The rest splits
+    //   into forward-only, backward-only and untouched parts, which cannot share
+    //   a component. All parts of a round search together in one parallel
+    //   level-synchronous BFS. When the parts get small, Tarjan finishes them.
+    //
+    // Component ids do not depend on the variant. They are a topological order of
+    // the condensation (every DAG edge goes from a lower id to a higher one), ties
+    // broken by the smallest vertex of each component.
+    class StronglyConnectedComponents {
+        private:
+            size_t n;
+            vector<size_t> outOffsets, outTargets;
+            vector<size_t> inOffsets, inTargets;
+            vector<size_t> componentOf;
+            vector<size_t> sizes;
+            vector<size_t> dagOffsets, dagTargets;
+
+            void tarjan(vector<size_t>& label, size_t& next) const;
+            void forwardBackward(size_t threads, vector<size_t>& label, size_t& next) const;
+            void number(const vector<size_t>& label, size_t count);
+
+        public:
+            explicit StronglyConnectedComponents(const GraphView& g, size_t threads = 1);
+
+            size_t size() const { return n; }
+            size_t componentCount() const { return sizes.size(); }
+            // Every vertex reaches every other one (true for 0 or 1 vertices).
+            bool isStronglyConnected() const { return sizes.size() <= 1; }
+            size_t component(size_t v) const;
+            const vector<size_t>& components() const { return componentOf; }
+            const vector<size_t>& componentSizes() const { return sizes; }
+
+            // The condensation as CSR: the successors of component c are
+            // dagTargets[dagOffsets[c] .. dagOffsets[c + 1]), sorted and without repeats.
+            size_t condensationEdgeCount() const { return dagTargets.size(); }
+            vector<size_t> successors(size_t c) const;
+            const vector<size_t>& getDagOffsets() const { return dagOffsets; }
+            const vector<size_t>& getDagTargets() const { return dagTargets; }
+    };
+}
@@ -1,6 +1,17 @@
 #include "doctest.h"
 #include "Algorithms.hpp"
 #include "Graph.hpp"
+#include "IndexedHeap.hpp"
+#include "FlatMatrix.hpp"
+#include "PathSearch.hpp"
+#include "ContractionHierarchy.hpp"
+#include "ConnectedComponents.hpp"
+#include "StronglyConnectedComponents.hpp"
+#include "Generators.hpp"
+#include "Instrumentation.hpp"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
 
 using namespace ariel;
 using namespace std;
@@ -322,3 +333,1438 @@ TEST_CASE("Test loading graph with negative weights") {
     g.loadGraph(graph);
     CHECK(Algorithms::isConnected(g) == false);
 }
+
+TEST_CASE("Test sparse storage keeps graph metadata") {
+    Graph g;
+    vector<vector<int>> graph = {
+        {0, 1, 0},
+        {0, 0, 1},
+        {1, 0, 0}};
+    g.loadGraph(graph, Storage::Sparse);
+    CHECK(g.getStorage() == Storage::Sparse);
+    CHECK(g.getIsDirected() == true);
+    CHECK(g.getNumOfVertices() == 3);
+    CHECK(g.getRowOffsets() == vector<size_t>({0, 1, 2, 3}));
+    CHECK(g.getColIndices() == vector<size_t>({1, 2, 0}));
+    CHECK_THROWS(g.getMatrixGraph());
+}
+
+TEST_CASE("Test sparse storage gives the same answers as dense storage") {
+    vector<vector<int>> graph = {
+        {0, 1, 2, 0, 0},
+        {1, 0, 3, 0, 0},
+        {2, 3, 0, 4, 0},
+        {0, 0, 4, 0, 5},
+        {0, 0, 0, 5, 0}};
+    Graph dense, sparse;
+    dense.loadGraph(graph);
+    sparse.loadGraph(graph, Storage::Sparse);
+    CHECK(sparse.getIsDirected() == false);
+    CHECK(Algorithms::isConnected(sparse) == Algorithms::isConnected(dense));
+    CHECK(Algorithms::shortestPath(sparse, 0, 4) == "0->2->3->4");
+    CHECK(Algorithms::isContainsCycle(sparse) == Algorithms::isContainsCycle(dense));
+    CHECK(Algorithms::isBipartite(sparse) == Algorithms::isBipartite(dense));
+
+    vector<vector<int>> even = {
+        {0, 1, 0, 1},
+        {1, 0, 1, 0},
+        {0, 1, 0, 1},
+        {1, 0, 1, 0}};
+    sparse.loadGraph(even, Storage::Sparse);
+    CHECK(Algorithms::isBipartite(sparse) == "The graph is bipartite: A={0, 2}, B={1, 3}");
+}
+
+TEST_CASE("Test sparse storage on a disconnected graph") {
+    Graph g;
+    vector<vector<int>> graph = {
+        {0, 1, 1, 0, 0},
+        {1, 0, 1, 0, 0},
+        {1, 1, 0, 1, 0},
+        {0, 0, 1, 0, 0},
+        {0, 0, 0, 0, 0}};
+    g.loadGraph(graph, Storage::Sparse);
+    CHECK(Algorithms::isConnected(g) == false);
+    CHECK(Algorithms::shortestPath(g, 0, 4) == "-1");
+    CHECK(Algorithms::isContainsCycle(g) == true);
+    CHECK(Algorithms::isBipartite(g) == "0");
+    CHECK_THROWS(Algorithms::shortestPath(g, 0, 5));
+}
+
+TEST_CASE("Test shortestPath picks the cheaper of two routes") {
+    Graph g;
+    vector<vector<int>> graph = {
+        {0, 10, 1, 0},
+        {10, 0, 0, 1},
+        {1, 0, 0, 1},
+        {0, 1, 1, 0}};
+    g.loadGraph(graph);
+    CHECK(Algorithms::shortestPath(g, 0, 1) == "0->2->3->1");
+    CHECK(Algorithms::shortestPath(g, 0, 2) == "0->2");
+    CHECK(Algorithms::shortestPath(g, 3, 3) == "3");
+    g.loadGraph(graph, Storage::Sparse);
+    CHECK(Algorithms::shortestPath(g, 0, 1) == "0->2->3->1");
+}
+
+TEST_CASE("Test indexed heap orders keys and supports decrease-key") {
+    IndexedHeap<int> heap(5);
+    heap.push(0, 7);
+    heap.push(1, 3);
+    heap.push(2, 9);
+    heap.push(3, 5);
+    heap.push(2, 1);  // decrease-key
+    heap.push(1, 8);  // larger key is ignored
+    CHECK(heap.size() == 4);
+    CHECK(heap.pop() == 2);
+    CHECK(heap.pop() == 1);
+    CHECK(heap.pop() == 3);
+    CHECK(heap.pop() == 0);
+    CHECK(heap.empty());
+    CHECK_THROWS(heap.pop());
+}
+
+TEST_CASE("Test batch shortestPaths matches single queries") {
+    Graph g;
+    vector<vector<int>> graph = {
+        {0, 1, 2, 0, 0, 0},
+        {1, 0, 3, 0, 0, 0},
+        {2, 3, 0, 4, 0, 0},
+        {0, 0, 4, 0, 5, 0},
+        {0, 0, 0, 5, 0, 0},
+        {0, 0, 0, 0, 0, 0}};
+    g.loadGraph(graph);
+    vector<pair<size_t, size_t>> queries = {{0, 4}, {3, 1}, {0, 1}, {4, 5}, {0, 0}, {3, 0}};
+    vector<PathResult> results = Algorithms::shortestPaths(g, queries, 3);
+    REQUIRE(results.size() == queries.size());
+    CHECK(results[0].path == vector<size_t>({0, 2, 3, 4}));
+    CHECK(results[0].distance == 11);
+    CHECK(results[1].src == 3);
+    CHECK(results[1].dest == 1);
+    CHECK(results[2].distance == 1);
+    CHECK(results[3].reachable == false);
+    CHECK(results[3].distance == -1);
+    CHECK(results[4].path == vector<size_t>({0}));
+    g.loadGraph(graph, Storage::Sparse);
+    vector<PathResult> sparseResults = Algorithms::shortestPaths(g, queries);
+    for (size_t i = 0; i < queries.size(); i++) {
+        CHECK(sparseResults[i].distance == results[i].distance);
+        CHECK(sparseResults[i].path == results[i].path);
+    }
+    CHECK_THROWS(Algorithms::shortestPaths(g, {{0, 6}}));
+}
+
+TEST_CASE("Test graph views share the graph storage") {
+    Graph g;
+    vector<vector<int>> graph = {
+        {0, 1, 0},
+        {1, 0, 1},
+        {0, 1, 0}};
+    g.loadGraph(graph);
+    const Graph& shared = g;
+    GraphView view = shared.view();
+    CHECK(view.getStorage() == Storage::Dense);
+    CHECK(view.size() == 3);
+    CHECK(view.isDirected() == false);
+    CHECK(view.denseView().row(1) == g.row(1));
+    CHECK(g.getRowStride() % 16 == 0);
+    CHECK(reinterpret_cast<uintptr_t>(g.row(2)) % 64 == 0);
+    CHECK(view.denseView().weight(1, 2) == 1);
+    CHECK(Algorithms::isConnected(view) == true);
+    CHECK(Algorithms::shortestPath(shared, 0, 2) == "0->1->2");
+    for (Storage mode : {Storage::Sparse, Storage::Bitset, Storage::Compressed}) {
+        Graph other;
+        other.loadGraph(graph, mode);
+        CHECK_THROWS_AS(other.row(1), logic_error);
+        CHECK_THROWS_AS(other.getRowStride(), logic_error);
+    }
+
+    vector<bool> visited(3, false);
+    Algorithms::DFS(2, visited, view);
+    CHECK(visited == vector<bool>({true, true, true}));
+
+    g.loadGraph(graph, Storage::Sparse);
+    view = shared.view();
+    CHECK(view.getStorage() == Storage::Sparse);
+    CHECK(view.sparseView().degree(1) == 2);
+    CHECK(Algorithms::isBipartite(view) == "The graph is bipartite: A={0, 2}, B={1}");
+}
+
+TEST_CASE("Test findCycle reports the cycle it found") {
+    Graph g;
+    vector<vector<int>> graph = {
+        {0, 1, 1, 0, 0},
+        {1, 0, 1, 0, 0},
+        {1, 1, 0, 1, 0},
+        {0, 0, 1, 0, 0},
+        {0, 0, 0, 0, 0}};
+    g.loadGraph(graph);
+    CHECK(Algorithms::findCycle(g) == vector<size_t>({0, 1, 2, 0}));
+
+    vector<vector<int>> directed = {
+        {0, 1, 0, 0},
+        {0, 0, 1, 0},
+        {0, 0, 0, 1},
+        {0, 1, 0, 0}};
+    g.loadGraph(directed, Storage::Sparse);
+    CHECK(Algorithms::findCycle(g) == vector<size_t>({1, 2, 3, 1}));
+
+    vector<vector<int>> tree = {
+        {0, 1, 1},
+        {1, 0, 0},
+        {1, 0, 0}};
+    g.loadGraph(tree);
+    CHECK(Algorithms::findCycle(g).empty());
+}
+
+TEST_CASE("Test DFS-based algorithms on a million-vertex chain") {
+    const size_t n = 1000000;
+    vector<size_t> offsets(n + 1, 0), cols;
+    for (size_t u = 0; u < n; u++) {
+        if (u > 0) cols.push_back(u - 1);
+        if (u + 1 < n) cols.push_back(u + 1);
+        offsets[u + 1] = cols.size();
+    }
+    vector<int> weights(cols.size(), 1);
+    GraphView chain(SparseView(offsets.data(), cols.data(), weights.data(), n), false);
+    CHECK(Algorithms::isConnected(chain) == true);
+    CHECK(Algorithms::isContainsCycle(chain) == false);
+
+    // Directed ring 0 -> 1 -> ... -> n-1 -> 0.
+    vector<size_t> ringOffsets(n + 1, 0), ringCols(n);
+    for (size_t u = 0; u < n; u++) {
+        ringCols[u] = (u + 1) % n;
+        ringOffsets[u + 1] = u + 1;
+    }
+    vector<int> ringWeights(n, 1);
+    GraphView ring(SparseView(ringOffsets.data(), ringCols.data(), ringWeights.data(), n), true);
+    vector<size_t> cycle = Algorithms::findCycle(ring);
+    CHECK(cycle.size() == n + 1);
+    CHECK(cycle.front() == 0);
+    CHECK(cycle.back() == 0);
+}
+
+TEST_CASE("Test bitset storage matches the matrix answers") {
+    vector<vector<int>> graph = {
+        {0, 1, 2, 0, 0},
+        {1, 0, 3, 0, 0},
+        {2, 3, 0, 4, 0},
+        {0, 0, 4, 0, 5},
+        {0, 0, 0, 5, 0}};
+    Graph g;
+    g.loadGraph(graph, Storage::Bitset);
+    CHECK(g.getStorage() == Storage::Bitset);
+    CHECK(g.getIsDirected() == false);
+    CHECK(Algorithms::isConnected(g) == true);
+    CHECK(Algorithms::isContainsCycle(g) == true);
+    CHECK(Algorithms::isBipartite(g) == "0");
+    CHECK(Algorithms::shortestPath(g, 0, 4) == "0->2->3->4");
+
+    vector<vector<int>> even = {
+        {0, 1, 0, 1},
+        {1, 0, 1, 0},
+        {0, 1, 0, 1},
+        {1, 0, 1, 0}};
+    g.loadGraph(even, Storage::Bitset);
+    CHECK(Algorithms::isBipartite(g) == "The graph is bipartite: A={0, 2}, B={1, 3}");
+
+    vector<vector<int>> directed = {
+        {0, 1, 0},
+        {0, 0, 1},
+        {0, 0, 0}};
+    g.loadGraph(directed, Storage::Bitset);
+    CHECK(g.getIsDirected() == true);
+    CHECK(Algorithms::isContainsCycle(g) == false);
+
+    // Negative weights have no bit: loads and updates reject them, and the graph stays as it was.
+    vector<vector<int>> negative = {
+        {0, 1, 0},
+        {0, 0, -2},
+        {0, 0, 0}};
+    CHECK_THROWS_AS(g.loadGraph(negative, Storage::Bitset), invalid_argument);
+    CHECK(g.getWeight(1, 2) == 1);
+    CHECK_THROWS_AS(g.setWeight(0, 2, -1), invalid_argument);
+    vector<EdgeEntry> batch = {{0, 2, 1}, {2, 0, -1}};
+    CHECK_THROWS_AS(g.applyUpdates(batch), invalid_argument);
+    CHECK(g.getWeight(0, 2) == 0);
+    CHECK(g.getNumOfEdges() == 2);
+    g.loadGraph(negative, Storage::Sparse);
+    CHECK(g.getWeight(1, 2) == -2);
+}
+
+TEST_CASE("Test bitset storage across several words per row") {
+    const size_t n = 130;
+    vector<vector<int>> path(n, vector<int>(n, 0));
+    for (size_t i = 0; i + 1 < n; i++) {
+        path[i][i + 1] = path[i + 1][i] = 7;
+    }
+    Graph g;
+    g.loadGraph(path, Storage::Bitset);
+    CHECK(g.view().bitsetView().wordsPerRow() == 3);
+    CHECK(Algorithms::isConnected(g) == true);
+    CHECK(Algorithms::isContainsCycle(g) == false);
+    CHECK(Algorithms::isBipartite(g).find("B={1, 3, 5") != string::npos);
+
+    path[128][129] = path[129][128] = 0;
+    g.loadGraph(path, Storage::Bitset);
+    CHECK(Algorithms::isConnected(g) == false);
+
+    path[0][n - 2] = path[n - 2][0] = 1;  // closes an odd cycle 0..128
+    g.loadGraph(path, Storage::Bitset);
+    CHECK(Algorithms::isBipartite(g) == "0");
+    CHECK(Algorithms::findCycle(g).size() == n);
+    Graph dense;
+    dense.loadGraph(path);
+    CHECK(g.getIsDirected() == false);
+    CHECK(g.getNumOfEdges() == dense.getNumOfEdges());
+
+    // One-way cells inside a diagonal block, in an off-diagonal block (both
+    // sides of the diagonal) and in the partial last block.
+    const size_t oneWay[][2] = {{3, 40}, {40, 3}, {10, 100}, {100, 10}, {129, 65}, {128, 129}};
+    for (size_t k = 0; k < sizeof(oneWay) / sizeof(oneWay[0]); k++) {
+        int& cell = path[oneWay[k][0]][oneWay[k][1]];
+        int saved = cell;
+        cell = cell != 0 ? 0 : 1;
+        g.loadGraph(path, Storage::Bitset);
+        CHECK(g.getIsDirected() == true);
+        cell = saved;
+    }
+}
+
+TEST_CASE("Test parallel BFS versions of isConnected and isBipartite") {
+    Graph g;
+    vector<vector<int>> graph = {
+        {0, 1, 1, 0, 0},
+        {1, 0, 1, 0, 0},
+        {1, 1, 0, 1, 0},
+        {0, 0, 1, 0, 0},
+        {0, 0, 0, 0, 0}};
+    g.loadGraph(graph);
+    CHECK(Algorithms::isConnected(g, 4) == false);
+    CHECK(Algorithms::isBipartite(g, 4) == "0");
+
+    vector<vector<int>> even = {
+        {0, 1, 0, 1},
+        {1, 0, 1, 0},
+        {0, 1, 0, 1},
+        {1, 0, 1, 0}};
+    g.loadGraph(even, Storage::Sparse);
+    CHECK(Algorithms::isConnected(g, 2) == true);
+    CHECK(Algorithms::isBipartite(g, 2) == "The graph is bipartite: A={0, 2}, B={1, 3}");
+
+    // A wide star makes the engine switch to bottom-up steps.
+    const size_t n = 200;
+    vector<vector<int>> star(n, vector<int>(n, 0));
+    for (size_t i = 1; i < n; i++) star[0][i] = star[i][0] = 1;
+    for (size_t i = 1; i + 1 < n; i += 2) star[i][i + 1] = star[i + 1][i] = 1;
+    for (size_t threads = 1; threads <= 4; threads++) {
+        g.loadGraph(star, Storage::Sparse);
+        CHECK(Algorithms::isConnected(g, threads) == true);
+        CHECK(Algorithms::isBipartite(g, threads) == "0");
+        g.loadGraph(star, Storage::Bitset);
+        CHECK(Algorithms::isConnected(g, threads) == true);
+    }
+
+    // A hundred pairs are expanded by one thread, then a directed star hands its
+    // wide second level to the team; all in one run.
+    const size_t m = 800;
+    vector<vector<int>> mixed(m, vector<int>(m, 0));
+    for (size_t i = 0; i + 1 < 200; i += 2) mixed[i][i + 1] = mixed[i + 1][i] = 1;
+    for (size_t i = 201; i < m; i++) mixed[200][i] = 1;
+    for (Storage mode : {Storage::Dense, Storage::Sparse}) {
+        g.loadGraph(mixed, mode);
+        string expected = Algorithms::isBipartite(g);
+        CHECK(expected != "0");
+        for (size_t threads = 2; threads <= 4; threads++) {
+            CHECK(Algorithms::isConnected(g, threads) == false);
+            CHECK(Algorithms::isBipartite(g, threads) == expected);
+        }
+    }
+
+    vector<vector<int>> directed = {
+        {0, 1, 0},
+        {0, 0, 1},
+        {0, 0, 0}};
+    g.loadGraph(directed);
+    CHECK(Algorithms::isConnected(g, 3) == Algorithms::isConnected(g));
+    CHECK(Algorithms::isBipartite(g, 3) == Algorithms::isBipartite(g));
+}
+
+TEST_CASE("Test blocked classification across tile boundaries") {
+    const size_t n = 150;
+    vector<vector<int>> graph(n, vector<int>(n, 0));
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = i + 1; j < n; j += 7) {
+            graph[i][j] = graph[j][i] = static_cast<int>(1 + (i + j) % 5);
+        }
+    }
+    graph[3][3] = 2;  // self-loops are not counted for undirected graphs
+    Graph g;
+    g.loadGraph(graph);
+    size_t offDiagonal = 0;
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < n; j++) {
+            if (i != j && graph[i][j] != 0) offDiagonal++;
+        }
+    }
+    CHECK(g.getIsDirected() == false);
+    CHECK(g.getNumOfEdges() == static_cast<int>(offDiagonal));
+
+    graph[130][10] = graph[10][130] + 1;  // only the weights differ
+    g.loadGraph(graph);
+    CHECK(g.getIsDirected() == true);
+    CHECK(g.getNumOfEdges() == static_cast<int>(offDiagonal + 1));
+
+    graph[130][10] = 0;
+    g.loadGraph(graph);
+    CHECK(g.getIsDirected() == true);
+    CHECK(g.getNumOfEdges() == static_cast<int>(offDiagonal));
+}
+
+TEST_CASE("Test flat matrix layout") {
+    vector<vector<int>> rows = {
+        {0, 1, 2},
+        {3, 0, 4},
+        {5, 6, 0}};
+    FlatMatrix m(rows);
+    CHECK(m.size() == 3);
+    CHECK(m.rowStride() == 16);
+    CHECK(m.row(1) == m.data() + 16);
+    CHECK(m.at(2, 1) == 6);
+    CHECK(m.row(0)[3] == 0);  // padding
+    FlatMatrix copy(m);
+    copy.at(0, 1) = 9;
+    CHECK(m.at(0, 1) == 1);
+    CHECK(copy.toVectors()[0] == vector<int>({0, 9, 2}));
+    m = copy;
+    CHECK(m.toVectors() == copy.toVectors());
+}
+
+TEST_CASE("Test binary graph file round trip") {
+    vector<vector<int>> graph = {
+        {0, 4, 0, 0},
+        {4, 0, 2, 0},
+        {0, 2, 0, 7},
+        {0, 0, 7, 0}};
+    const string path = "test_graph.bin";
+    for (Storage mode : {Storage::Dense, Storage::Sparse, Storage::Bitset}) {
+        Graph g;
+        g.loadGraph(graph, mode);
+        g.saveGraph(path);
+        Graph mapped;
+        mapped.openGraph(path);
+        CHECK(mapped.getStorage() == (mode == Storage::Dense ? Storage::Dense : Storage::Sparse));
+        CHECK(mapped.getNumOfVertices() == 4);
+        CHECK(mapped.getNumOfEdges() == 6);
+        CHECK(mapped.getIsDirected() == false);
+        CHECK(Algorithms::isConnected(mapped) == true);
+        CHECK(Algorithms::shortestPath(mapped, 0, 3) == "0->1->2->3");
+        Graph copy = mapped;  // shares the mapping
+        mapped.loadGraph(graph);
+        CHECK(Algorithms::isBipartite(copy) == "The graph is bipartite: A={0, 2}, B={1, 3}");
+    }
+    Graph g;
+    g.loadGraph(graph);
+    g.saveGraph(path);
+    g.openGraph(path);
+    CHECK(g.getMatrixGraph() == graph);
+    CHECK(reinterpret_cast<uintptr_t>(g.row(1)) % 64 == 0);
+    remove(path.c_str());
+
+    CHECK_THROWS(g.openGraph("no_such_graph.bin"));
+    FILE* file = fopen(path.c_str(), "wb");
+    fputs("not a graph file, just some text that is long enough for a header......", file);
+    fclose(file);
+    CHECK_THROWS_AS(g.openGraph(path), invalid_argument);
+    remove(path.c_str());
+}
+
+TEST_CASE("Test edge list loader") {
+    const string path = "test_edges.txt";
+    FILE* file = fopen(path.c_str(), "wb");
+    fputs("# u v w\n"
+          "0 1 4\n1 0 4\n"
+          "1 2 2\r\n2 1 2\n"
+          "\n"
+          "2\t3 9\n3 2 9\n"
+          "2 3 7\n3 2 7\n"   // overrides the weight 9 lines
+          "0 3\n3 0\n",      // no weight means 1
+          file);
+    fclose(file);
+    vector<vector<int>> graph = {
+        {0, 4, 0, 1},
+        {4, 0, 2, 0},
+        {0, 2, 0, 7},
+        {1, 0, 7, 0}};
+    Graph expected;
+    expected.loadGraph(graph);
+    for (Storage mode : {Storage::Dense, Storage::Sparse, Storage::Bitset}) {
+        for (size_t threads : {size_t(1), size_t(3)}) {
+            Graph g;
+            g.loadEdgeList(path, mode, threads);
+            CHECK(g.getStorage() == mode);
+            CHECK(g.getNumOfVertices() == 4);
+            CHECK(g.getIsDirected() == false);
+            CHECK(g.getNumOfEdges() == expected.getNumOfEdges());
+            CHECK(Algorithms::isContainsCycle(g) == true);
+        }
+    }
+    Graph g;
+    g.loadEdgeList(path, Storage::Dense);
+    CHECK(g.getMatrixGraph() == graph);
+    g.loadEdgeList(path);
+    CHECK(Algorithms::shortestPath(g, 0, 2) == "0->1->2");
+
+    file = fopen(path.c_str(), "wb");
+    fputs("0 1 5\n1 2 -3\n2 2 1\n", file);
+    fclose(file);
+    for (Storage mode : {Storage::Dense, Storage::Sparse}) {
+        g.loadEdgeList(path, mode);
+        CHECK(g.getIsDirected() == true);
+        CHECK(g.getNumOfEdges() == 3);
+    }
+    // A bit cannot keep the sign, so the load fails and leaves the graph as it was.
+    CHECK_THROWS_WITH(g.loadEdgeList(path, Storage::Bitset), "Invalid edge list: Bitset storage cannot hold the negative weights in test_edges.txt");
+    CHECK(g.getStorage() == Storage::Sparse);
+    CHECK(g.getNumOfEdges() == 3);
+
+    // A long row and a short one lose entries to overrides and zero weights,
+    // so the CSR rows are closed up after the sort.
+    file = fopen(path.c_str(), "wb");
+    for (int v = 1; v <= 40; v++) fprintf(file, "0 %d %d\n", v, v);
+    fputs("0 5 9\n0 7 0\n3 1 2\n3 1 4\n3 2 6\n3 2 0\n41 0 1\n", file);
+    fclose(file);
+    Graph cells;
+    cells.loadEdgeList(path, Storage::Dense);
+    g.loadEdgeList(path, Storage::Sparse, 3);
+    CHECK(g.getNumOfEdges() == cells.getNumOfEdges());
+    CHECK(g.getNumOfEdges() == 41);
+    CHECK(g.getRowOffsets()[1] == 39);
+    for (size_t u = 0; u < 42; u++) {
+        for (size_t v = 0; v < 42; v++) CHECK(g.getWeight(u, v) == cells.getWeight(u, v));
+    }
+    CHECK(g.getWeight(0, 5) == 9);
+    CHECK(g.getWeight(3, 1) == 4);
+
+    file = fopen(path.c_str(), "wb");
+    fputs("0 1 5\n1 x 5\n", file);
+    fclose(file);
+    CHECK_THROWS_WITH(g.loadEdgeList(path), "Invalid edge list: bad entry on line 2 of test_edges.txt");
+    remove(path.c_str());
+}
+
+TEST_CASE("Test incremental edge updates") {
+    vector<vector<int>> graph = {
+        {0, 1, 0},
+        {1, 0, 2},
+        {0, 2, 0}};
+    Graph g;
+    g.loadGraph(graph);
+    CHECK(g.getNumOfEdges() == 4);
+    g.addEdge(0, 2, 5);
+    CHECK(g.getIsDirected() == true);
+    CHECK(g.getNumOfEdges() == 5);
+    g.addEdge(2, 0, 5);
+    CHECK(g.getIsDirected() == false);
+    CHECK(g.getNumOfEdges() == 6);
+    g.setWeight(1, 2, 3);
+    CHECK(g.getIsDirected() == true);
+    g.removeEdge(1, 2);
+    g.removeEdge(2, 1);
+    CHECK(g.getIsDirected() == false);
+    CHECK(g.getNumOfEdges() == 4);
+    g.addEdge(1, 1, 7);  // self-loops do not count on undirected graphs
+    CHECK(g.getNumOfEdges() == 4);
+    CHECK(g.getWeight(1, 1) == 7);
+    CHECK_THROWS(g.addEdge(0, 1, 3));
+    CHECK_THROWS(g.addEdge(0, 1, 0));
+    CHECK_THROWS(g.removeEdge(1, 2));
+    CHECK_THROWS(g.setWeight(0, 3, 1));
+
+    // Mixed updates on every storage, checked against a full reload of the same matrix.
+    const size_t n = 9;
+    for (Storage mode : {Storage::Dense, Storage::Sparse, Storage::Bitset}) {
+        vector<vector<int>> matrix(n, vector<int>(n, 0));
+        matrix[0][1] = 4;
+        matrix[3][2] = 1;
+        Graph updated;
+        updated.loadGraph(matrix, mode);
+        for (size_t round = 0; round < 6; round++) {
+            vector<EdgeEntry> updates;
+            for (size_t k = 0; k < 12; k++) {
+                size_t i = round * 12 + k;
+                EdgeEntry e = {(i * 7) % n, (i * 11 + 3) % n, static_cast<int>(i % 3)};
+                updates.push_back(e);
+                EdgeEntry mirror = {e.to, e.from, e.weight};
+                if (round % 2 == 1) updates.push_back(mirror);
+            }
+            if (round == 4) {
+                for (size_t k = 0; k < updates.size(); k++) updated.setWeight(updates[k].from, updates[k].to, updates[k].weight);
+            } else {
+                updated.applyUpdates(updates);
+            }
+            for (size_t k = 0; k < updates.size(); k++) matrix[updates[k].from][updates[k].to] = updates[k].weight;
+            Graph reloaded;
+            reloaded.loadGraph(matrix, mode);
+            CHECK(updated.getIsDirected() == reloaded.getIsDirected());
+            CHECK(updated.getNumOfEdges() == reloaded.getNumOfEdges());
+            CHECK(Algorithms::isConnected(updated) == Algorithms::isConnected(reloaded));
+            if (mode != Storage::Bitset) CHECK(Algorithms::shortestPath(updated, 0, 5) == Algorithms::shortestPath(reloaded, 0, 5));
+        }
+    }
+
+    // A mapped graph is copied on the first update; the file stays untouched.
+    const string path = "test_graph.bin";
+    g.loadGraph(graph, Storage::Sparse);
+    g.saveGraph(path);
+    Graph mapped;
+    mapped.openGraph(path);
+    mapped.addEdge(0, 2, 1);
+    CHECK(mapped.getIsDirected() == true);
+    CHECK(mapped.getNumOfEdges() == 5);
+    Graph reopened;
+    reopened.openGraph(path);
+    CHECK(reopened.getWeight(0, 2) == 0);
+    remove(path.c_str());
+}
+
+TEST_CASE("Test all pairs shortest paths") {
+    // 150 vertices: more than two APSP tiles, directed, with a few negative edges but no negative cycle.
+    const size_t n = 150;
+    vector<vector<int>> graph(n, vector<int>(n, 0));
+    for (size_t u = 0; u < n; u++) {
+        graph[u][(u + 1) % n] = static_cast<int>(u % 7) + 2;
+        graph[u][(u * 13 + 5) % n] = static_cast<int>(u % 5) + 10;
+        if (u % 10 == 3) graph[u][(u + 2) % n] = -1;
+    }
+    for (size_t u = 0; u < n; u++) graph[u][u] = 0;
+    Graph dense, sparse;
+    dense.loadGraph(graph);
+    sparse.loadGraph(graph, Storage::Sparse);
+    DistanceTable fw = Algorithms::allPairsShortestPaths(dense, true, 3);
+    DistanceTable johnson = Algorithms::allPairsShortestPaths(sparse, true, 2);
+    CHECK(fw.distances == johnson.distances);
+    bool pathsMatch = true;
+    for (size_t u = 0; u < n; u += 7) {
+        for (size_t v = 0; v < n; v += 3) {
+            for (const DistanceTable* table : {&fw, &johnson}) {
+                vector<size_t> path = table->path(u, v);
+                int length = 0;
+                for (size_t k = 0; k + 1 < path.size(); k++) length += graph[path[k]][path[k + 1]];
+                pathsMatch = pathsMatch && !path.empty() && path.front() == u && path.back() == v && length == table->distance(u, v);
+            }
+        }
+    }
+    CHECK(pathsMatch);
+
+    // Without negative weights the per-source Dijkstra agrees with shortestPaths.
+    vector<vector<int>> weighted = {
+        {0, 4, 0, 0, 0},
+        {4, 0, 2, 0, 0},
+        {0, 2, 0, 7, 0},
+        {0, 0, 7, 0, 0},
+        {0, 0, 0, 0, 0}};
+    Graph g;
+    g.loadGraph(weighted, Storage::Sparse);
+    DistanceTable table = Algorithms::allPairsShortestPaths(g);
+    CHECK(table.distance(0, 3) == 13);
+    CHECK(table.distance(3, 3) == 0);
+    CHECK(table.reachable(0, 4) == false);
+    CHECK_THROWS_AS(table.path(0, 3), logic_error);
+    g.loadGraph(weighted);
+    CHECK(Algorithms::allPairsShortestPaths(g, true).path(3, 0) == vector<size_t>({3, 2, 1, 0}));
+    CHECK(Algorithms::allPairsShortestPaths(g, true).path(0, 4).empty());
+
+    vector<vector<int>> negativeCycle = {
+        {0, 1, 0},
+        {0, 0, -3},
+        {1, 0, 0}};
+    g.loadGraph(negativeCycle);
+    CHECK_THROWS_AS(Algorithms::allPairsShortestPaths(g), invalid_argument);
+    g.loadGraph(negativeCycle, Storage::Sparse);
+    CHECK_THROWS_AS(Algorithms::allPairsShortestPaths(g), invalid_argument);
+
+    // A DAG whose potentials improve n times at vertex 3 without any cycle.
+    vector<vector<int>> dag = {
+        {0, 0, 0, -1},
+        {0, 0, 0, -2},
+        {-1000, 0, 0, -3},
+        {0, 0, 0, 0}};
+    g.loadGraph(dag);
+    DistanceTable expected = Algorithms::allPairsShortestPaths(g);
+    CHECK(expected.distance(2, 3) == -1001);
+    for (Storage mode : {Storage::Sparse, Storage::Compressed}) {
+        g.loadGraph(dag, mode);
+        CHECK(Algorithms::allPairsShortestPaths(g).distances == expected.distances);
+        g.reorder(vector<size_t>({3, 2, 1, 0}));
+        CHECK(Algorithms::allPairsShortestPaths(g).distances == expected.distances);
+    }
+}
+
+TEST_CASE("Test bidirectional and landmark searches") {
+    // 20 x 20 grid; moving right or down costs a bit more than moving back.
+    const size_t side = 20, n = side * side;
+    vector<vector<int>> graph(n, vector<int>(n, 0));
+    for (size_t r = 0; r < side; r++) {
+        for (size_t c = 0; c < side; c++) {
+            size_t v = r * side + c;
+            int w = static_cast<int>((r * 7 + c * 3) % 5) + 1;
+            if (c + 1 < side) {
+                graph[v][v + 1] = w + 1;
+                graph[v + 1][v] = w;
+            }
+            if (r + 1 < side) {
+                graph[v][v + side] = w + 2;
+                graph[v + side][v] = w;
+            }
+        }
+    }
+    Graph g;
+    g.loadGraph(graph, Storage::Sparse);
+    DistanceTable table = Algorithms::allPairsShortestPaths(g);
+    PathSearch search(g);
+    search.selectLandmarks(4);
+    CHECK(search.landmarkCount() == 4);
+
+    bool distancesMatch = true, pathsMatch = true;
+    size_t dijkstraSettled = 0, altSettled = 0;
+    for (size_t k = 0; k < 40; k++) {
+        size_t src = (k * 37) % n, dest = (k * 91 + 13) % n;
+        PathResult plain = search.dijkstra(src, dest);
+        dijkstraSettled += search.lastSettled();
+        PathResult both = search.bidirectional(src, dest);
+        PathResult landmark = search.alt(src, dest);
+        altSettled += search.lastSettled();
+        for (const PathResult* r : {&plain, &both, &landmark}) {
+            distancesMatch = distancesMatch && r->reachable && r->distance == table.distance(src, dest);
+            int length = 0;
+            for (size_t i = 0; i + 1 < r->path.size(); i++) length += graph[r->path[i]][r->path[i + 1]];
+            pathsMatch = pathsMatch && r->path.front() == src && r->path.back() == dest && length == r->distance;
+        }
+    }
+    CHECK(distancesMatch);
+    CHECK(pathsMatch);
+    CHECK(altSettled < dijkstraSettled);
+    CHECK(search.bidirectional(5, 5).path == vector<size_t>({5}));
+
+    const string path = "test_landmarks.bin";
+    search.saveLandmarks(path);
+    PathSearch reloaded(g);
+    CHECK_THROWS_AS(reloaded.alt(0, 1), logic_error);
+    reloaded.loadLandmarks(path);
+    CHECK(reloaded.getLandmarks() == search.getLandmarks());
+    CHECK(reloaded.alt(3, 250).distance == table.distance(3, 250));
+    vector<vector<int>> small = {{0, 1}, {1, 0}};
+    Graph other;
+    other.loadGraph(small);
+    PathSearch mismatched(other);
+    CHECK_THROWS_AS(mismatched.loadLandmarks(path), invalid_argument);
+    remove(path.c_str());
+
+    // Unreachable targets and negative weights.
+    vector<vector<int>> split = {{0, 2, 0}, {0, 0, 0}, {0, 0, 0}};
+    other.loadGraph(split);
+    PathSearch directed(other);
+    directed.selectLandmarks(2);
+    CHECK(directed.bidirectional(1, 0).reachable == false);
+    CHECK(directed.alt(0, 2).distance == -1);
+    CHECK(directed.bidirectional(0, 1).path == vector<size_t>({0, 1}));
+    split[0][1] = -2;
+    other.loadGraph(split);
+    CHECK_THROWS_AS(PathSearch negative(other), invalid_argument);
+}
+
+TEST_CASE("Test contraction hierarchy queries") {
+    // A random directed graph with some one-way streets and an unreachable vertex.
+    const size_t n = 120;
+    vector<vector<int>> graph(n, vector<int>(n, 0));
+    unsigned state = 7;
+    for (size_t u = 0; u + 1 < n; u++) {
+        for (size_t k = 0; k < 3; k++) {
+            state = state * 1103515245u + 12345u;
+            size_t v = (state >> 8) % (n - 1);
+            if (v != u) graph[u][v] = static_cast<int>((state >> 4) % 20);
+        }
+    }
+    for (size_t u = 0; u + 1 < n; u++) graph[n - 1][u] = 0;
+    Graph g;
+    g.loadGraph(graph, Storage::Sparse);
+    DistanceTable table = Algorithms::allPairsShortestPaths(g);
+
+    for (size_t limit : {size_t(1), size_t(500)}) {
+        ContractionHierarchy ch(g, limit);
+        bool distancesMatch = true, pathsMatch = true;
+        for (size_t src = 0; src < n; src += 7) {
+            for (size_t dest = 0; dest < n; dest++) {
+                int expected = table.reachable(src, dest) ? table.distance(src, dest) : -1;
+                PathResult r = ch.query(src, dest);
+                distancesMatch = distancesMatch && r.distance == expected && ch.distance(src, dest) == expected;
+                if (!r.reachable) continue;
+                int length = 0;
+                for (size_t i = 0; i + 1 < r.path.size(); i++) {
+                    pathsMatch = pathsMatch && graph[r.path[i]][r.path[i + 1]] != 0;
+                    length += graph[r.path[i]][r.path[i + 1]];
+                }
+                pathsMatch = pathsMatch && r.path.front() == src && r.path.back() == dest && length == r.distance;
+            }
+        }
+        CHECK(distancesMatch);
+        CHECK(pathsMatch);
+    }
+
+    ContractionHierarchy ch(g);
+    CHECK(ch.query(n - 1, 3).reachable == false);
+    CHECK(ch.query(4, 4).path == vector<size_t>({4}));
+    CHECK_THROWS_AS(ch.distance(0, n), invalid_argument);
+    graph[0][1] = -1;
+    g.loadGraph(graph);
+    CHECK_THROWS_AS(ContractionHierarchy negative(g), invalid_argument);
+}
+
+TEST_CASE("Test delta-stepping shortest paths") {
+    const size_t n = 150;
+    vector<vector<int>> graph(n, vector<int>(n, 0));
+    unsigned state = 11;
+    for (size_t u = 0; u + 1 < n; u++) {
+        for (size_t k = 0; k < 4; k++) {
+            state = state * 1103515245u + 12345u;
+            size_t v = (state >> 8) % (n - 1);
+            if (v != u) graph[u][v] = static_cast<int>((state >> 3) % 40) + 1;
+        }
+    }
+    vector<pair<size_t, size_t>> queries;
+    for (size_t k = 0; k < 60; k++) queries.push_back(make_pair((k * 13) % 10, (k * 29 + 5) % n));
+
+    for (Storage mode : {Storage::Dense, Storage::Sparse}) {
+        Graph g;
+        g.loadGraph(graph, mode);
+        vector<PathResult> expected = Algorithms::shortestPaths(g, queries, 1);
+        for (int delta : {1, 0, 1000}) {
+            for (size_t threads : {size_t(1), size_t(3)}) {
+                PathOptions options(PathBackend::DeltaStepping, delta, threads);
+                vector<PathResult> results = Algorithms::shortestPaths(g, queries, options);
+                bool distancesMatch = true, pathsMatch = true;
+                for (size_t q = 0; q < queries.size(); q++) {
+                    distancesMatch = distancesMatch && results[q].distance == expected[q].distance;
+                    int length = 0;
+                    for (size_t i = 0; i + 1 < results[q].path.size(); i++) length += graph[results[q].path[i]][results[q].path[i + 1]];
+                    pathsMatch = pathsMatch && (!results[q].reachable || length == results[q].distance);
+                }
+                CHECK(distancesMatch);
+                CHECK(pathsMatch);
+                // Ties go to the smallest predecessor, so every thread count and the
+                // single-query entry point return the same path.
+                CHECK(Algorithms::shortestPath(g, 3, 77, options) == Algorithms::shortestPath(g, 3, 77, PathOptions(PathBackend::DeltaStepping, delta, 1)));
+            }
+        }
+        CHECK(Algorithms::shortestPath(g, n - 1, 0, PathBackend::DeltaStepping) == "-1");
+        CHECK(Algorithms::shortestPath(g, 4, 4, PathBackend::DeltaStepping) == "4");
+        CHECK_THROWS_AS(Algorithms::shortestPath(g, 0, n, PathBackend::DeltaStepping), invalid_argument);
+    }
+
+    vector<vector<int>> negative = {{0, 2, 0}, {0, 0, -1}, {0, 0, 0}};
+    Graph g;
+    g.loadGraph(negative);
+    CHECK_THROWS_AS(Algorithms::shortestPath(g, 0, 2, PathBackend::DeltaStepping), invalid_argument);
+    CHECK(Algorithms::shortestPath(g, 0, 2, PathBackend::Dijkstra) == "0->1->2");
+}
+
+TEST_CASE("Test negative weights select Bellman-Ford") {
+    // Dijkstra settles 1 through the direct edge before the credit on 2 -> 1 is seen.
+    vector<vector<int>> credit = {
+        {0, 2, 5},
+        {0, 0, 0},
+        {0, -4, 0}};
+    Graph g;
+    g.loadGraph(credit);
+    CHECK(g.hasNegativeWeights());
+    CHECK(Algorithms::shortestPath(g, 0, 1, PathBackend::Dijkstra) == "0->1");
+    CHECK(Algorithms::shortestPath(g, 0, 1) == "0->2->1");
+    g.setWeight(2, 1, 4);
+    CHECK_FALSE(g.hasNegativeWeights());
+    CHECK(Algorithms::shortestPath(g, 0, 1) == "0->1");
+
+    // Positive weights shifted by vertex potentials: plenty of negative edges, no negative cycle.
+    const size_t n = 100;
+    vector<vector<int>> graph(n, vector<int>(n, 0));
+    unsigned state = 5;
+    vector<int> potential(n);
+    for (size_t v = 0; v < n; v++) potential[v] = static_cast<int>(v * 37 % 50);
+    for (size_t u = 0; u < n; u++) {
+        for (size_t k = 0; k < 4; k++) {
+            state = state * 1103515245u + 12345u;
+            size_t v = (state >> 8) % n;
+            int weight = static_cast<int>((state >> 3) % 20) + 1 + potential[u] - potential[v];
+            if (v != u && weight != 0) graph[u][v] = weight;
+        }
+    }
+    vector<pair<size_t, size_t>> queries;
+    for (size_t k = 0; k < 50; k++) queries.push_back(make_pair(k % 7, (k * 31 + 3) % n));
+    for (Storage mode : {Storage::Dense, Storage::Sparse}) {
+        g.loadGraph(graph, mode);
+        CHECK(g.hasNegativeWeights());
+        DistanceTable table = Algorithms::allPairsShortestPaths(g);
+        for (size_t threads : {size_t(1), size_t(3)}) {
+            vector<PathResult> results = Algorithms::shortestPaths(g, queries, PathOptions(PathBackend::Auto, 0, threads));
+            bool distancesMatch = true, pathsMatch = true;
+            for (size_t q = 0; q < queries.size(); q++) {
+                size_t src = queries[q].first, dest = queries[q].second;
+                distancesMatch = distancesMatch && results[q].distance == (table.reachable(src, dest) ? table.distance(src, dest) : -1);
+                int length = 0;
+                for (size_t i = 0; i + 1 < results[q].path.size(); i++) length += graph[results[q].path[i]][results[q].path[i + 1]];
+                pathsMatch = pathsMatch && (!results[q].reachable || length == results[q].distance);
+            }
+            CHECK(distancesMatch);
+            CHECK(pathsMatch);
+        }
+        CHECK(Algorithms::negativeCycle(g).empty());
+    }
+
+    // 1 -> 2 -> 3 -> 1 weighs -2; vertex 4 cannot reach it.
+    vector<vector<int>> cycle = {
+        {0, 1, 0, 0, 0},
+        {0, 0, 2, 0, 0},
+        {0, 0, 0, -5, 0},
+        {0, 1, 0, 0, 0},
+        {1, 0, 0, 0, 0}};
+    for (Storage mode : {Storage::Dense, Storage::Sparse}) {
+        g.loadGraph(cycle, mode);
+        for (size_t threads : {size_t(1), size_t(2)}) {
+            vector<size_t> found = Algorithms::negativeCycle(g, threads);
+            REQUIRE(found.size() == 4);
+            CHECK(found.front() == found.back());
+            int total = 0;
+            for (size_t i = 0; i + 1 < found.size(); i++) total += cycle[found[i]][found[i + 1]];
+            CHECK(total == -2);
+        }
+        CHECK_THROWS_WITH_AS(Algorithms::shortestPath(g, 0, 2), doctest::Contains("negative cycle"), invalid_argument);
+        CHECK_THROWS_AS(Algorithms::shortestPaths(g, {{4, 1}}), invalid_argument);
+    }
+    cycle[4][0] = 0;
+    cycle[4][3] = 0;
+    cycle[0][4] = 3;
+    g.loadGraph(cycle);
+    CHECK(Algorithms::shortestPath(g, 4, 0) == "-1");
+
+    // The flag survives the binary file, and edge lists count their negative lines.
+    const string path = "test_negative.bin";
+    g.saveGraph(path);
+    Graph mapped;
+    mapped.openGraph(path);
+    CHECK(mapped.hasNegativeWeights());
+    remove(path.c_str());
+    const string text = "test_negative.txt";
+    FILE* file = fopen(text.c_str(), "w");
+    fputs("0 1 3\n1 2 -1\n1 2 4\n", file);
+    fclose(file);
+    for (Storage mode : {Storage::Dense, Storage::Sparse}) {
+        g.loadEdgeList(text, mode);
+        CHECK_FALSE(g.hasNegativeWeights());
+    }
+    remove(text.c_str());
+}
+
+TEST_CASE("Test union-find components") {
+    Graph g;
+    vector<vector<int>> graph = {
+        {0, 1, 0, 0, 0, 0},
+        {1, 0, 1, 0, 0, 0},
+        {0, 1, 0, 0, 0, 0},
+        {0, 0, 0, 0, 4, 0},
+        {0, 0, 0, 4, 0, 0},
+        {0, 0, 0, 0, 0, 0}};
+    for (Storage mode : {Storage::Dense, Storage::Sparse}) {
+        g.loadGraph(graph, mode);
+        ConnectedComponents components(g);
+        CHECK(components.componentCount() == 3);
+        CHECK_FALSE(components.isConnected());
+        CHECK(components.labels() == vector<size_t>({0, 0, 0, 1, 1, 2}));
+        CHECK(components.componentSizes() == vector<size_t>({3, 2, 1}));
+        CHECK(components.connected(0, 2));
+        CHECK_FALSE(components.connected(2, 3));
+        CHECK(components.componentSize(4) == 2);
+
+        // Inserting the batch that applyUpdates takes merges without a traversal.
+        vector<EdgeEntry> batch = {{2, 3, 7}, {3, 2, 7}, {0, 1, 1}};
+        g.applyUpdates(batch);
+        CHECK(components.addEdges(batch) == 1);
+        CHECK(components.componentCount() == 2);
+        CHECK(components.component(0) == components.component(4));
+        CHECK_FALSE(components.addEdge(4, 0));
+        CHECK(components.addEdge(5, 1));
+        CHECK(components.isConnected());
+        CHECK(components.componentSize(5) == 6);
+
+        CHECK_THROWS_AS(components.addEdges({{0, 1, 0}}), invalid_argument);
+        CHECK_THROWS_AS(components.addEdge(0, 6), invalid_argument);
+    }
+
+    // Directed edges join their ends either way: weak connectivity.
+    vector<vector<int>> directed = {
+        {0, 1, 0},
+        {0, 0, 0},
+        {0, 1, 0}};
+    g.loadGraph(directed);
+    ConnectedComponents weak(g);
+    CHECK(weak.isConnected());
+    CHECK_FALSE(Algorithms::isConnected(g));
+}
+
+TEST_CASE("Test strongly connected components") {
+    Graph g;
+    // {0, 1, 2} and {3, 4} are cycles, 5 hangs off 4; the -1 edge is not followed.
+    vector<vector<int>> graph = {
+        {0, 1, 0, 0, 0, 0},
+        {0, 0, 1, 0, 0, 0},
+        {1, 0, 0, 2, 0, 0},
+        {0, 0, 0, 0, 1, 0},
+        {0, 0, 0, 1, 0, 1},
+        {0, 0, -1, 0, 0, 0}};
+    for (Storage mode : {Storage::Dense, Storage::Sparse}) {
+        g.loadGraph(graph, mode);
+        for (size_t threads : {size_t(1), size_t(2)}) {
+            StronglyConnectedComponents scc(g, threads);
+            CHECK(scc.componentCount() == 3);
+            CHECK_FALSE(scc.isStronglyConnected());
+            CHECK(scc.components() == vector<size_t>({0, 0, 0, 1, 1, 2}));
+            CHECK(scc.componentSizes() == vector<size_t>({3, 2, 1}));
+            CHECK(scc.successors(0) == vector<size_t>({1}));
+            CHECK(scc.successors(1) == vector<size_t>({2}));
+            CHECK(scc.successors(2).empty());
+            CHECK(scc.condensationEdgeCount() == 2);
+            CHECK_THROWS_AS(scc.component(6), invalid_argument);
+        }
+    }
+    graph[5][2] = 3;
+    g.loadGraph(graph);
+    CHECK(StronglyConnectedComponents(g).isStronglyConnected());
+
+    // A random graph large enough for forward-backward to run rounds before Tarjan takes over.
+    const string path = "test_scc.txt";
+    FILE* file = fopen(path.c_str(), "w");
+    unsigned state = 7;
+    const size_t n = 12000;
+    for (size_t u = 0; u < n; u++) {
+        for (int k = 0; k < 2; k++) {
+            state = state * 1103515245U + 12345U;
+            fprintf(file, "%zu %u 1\n", u, (state >> 8) % 12000U);
+        }
+    }
+    fclose(file);
+    g.loadEdgeList(path);
+    remove(path.c_str());
+    StronglyConnectedComponents tarjan(g, 1), split(g, 2);
+    CHECK(split.components() == tarjan.components());
+    CHECK(split.getDagTargets() == tarjan.getDagTargets());
+    CHECK(tarjan.componentCount() > 1);
+    CHECK(tarjan.componentCount() < n);
+    bool topological = true;
+    for (size_t c = 0; c < tarjan.componentCount(); c++) {
+        vector<size_t> next = tarjan.successors(c);
+        for (size_t k = 0; k < next.size(); k++) topological = topological && next[k] > c;
+    }
+    CHECK(topological);
+}
+
+TEST_CASE("Test result cache") {
+    Algorithms::clearResultCache();
+    Algorithms::setResultCache(true);
+    Graph g;
+    vector<vector<int>> graph = {
+        {0, 1, 0},
+        {1, 0, 1},
+        {0, 1, 0}};
+    g.loadGraph(graph);
+    uint64_t loaded = g.getVersion();
+    CHECK(Algorithms::isConnected(g));
+    CHECK(Algorithms::isConnected(g, 2));
+    CHECK(Algorithms::isBipartite(g) == "The graph is bipartite: A={0, 2}, B={1}");
+    CHECK(Algorithms::isBipartite(g) == "The graph is bipartite: A={0, 2}, B={1}");
+    CHECK_FALSE(Algorithms::isContainsCycle(g));
+    CacheStats stats = Algorithms::resultCacheStats();
+    CHECK(stats.hits == 2);
+    CHECK(stats.misses == 3);
+    CHECK(stats.versions == 1);
+
+    // A copy has the same contents and stamp; a mutation or a reload takes a new one.
+    Graph copy = g;
+    CHECK(copy.getVersion() == loaded);
+    CHECK(Algorithms::isConnected(copy));
+    CHECK(Algorithms::resultCacheStats().hits == 3);
+    g.removeEdge(1, 2);
+    g.removeEdge(2, 1);
+    CHECK(g.getVersion() != loaded);
+    CHECK_FALSE(Algorithms::isConnected(g));
+    CHECK(Algorithms::isConnected(copy));
+    g.applyUpdates({{0, 2, 1}, {2, 0, 1}, {1, 2, 1}, {2, 1, 1}});
+    CHECK(Algorithms::isContainsCycle(g));
+    CHECK(Algorithms::isBipartite(g) == "0");
+    uint64_t updated = g.getVersion();
+    g.loadGraph(graph, Storage::Sparse);
+    CHECK(g.getVersion() > updated);
+    CHECK_FALSE(Algorithms::isContainsCycle(g));
+    stats = Algorithms::resultCacheStats();
+    CHECK(stats.hits == 4);
+    CHECK(stats.misses == 7);
+
+    // Off: nothing is counted and the answers are computed again.
+    Algorithms::setResultCache(false);
+    CHECK_FALSE(Algorithms::isContainsCycle(g));
+    CHECK(Algorithms::resultCacheStats().hits == 4);
+    Algorithms::clearResultCache();
+    CHECK(Algorithms::resultCacheStats().versions == 0);
+}
+
+TEST_CASE("Test benchmark graph generators") {
+    vector<pair<size_t, size_t>> edges;
+    generateGraph(GraphFamily::Chain, 5, 1, [&](size_t u, size_t v, int) { edges.push_back(make_pair(u, v)); });
+    CHECK(edges == vector<pair<size_t, size_t>>({{0, 1}, {1, 2}, {2, 3}, {3, 4}}));
+    CHECK(familyVertices(GraphFamily::Grid, 1000) == 961);
+    size_t count = 0;
+    generateGraph(GraphFamily::Grid, 9, 1, [&](size_t, size_t, int) { count++; });
+    CHECK(count == 12);
+    count = 0;
+    generateGraph(GraphFamily::CompleteBipartite, 100, 1, [&](size_t u, size_t v, int) { count += u < 16 && v >= 16 ? 1 : 0; });
+    CHECK(count == 16 * 84);
+
+    // Same seed, same graph; every endpoint in range and weights in 1..100.
+    for (GraphFamily family : {GraphFamily::ErdosRenyi, GraphFamily::RMat}) {
+        vector<EdgeEntry> first, second;
+        generateGraph(family, 1000, 3, [&](size_t u, size_t v, int w) { first.push_back({u, v, w}); });
+        generateGraph(family, 1000, 3, [&](size_t u, size_t v, int w) { second.push_back({u, v, w}); });
+        REQUIRE(first.size() == second.size());
+        CHECK(first.size() > 1000);
+        bool valid = true;
+        for (size_t k = 0; k < first.size(); k++) {
+            valid = valid && first[k].from == second[k].from && first[k].to == second[k].to && first[k].weight == second[k].weight;
+            valid = valid && first[k].from < 1000 && first[k].to < 1000 && first[k].from != first[k].to;
+            valid = valid && first[k].weight >= 1 && first[k].weight <= 100;
+        }
+        CHECK(valid);
+    }
+}
+
+TEST_CASE("Test per-call instrumentation") {
+    Instrumentation::reset();
+    Graph g;
+    vector<vector<int>> graph = {
+        {0, 1, 0, 0},
+        {1, 0, 2, 0},
+        {0, 2, 0, 3},
+        {0, 0, 3, 0}};
+    g.loadGraph(graph);
+    CHECK(Algorithms::isConnected(g) == true);
+    CHECK(Algorithms::shortestPath(g, 0, 3, PathOptions(PathBackend::Dijkstra)) == "0->1->2->3");
+    CHECK(Algorithms::shortestPath(g, 3, 0, PathOptions(PathBackend::Dijkstra)) == "3->2->1->0");
+    vector<FunctionStats> stats = Instrumentation::summary();
+    const string path = "instrumentation_trace_test.json";
+    Instrumentation::writeChromeTrace(path);
+    ifstream trace(path);
+    stringstream text;
+    text << trace.rdbuf();
+    remove(path.c_str());
+    CHECK(text.str().find("\"traceEvents\"") != string::npos);
+#ifdef ARIEL_INSTRUMENT
+    CHECK(Instrumentation::enabled());
+    REQUIRE(stats.size() == 2);
+    CHECK(stats[0].name == "isConnected");
+    CHECK(stats[0].calls == 1);
+    CHECK(stats[0].totals.verticesVisited == 4);
+    CHECK(stats[0].totals.edgesScanned == 6);  // each undirected edge from both ends
+    CHECK(stats[1].name == "shortestPath");
+    CHECK(stats[1].calls == 2);  // the forwarding overload does not count twice
+    CHECK(stats[1].totals.heapOperations > 0);
+    CHECK(stats[1].totals.allocations > 0);
+    CHECK(text.str().find("\"name\":\"shortestPath\"") != string::npos);
+    Instrumentation::reset();
+    CHECK(Instrumentation::summary().empty());
+#else
+    CHECK_FALSE(Instrumentation::enabled());
+    CHECK(stats.empty());
+#endif
+}
+
+TEST_CASE("Test vertex reordering") {
+    // A shuffled chain: RCM starts at an end and puts every edge between
+    // neighbouring ids; BFS starts at vertex 0, inside the chain, and alternates sides.
+    const size_t n = 12;
+    const size_t shuffled[n] = {7, 2, 9, 0, 11, 4, 1, 10, 5, 3, 8, 6};
+    vector<vector<int>> chain(n, vector<int>(n, 0));
+    for (size_t k = 0; k + 1 < n; k++) {
+        chain[shuffled[k]][shuffled[k + 1]] = chain[shuffled[k + 1]][shuffled[k]] = static_cast<int>(k + 1);
+    }
+    for (VertexOrder order : {VertexOrder::ReverseCuthillMcKee, VertexOrder::BFS}) {
+        Graph g;
+        g.loadGraph(chain, Storage::Sparse);
+        g.reorder(order);
+        CHECK(g.isReordered());
+        size_t bandwidth = 0;
+        for (size_t u = 0; u < n; u++) {
+            for (size_t e = g.getRowOffsets()[u]; e < g.getRowOffsets()[u + 1]; e++) {
+                size_t v = g.getColIndices()[e];
+                bandwidth = max(bandwidth, u > v ? u - v : v - u);
+            }
+        }
+        CHECK(bandwidth == (order == VertexOrder::BFS ? 2 : 1));
+    }
+    Graph degree;
+    vector<vector<int>> star = {
+        {0, 1, 0, 0},
+        {1, 0, 1, 1},
+        {0, 1, 0, 0},
+        {0, 1, 0, 0}};
+    degree.loadGraph(star);
+    degree.reorder(VertexOrder::DegreeSort);
+    CHECK(degree.originalId(0) == 1);
+    CHECK(degree.internalId(1) == 0);
+    CHECK(degree.getMatrixGraph() == star);
+
+    // Every answer on a reordered copy is given in the loaded ids.
+    for (Storage mode : {Storage::Dense, Storage::Sparse, Storage::Bitset}) {
+        Graph plain, reordered;
+        plain.loadGraph(chain, mode);
+        reordered.loadGraph(chain, mode);
+        reordered.reorder(VertexOrder::ReverseCuthillMcKee);
+        CHECK(reordered.getNumOfEdges() == plain.getNumOfEdges());
+        CHECK(reordered.getWeight(shuffled[3], shuffled[4]) == plain.getWeight(shuffled[3], shuffled[4]));
+        CHECK(Algorithms::shortestPath(reordered, shuffled[0], shuffled[5]) == Algorithms::shortestPath(plain, shuffled[0], shuffled[5]));
+        CHECK(Algorithms::isBipartite(reordered) == Algorithms::isBipartite(reordered, 2));
+        CHECK(Algorithms::isConnected(reordered) == true);
+        CHECK(Algorithms::isContainsCycle(reordered) == false);
+        vector<PathResult> results = Algorithms::shortestPaths(reordered, {{shuffled[11], shuffled[2]}, {shuffled[4], shuffled[4]}});
+        CHECK(results[0].src == shuffled[11]);
+        CHECK(results[0].path == vector<size_t>({shuffled[11], shuffled[10], shuffled[9], shuffled[8], shuffled[7], shuffled[6],
+                                                 shuffled[5], shuffled[4], shuffled[3], shuffled[2]}));
+        CHECK(results[1].path == vector<size_t>({shuffled[4]}));
+        vector<bool> visited(n, false);
+        visited[shuffled[6]] = true;
+        Algorithms::DFS(shuffled[0], visited, reordered);
+        for (size_t k = 0; k < n; k++) CHECK(visited[shuffled[k]] == (k <= 6));
+        if (mode != Storage::Bitset) {
+            DistanceTable table = Algorithms::allPairsShortestPaths(reordered, true);
+            DistanceTable expected = Algorithms::allPairsShortestPaths(plain, true);
+            CHECK(table.distances == expected.distances);
+            CHECK(table.path(shuffled[2], shuffled[0]) == vector<size_t>({shuffled[2], shuffled[1], shuffled[0]}));
+        }
+        for (Graph* g : {&reordered, &plain}) {
+            g->addEdge(shuffled[0], shuffled[2], 1);
+            g->addEdge(shuffled[2], shuffled[0], 1);
+        }
+        // Neighbours come in internal order, so the cycle may run the other way round.
+        vector<size_t> cycle = Algorithms::findCycle(reordered);
+        CHECK(cycle.size() == 4);
+        CHECK(cycle.front() == cycle.back());
+        vector<size_t> expected = Algorithms::findCycle(plain);
+        sort(cycle.begin(), cycle.end() - 1);
+        sort(expected.begin(), expected.end() - 1);
+        CHECK(vector<size_t>(cycle.begin(), cycle.end() - 1) == vector<size_t>(expected.begin(), expected.end() - 1));
+    }
+    // On a bipartite graph the sides come out in increasing loaded id, with loaded vertex 0 in A.
+    Graph bipartite;
+    vector<vector<int>> square = {
+        {0, 1, 0, 1},
+        {1, 0, 1, 0},
+        {0, 1, 0, 1},
+        {1, 0, 1, 0}};
+    bipartite.loadGraph(square);
+    bipartite.reorder(vector<size_t>({3, 1, 0, 2}));
+    CHECK(Algorithms::isBipartite(bipartite) == "The graph is bipartite: A={0, 2}, B={1, 3}");
+    CHECK_THROWS_AS(bipartite.reorder(vector<size_t>({0, 1, 1, 2})), invalid_argument);
+    CHECK_THROWS_AS(bipartite.reorder(vector<size_t>({0, 1, 2})), invalid_argument);
+    bipartite.loadGraph(square);
+    CHECK_FALSE(bipartite.isReordered());
+
+    // Directed graphs: the traversals still start from loaded vertex 0.
+    vector<vector<int>> path = {
+        {0, 1, 0},
+        {0, 0, 1},
+        {0, 0, 0}};
+    vector<vector<int>> arrows = {
+        {0, 0, 1},
+        {1, 0, 0},
+        {0, 0, 0}};
+    for (Storage mode : {Storage::Dense, Storage::Sparse, Storage::Bitset, Storage::Compressed}) {
+        Graph directed;
+        directed.loadGraph(path, mode);
+        directed.reorder(vector<size_t>({2, 1, 0}));
+        CHECK(Algorithms::isConnected(directed) == true);
+        CHECK(Algorithms::isConnected(directed, 2) == true);
+        directed.loadGraph(arrows, mode);
+        string expected = Algorithms::isBipartite(directed);
+        directed.reorder(vector<size_t>({2, 1, 0}));
+        CHECK(Algorithms::isBipartite(directed) == expected);
+        CHECK(Algorithms::isBipartite(directed, 2) == expected);
+    }
+
+    // The query classes copy a reordered graph in loaded ids and answer in them.
+    vector<vector<int>> road = {
+        {0, 2, 0, 0},
+        {0, 0, 3, 0},
+        {0, 0, 0, 4},
+        {1, 0, 0, 0}};
+    for (Storage mode : {Storage::Dense, Storage::Sparse, Storage::Bitset, Storage::Compressed}) {
+        Graph plain, reordered;
+        plain.loadGraph(road, mode);
+        reordered.loadGraph(road, mode);
+        reordered.reorder(vector<size_t>({3, 1, 2, 0}));
+        int distance = mode == Storage::Bitset ? 3 : 9;
+        PathSearch search(reordered);
+        PathResult r = search.dijkstra(0, 3);
+        CHECK(r.reachable);
+        CHECK(r.distance == distance);
+        CHECK(r.path == vector<size_t>({0, 1, 2, 3}));
+        CHECK(search.bidirectional(0, 3).path == r.path);
+        ContractionHierarchy ch(reordered);
+        CHECK(ch.query(0, 3).distance == distance);
+        CHECK(ch.query(0, 3).path == r.path);
+        CHECK(StronglyConnectedComponents(reordered).components() == StronglyConnectedComponents(plain).components());
+        CHECK(StronglyConnectedComponents(reordered, 2).components() == StronglyConnectedComponents(plain, 2).components());
+        road[3][0] = 0;
+        reordered.loadGraph(road, mode);
+        reordered.reorder(vector<size_t>({3, 1, 2, 0}));
+        StronglyConnectedComponents scc(reordered);
+        CHECK(scc.componentCount() == 4);
+        CHECK(scc.component(0) < scc.component(3));
+        ConnectedComponents cc(reordered);
+        CHECK(cc.connected(0, 3));
+        CHECK(cc.labels() == ConnectedComponents(plain).labels());
+        road[3][0] = 1;
+    }
+}
+
+TEST_CASE("Test narrowed weights") {
+    vector<vector<int>> small = {
+        {0, 4, 0, 0, 9},
+        {4, 0, 7, 0, 0},
+        {0, 7, 0, 200, 0},
+        {0, 0, 200, 0, 1},
+        {9, 0, 0, 1, 0}};
+    vector<vector<int>> signedWeights = {
+        {0, -3, 0, 0},
+        {0, 0, 1000, 0},
+        {0, 0, 0, 5},
+        {2, 0, 0, 0}};
+    for (Storage mode : {Storage::Dense, Storage::Sparse}) {
+        Graph plain, narrow;
+        plain.loadGraph(small, mode);
+        narrow.loadGraph(small, mode);
+        uint64_t version = narrow.getVersion();
+        narrow.narrowWeights();
+        CHECK(narrow.getWeightType() == WeightType::UInt8);
+        CHECK(narrow.getVersion() == version);
+        CHECK(narrow.getStorageBytes() <= plain.getStorageBytes());
+        CHECK(narrow.getWeight(2, 3) == 200);
+        CHECK(Algorithms::shortestPath(narrow, 0, 2) == Algorithms::shortestPath(plain, 0, 2));
+        CHECK(Algorithms::isBipartite(narrow) == Algorithms::isBipartite(plain));
+        CHECK(Algorithms::isContainsCycle(narrow) == Algorithms::isContainsCycle(plain));
+        CHECK(Algorithms::allPairsShortestPaths(narrow).distances == Algorithms::allPairsShortestPaths(plain).distances);
+        if (mode == Storage::Dense) {
+            CHECK(narrow.getMatrixGraph() == small);
+            CHECK_THROWS_AS(narrow.row(0), logic_error);
+        } else {
+            CHECK_THROWS_AS(narrow.getEdgeWeights(), logic_error);
+        }
+        // Reclassifying reads the cells widened and keeps the narrow type.
+        narrow.classifyGraph();
+        CHECK(narrow.getWeightType() == WeightType::UInt8);
+        CHECK(narrow.getIsDirected() == false);
+        CHECK(narrow.getNumOfEdges() == plain.getNumOfEdges());
+        CHECK(narrow.getWeight(2, 3) == 200);
+        // Reordering keeps the narrow cells; an update goes back to int first.
+        narrow.reorder(VertexOrder::ReverseCuthillMcKee);
+        CHECK(narrow.getWeightType() == WeightType::UInt8);
+        CHECK(narrow.getWeight(3, 4) == 1);
+        narrow.setWeight(0, 1, 70000);
+        CHECK(narrow.getWeightType() == WeightType::Int32);
+        CHECK(Algorithms::shortestPath(narrow, 0, 1) == "0->4->3->2->1");
+
+        Graph wide;
+        wide.loadGraph(signedWeights, mode);
+        CHECK_THROWS_AS(wide.narrowWeights(WeightType::UInt8), invalid_argument);
+        CHECK(wide.getWeightType() == WeightType::Int32);
+        wide.narrowWeights();
+        CHECK(wide.getWeightType() == WeightType::Int16);
+        CHECK(wide.hasNegativeWeights());
+        wide.classifyGraph();
+        CHECK(wide.getWeightType() == WeightType::Int16);
+        CHECK(wide.getIsDirected() == true);
+        CHECK(wide.hasNegativeWeights());
+        CHECK(Algorithms::shortestPath(wide, 0, 3) == "0->1->2->3");
+        CHECK(Algorithms::negativeCycle(wide).empty());
+    }
+}
+
+TEST_CASE("Test compressed adjacency") {
+    vector<vector<int>> graph = {
+        {0, 4, 0, 0, 0, 3},
+        {4, 0, 2, 0, 0, 0},
+        {0, 2, 0, -1, 0, 0},
+        {0, 0, 6, 0, 1, 0},
+        {0, 0, 0, 1, 0, 300},
+        {3, 0, 0, 0, 300, 0}};
+    Graph plain, packed;
+    plain.loadGraph(graph, Storage::Sparse);
+    packed.loadGraph(graph, Storage::Compressed);
+    CHECK(packed.getStorage() == Storage::Compressed);
+    CHECK(packed.getWeightType() == WeightType::Int16);
+    CHECK(packed.getIsDirected() == true);
+    CHECK(packed.hasNegativeWeights());
+    CHECK(packed.getNumOfEdges() == plain.getNumOfEdges());
+    CHECK(packed.getStorageBytes() < plain.getStorageBytes());
+    CHECK(packed.getWeight(2, 3) == -1);
+    CHECK(packed.getWeight(3, 2) == 6);
+    CHECK(packed.getWeight(0, 2) == 0);
+    CHECK(Algorithms::isConnected(packed) == Algorithms::isConnected(plain));
+    CHECK(Algorithms::isBipartite(packed) == Algorithms::isBipartite(plain));
+    CHECK(Algorithms::isContainsCycle(packed) == Algorithms::isContainsCycle(plain));
+    CHECK(Algorithms::shortestPath(packed, 0, 4) == Algorithms::shortestPath(plain, 0, 4));
+    CHECK(Algorithms::shortestPath(packed, 5, 3, PathOptions(PathBackend::BellmanFord)) == Algorithms::shortestPath(plain, 5, 3));
+    CHECK(Algorithms::negativeCycle(packed) == Algorithms::negativeCycle(plain));
+    CHECK(Algorithms::allPairsShortestPaths(packed).distances == Algorithms::allPairsShortestPaths(plain).distances);
+    CHECK(ConnectedComponents(packed).componentCount() == 1);
+
+    // An update re-packs the rows; reorder keeps them packed.
+    packed.addEdge(3, 5, 2);
+    plain.addEdge(3, 5, 2);
+    CHECK(packed.getStorage() == Storage::Compressed);
+    CHECK(packed.getWeight(3, 5) == 2);
+    CHECK(Algorithms::shortestPath(packed, 2, 5) == Algorithms::shortestPath(plain, 2, 5));
+    packed.reorder(VertexOrder::ReverseCuthillMcKee);
+    CHECK(packed.getStorage() == Storage::Compressed);
+    CHECK(packed.getWeight(4, 5) == 300);
+    CHECK(Algorithms::shortestPath(packed, 0, 4) == Algorithms::shortestPath(plain, 0, 4));
+    const string file = "test_compressed.bin";
+    packed.saveGraph(file);
+    Graph mapped;
+    mapped.openGraph(file);
+    remove(file.c_str());
+    CHECK(mapped.getStorage() == Storage::Sparse);
+    CHECK(mapped.getNumOfEdges() == packed.getNumOfEdges());
+
+    // Gaps of 1, 2 and 3 bytes, a first target below the row's own vertex, and no weight bytes when every weight is 1.
+    const size_t n = 70000;
+    const string path = "test_compressed.txt";
+    FILE* edges = fopen(path.c_str(), "wb");
+    const size_t pairs[][2] = {{0, 1}, {0, 200}, {0, 69999}, {5, 4}, {300, 40000}, {69998, 2}, {69999, 69998}};
+    for (size_t k = 0; k < sizeof(pairs) / sizeof(pairs[0]); k++) {
+        fprintf(edges, "%zu %zu\n%zu %zu\n", pairs[k][0], pairs[k][1], pairs[k][1], pairs[k][0]);
+    }
+    fclose(edges);
+    Graph sparse, compressed;
+    sparse.loadEdgeList(path);
+    compressed.loadEdgeList(path, Storage::Compressed);
+    remove(path.c_str());
+    CHECK(compressed.getNumOfVertices() == n);
+    CHECK(compressed.getIsDirected() == false);
+    CHECK(compressed.getNumOfEdges() == sparse.getNumOfEdges());
+    for (size_t k = 0; k < sizeof(pairs) / sizeof(pairs[0]); k++) {
+        CHECK(compressed.getWeight(pairs[k][0], pairs[k][1]) == 1);
+        CHECK(compressed.getWeight(pairs[k][1], pairs[k][0]) == 1);
+    }
+    CHECK(Algorithms::shortestPath(compressed, 4, 5) == "4->5");
+    CHECK(Algorithms::shortestPath(compressed, 40000, 300) == "40000->300");
+    CHECK(Algorithms::shortestPath(compressed, 1, 2) == "1->0->69999->69998->2");
+    CHECK(Algorithms::isBipartite(compressed) == Algorithms::isBipartite(sparse));
+    CHECK(Algorithms::isConnected(compressed) == false);
+    vector<bool> visited(n, false);
+    Algorithms::DFS(69999, visited, compressed);
+    CHECK(count(visited.begin(), visited.end(), true) == 6);
+}
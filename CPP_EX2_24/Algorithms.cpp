@@ -12,21 +12,22 @@ using namespace std;
 
 namespace ariel {
     
-    void Algorithms::DFS(size_t start, vector<bool>& visited, vector<vector<int>>& matrixGraph){
+    void Algorithms::DFS(size_t start, vector<bool>& visited, const Graph& g){
         visited[start] = true;
+        const int* row = g.row(start);
         for(size_t i = 0; i < visited.size(); i++){
-            if(matrixGraph[start][i] > 0 && !visited[i]){
-                DFS(i, visited, matrixGraph);
+            if(row[i] > 0 && !visited[i]){
+                DFS(i, visited, g);
             }
         }
     }
     
     // Check if the graph is connected using a simple BFS
     bool Algorithms::isConnected(Graph& g) {
-        vector<vector<int>> matrixGraph = g.getMatrixGraph();
-        if(matrixGraph.size() == 1) return true;
-        vector<bool> visited(matrixGraph.size(), false);
-        DFS(0, visited, matrixGraph);
+        size_t n = g.getNumOfVertices();
+        if(n == 1) return true;
+        vector<bool> visited(n, false);
+        DFS(0, visited, g);
         for(bool vertexVisit: visited){
             if(!vertexVisit) return false; 
         }
@@ -45,19 +46,20 @@ namespace ariel {
     }
 
     string Algorithms::shortestPath(Graph& g, size_t src, size_t dest) {
-        vector<vector<int>> matrixGraph = g.getMatrixGraph();
-        vector<bool> visited(matrixGraph.size(), false);
-        vector<int> srcPathDest(matrixGraph.size(), numeric_limits<int>::max());
-        vector<int> predecessor(matrixGraph.size(), -1); // Additional array to store the path
+        size_t n = g.getNumOfVertices();
+        vector<bool> visited(n, false);
+        vector<int> srcPathDest(n, numeric_limits<int>::max());
+        vector<int> predecessor(n, -1); // Additional array to store the path
         srcPathDest[src] = 0; // Distance from source to itself is always 0
-        for (size_t count = 0; count < matrixGraph.size() - 1; count++) {
+        for (size_t count = 0; count < n - 1; count++) {
             size_t u = minDistance(srcPathDest, visited);
             if (u == -1) break; // No more reachable vertices
             visited[u] = true;
-            for (size_t v = 0; v < matrixGraph.size(); v++) {
-                if (!visited[v] && matrixGraph[u][v] && srcPathDest[u] != numeric_limits<int>::max() &&
-                    srcPathDest[u] + matrixGraph[u][v] < srcPathDest[v]) {
-                    srcPathDest[v] = srcPathDest[u] + matrixGraph[u][v];
+            const int* row = g.row(u);
+            for (size_t v = 0; v < n; v++) {
+                if (!visited[v] && row[v] && srcPathDest[u] != numeric_limits<int>::max() &&
+                    srcPathDest[u] + row[v] < srcPathDest[v]) {
+                    srcPathDest[v] = srcPathDest[u] + row[v];
                     predecessor[v] = u; // Track the path
                 }
             }
@@ -87,13 +89,14 @@ namespace ariel {
         return result;
     }
 
-    bool Algorithms::dfs(size_t v,vector<bool>& visited, vector<bool>& recStack, vector<vector<int>>& matrixGraph, int parent = -1, bool isDirected = false) {
+    bool Algorithms::dfs(size_t v,vector<bool>& visited, vector<bool>& recStack, const Graph& g, int parent = -1, bool isDirected = false) {
     visited[v] = true;
     recStack[v] = true;
-    for (size_t i = 0; i < matrixGraph[v].size(); i++) {
-        if (matrixGraph[v][i] != 0) {  // There's an edge from v to i
+    const int* row = g.row(v);
+    for (size_t i = 0; i < visited.size(); i++) {
+        if (row[i] != 0) {  // There's an edge from v to i
             if (!visited[i]) {  // If not visited, do a DFS on it
-                if (dfs(i, visited, recStack, matrixGraph, v, isDirected)) {
+                if (dfs(i, visited, recStack, g, v, isDirected)) {
                     return true;  // If cycle is found
                 }
             } else if (isDirected && recStack[i]) {
@@ -109,13 +112,13 @@ namespace ariel {
 
     // Check for cycles using a simple DFS
     bool Algorithms::isContainsCycle(Graph& g) {
-        vector<vector<int>>& matrixGraph = g.getMatrixGraph();
-        vector<bool> visited(matrixGraph.size(), false);
-        vector<bool> recStack(matrixGraph.size(), false);
+        size_t n = g.getNumOfVertices();
+        vector<bool> visited(n, false);
+        vector<bool> recStack(n, false);
         bool isDirected = g.getIsDirected();
-        for (size_t i = 0; i < matrixGraph.size(); i++) {
+        for (size_t i = 0; i < n; i++) {
             if (!visited[i]) {
-                if (dfs(i, visited, recStack, matrixGraph, -1, isDirected)) {
+                if (dfs(i, visited, recStack, g, -1, isDirected)) {
                     return true;
                 }
             }
@@ -125,11 +128,11 @@ namespace ariel {
 
    // Simple BFS to check if the graph is bipartite
     string Algorithms::isBipartite(Graph& g) {
-        vector<vector<int>>& matrixGraph = g.getMatrixGraph();
-        vector<int> color(matrixGraph.size(), -1);  // Color array to store colors assigned to vertices
+        size_t n = g.getNumOfVertices();
+        vector<int> color(n, -1);  // Color array to store colors assigned to vertices
         vector<int> setA, setB;
         
-        for (size_t start = 0; start < matrixGraph.size(); ++start) {
+        for (size_t start = 0; start < n; ++start) {
             if (color[start] == -1) {  // If not colored
                 queue<int> q;
                 q.push(start);
@@ -140,8 +143,9 @@ namespace ariel {
                     size_t u = static_cast<size_t>(q.front());
                     q.pop();
 
-                    for (size_t v = 0; v < matrixGraph[u].size(); ++v) {
-                        if (matrixGraph[u][v] > 0) {  // Check if there is a weight, indicating an edge
+                    const int* row = g.row(u);
+                    for (size_t v = 0; v < n; ++v) {
+                        if (row[v] > 0) {  // Check if there is a weight, indicating an edge
                             if (color[v] == -1) {  // If not colored
                                 color[v] = 1 - color[u];  // Assign alternate color
                                 q.push(v);
@@ -2,6 +2,7 @@
 #include <stdexcept>
 #include <iostream>
 #include <limits>
+#include <cstring>
 
 using namespace std;
 
@@ -21,7 +22,7 @@ namespace ariel {
             throw invalid_argument("Invalid graph: The graph is not a square matrix.");
             }
         }
-        matrixGraph = matrix;
+        matrixGraph = FlatMatrix(matrix);
         classifyGraph();
     }
 
@@ -32,23 +33,21 @@ namespace ariel {
     void Graph::classifyGraph() {
         isDirected = false;
         numOfEdges = 0;
-        for (size_t i = 0; i < matrixGraph.size(); ++i) {
-            for (size_t j = 0; j < matrixGraph.size(); ++j) {
-                if (matrixGraph[i][j] != matrixGraph[j][i]) {
+        const size_t n = matrixGraph.size();
+        for (size_t i = 0; i < n && !isDirected; ++i) {
+            const int* row = matrixGraph.row(i);
+            for (size_t j = i + 1; j < n; ++j) {
+                if (row[j] != matrixGraph.at(j, i)) {
                     isDirected = true;
+                    break;
                 }
             }
         }
-        for (size_t i = 0; i < matrixGraph.size(); ++i) {
-            for (size_t j = 0; j < matrixGraph.size(); ++j) {
-                if (matrixGraph[i][j] != 0) {
-                    if (isDirected) {
-                        numOfEdges++;
-                    } else {
-                        if (i < j) {
-                            numOfEdges++;
-                        }
-                    }
+        for (size_t i = 0; i < n; ++i) {
+            const int* row = matrixGraph.row(i);
+            for (size_t j = isDirected ? 0 : i + 1; j < n; ++j) {
+                if (row[j] != 0) {
+                    numOfEdges++;
                 }
             }
         }
@@ -58,36 +57,56 @@ namespace ariel {
         cout << "Graph with " << matrixGraph.size() << " vertices and " << numOfEdges << " edges";
         cout << (isDirected ? " (Directed)." : " (Undirected).") << endl;
     }
-    vector<vector<int>>& Graph::getMatrixGraph(){
-        return matrixGraph;
+    vector<vector<int>> Graph::getMatrixGraph() const {
+        return matrixGraph.toVectors();
     }
 
-    Graph Graph::operator+(const Graph& other){
-    if (matrixGraph.size() != other.matrixGraph.size() || matrixGraph[0].size() != other.matrixGraph[0].size()) {
-        throw invalid_argument("Cannot add graphs of different sizes");
+    const int* Graph::row(size_t u) const {
+        return matrixGraph.row(u);
     }
 
-    Graph resultGraph;
-    for (size_t i = 0; i < matrixGraph.size(); ++i) {
-        vector<int> row;
-        for (size_t j = 0; j < matrixGraph[i].size(); ++j) {
-            row.push_back(matrixGraph[i][j] + other.matrixGraph[i][j]);
-        }
-        resultGraph.getMatrixGraph().push_back(row);
+    size_t Graph::getRowStride() const {
+        return matrixGraph.rowStride();
     }
 
-    return resultGraph;
+    size_t Graph::getNumOfVertices() const {
+        return matrixGraph.size();
+    }
+
+    // The operators below walk the matrix row by row through plain pointers, so
+    // the inner loops run over contiguous cells. Results are written straight
+    // into a freshly allocated FlatMatrix.
+    Graph Graph::operator+(const Graph& other){
+        if (matrixGraph.size() != other.matrixGraph.size()) {
+            throw invalid_argument("Cannot add graphs of different sizes");
+        }
+
+        const size_t n = matrixGraph.size();
+        Graph resultGraph;
+        resultGraph.matrixGraph = FlatMatrix(n);
+        for (size_t i = 0; i < n; ++i) {
+            const int* a = matrixGraph.row(i);
+            const int* b = other.matrixGraph.row(i);
+            int* out = resultGraph.matrixGraph.row(i);
+            for (size_t j = 0; j < n; ++j) {
+                out[j] = a[j] + b[j];
+            }
+        }
+        return resultGraph;
     }
 
     Graph Graph::operator+=(const Graph& other){
-        if (matrixGraph.size() != other.matrixGraph.size() || matrixGraph[0].size() != other.matrixGraph[0].size()) {
+        if (matrixGraph.size() != other.matrixGraph.size()) {
             throw invalid_argument("Cannot add graphs of different sizes");
         }
 
         Graph resultGraph(*this);
-        for (size_t i = 0; i < matrixGraph.size(); ++i) {
-            for (size_t j = 0; j < matrixGraph[i].size(); ++j) {
-                resultGraph.getMatrixGraph()[i][j] += other.matrixGraph[i][j];
+        const size_t n = matrixGraph.size();
+        for (size_t i = 0; i < n; ++i) {
+            const int* b = other.matrixGraph.row(i);
+            int* out = resultGraph.matrixGraph.row(i);
+            for (size_t j = 0; j < n; ++j) {
+                out[j] += b[j];
             }
         }
         return resultGraph;
@@ -99,16 +118,19 @@ namespace ariel {
     }
 
     Graph Graph::operator-(const Graph& other) {
-        if (matrixGraph.size() != other.matrixGraph.size() || matrixGraph[0].size() != other.matrixGraph[0].size()) {
+        if (matrixGraph.size() != other.matrixGraph.size()) {
             throw invalid_argument("Cannot subtract graphs of different sizes");
         }
+        const size_t n = matrixGraph.size();
         Graph resultGraph;
-        for (size_t i = 0; i < matrixGraph.size(); ++i) {
-            vector<int> row;
-            for (size_t j = 0; j < matrixGraph[i].size(); ++j) {
-                row.push_back(matrixGraph[i][j] - other.matrixGraph[i][j]);
+        resultGraph.matrixGraph = FlatMatrix(n);
+        for (size_t i = 0; i < n; ++i) {
+            const int* a = matrixGraph.row(i);
+            const int* b = other.matrixGraph.row(i);
+            int* out = resultGraph.matrixGraph.row(i);
+            for (size_t j = 0; j < n; ++j) {
+                out[j] = a[j] - b[j];
             }
-            resultGraph.getMatrixGraph().push_back(row);
         }
         return resultGraph;
     }
@@ -116,9 +138,11 @@ namespace ariel {
     // Unary minus operator
     Graph Graph::operator-() const {
         Graph resultGraph(*this);
-        for (size_t i = 0; i < matrixGraph.size(); ++i) {
-            for (size_t j = 0; j < matrixGraph[i].size(); ++j) {
-                resultGraph.getMatrixGraph()[i][j] = -resultGraph.getMatrixGraph()[i][j];
+        const size_t n = matrixGraph.size();
+        for (size_t i = 0; i < n; ++i) {
+            int* out = resultGraph.matrixGraph.row(i);
+            for (size_t j = 0; j < n; ++j) {
+                out[j] = -out[j];
             }
         }
         return resultGraph;
@@ -127,9 +151,11 @@ namespace ariel {
     // Pre-increment operator
     Graph& Graph::operator++() {
         // Increment all elements by 1
-        for (size_t i = 0; i < matrixGraph.size(); ++i) {
-            for (size_t j = 0; j < matrixGraph[i].size(); ++j) {
-                ++matrixGraph[i][j];
+        const size_t n = matrixGraph.size();
+        for (size_t i = 0; i < n; ++i) {
+            int* row = matrixGraph.row(i);
+            for (size_t j = 0; j < n; ++j) {
+                ++row[j];
             }
         }
         return *this;
@@ -138,9 +164,11 @@ namespace ariel {
     // Pre-decrement operator
     Graph& Graph::operator--() {
         // Decrement all elements by 1
-        for (size_t i = 0; i < matrixGraph.size(); ++i) {
-            for (size_t j = 0; j < matrixGraph[i].size(); ++j) {
-                --matrixGraph[i][j];
+        const size_t n = matrixGraph.size();
+        for (size_t i = 0; i < n; ++i) {
+            int* row = matrixGraph.row(i);
+            for (size_t j = 0; j < n; ++j) {
+                --row[j];
             }
         }
         return *this;
@@ -148,43 +176,43 @@ namespace ariel {
 
     Graph Graph::operator*(int scalar) {
         Graph resultGraph(*this);
-        for (size_t i = 0; i < matrixGraph.size(); ++i) {
-            for (size_t j = 0; j < matrixGraph[i].size(); ++j) {
-                resultGraph.getMatrixGraph()[i][j] *= scalar;
-            }
-        }
+        resultGraph *= scalar;
         return resultGraph;
     }
 
+    // i-k-j order: each a[i][k] scales a whole row of the second matrix into the
+    // result row, so both inner-loop streams are contiguous.
     Graph Graph::operator*(const Graph& other) {
-        if (matrixGraph[0].size() != other.matrixGraph.size()) {
+        if (matrixGraph.size() != other.matrixGraph.size()) {
             throw invalid_argument("The number of columns in the first matrix must be equal to the number of rows in the second matrix.");
         }
 
+        const size_t n = matrixGraph.size();
         Graph resultGraph;
-        for (size_t i = 0; i < matrixGraph.size(); ++i) {
-            vector<int> row;
-            for (size_t j = 0; j < other.matrixGraph[0].size(); ++j) {
-                int sum = 0;
-                for (size_t k = 0; k < matrixGraph[i].size(); ++k) {
-                    sum += matrixGraph[i][k] * other.matrixGraph[k][j];
+        resultGraph.matrixGraph = FlatMatrix(n);
+        for (size_t i = 0; i < n; ++i) {
+            const int* a = matrixGraph.row(i);
+            int* out = resultGraph.matrixGraph.row(i);
+            for (size_t k = 0; k < n; ++k) {
+                int scale = a[k];
+                if (scale == 0) continue;
+                const int* b = other.matrixGraph.row(k);
+                for (size_t j = 0; j < n; ++j) {
+                    out[j] += scale * b[j];
                 }
-                row.push_back(sum);
             }
-            resultGraph.getMatrixGraph().push_back(row);
         }
         return resultGraph;
     }
 
     bool Graph::operator==(const Graph& other) const {
-        if (matrixGraph.size() != other.matrixGraph.size() || matrixGraph[0].size() != other.matrixGraph[0].size()) {
+        if (matrixGraph.size() != other.matrixGraph.size()) {
             return false;
         }
-        for (size_t i = 0; i < matrixGraph.size(); ++i) {
-            for (size_t j = 0; j < matrixGraph[i].size(); ++j) {
-                if (matrixGraph[i][j] != other.matrixGraph[i][j]) {
-                    return false;
-                }
+        const size_t n = matrixGraph.size();
+        for (size_t i = 0; i < n; ++i) {
+            if (memcmp(matrixGraph.row(i), other.matrixGraph.row(i), n * sizeof(int)) != 0) {
+                return false;
             }
         }
         return true;
@@ -217,9 +245,11 @@ namespace ariel {
     }
 
     Graph& Graph::operator*=(int scalar) {
-        for (size_t i = 0; i < matrixGraph.size(); ++i) {
-            for (size_t j = 0; j < matrixGraph[i].size(); ++j) {
-                matrixGraph[i][j] *= scalar;
+        const size_t n = matrixGraph.size();
+        for (size_t i = 0; i < n; ++i) {
+            int* row = matrixGraph.row(i);
+            for (size_t j = 0; j < n; ++j) {
+                row[j] *= scalar;
             }
         }
         return *this;
@@ -230,21 +260,22 @@ namespace ariel {
         if (scalar == 0) {
             throw invalid_argument("Division by zero");
         }
-        for (size_t i = 0; i < matrixGraph.size(); ++i) {
-            for (size_t j = 0; j < matrixGraph[i].size(); ++j) {
-                matrixGraph[i][j] /= scalar;
+        const size_t n = matrixGraph.size();
+        for (size_t i = 0; i < n; ++i) {
+            int* row = matrixGraph.row(i);
+            for (size_t j = 0; j < n; ++j) {
+                row[j] /= scalar;
             }
         }
         return *this;
     }
 
     ostream& operator<<(ostream& os, Graph& graph) {
-        vector<vector<int>> matrix = graph.getMatrixGraph();
-        for (size_t i = 0; i < matrix.size(); ++i) {
-            const vector<int>& row = matrix[i];
-            for (size_t j = 0; j < row.size(); ++j) {
-                int weight = row[j];
-                os << weight << " ";
+        const size_t n = graph.getNumOfVertices();
+        for (size_t i = 0; i < n; ++i) {
+            const int* row = graph.row(i);
+            for (size_t j = 0; j < n; ++j) {
+                os << row[j] << " ";
             }
             os << endl;
         }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "FlatMatrix.hpp"
 #include <vector>
 #include <iostream>    
 using namespace std;
@@ -7,7 +8,7 @@ using namespace std;
 namespace ariel {
     class Graph {
         private:
-            vector<vector<int>> matrixGraph;
+            FlatMatrix matrixGraph;
             int numOfEdges;
             bool isDirected; 
 
@@ -17,7 +18,11 @@ namespace ariel {
             void printGraph();
             void classifyGraph();
             bool getIsDirected(); 
-            vector<vector<int>>& getMatrixGraph();
+            // Copy of the matrix as rows; the algorithms and operators read it in place through row().
+            vector<vector<int>> getMatrixGraph() const;
+            const int* row(size_t u) const;
+            size_t getRowStride() const;
+            size_t getNumOfVertices() const;
             int getNumOfEdges();
 
             Graph operator+(const Graph& other);
@@ -269,3 +269,21 @@ TEST_CASE("Verify number of edges in Graph") {
     CHECK(g.getNumOfEdges() == 1);  // Assuming undirected graph
 }
 
+
+TEST_CASE("Test flat matrix rows") {
+    ariel::Graph g1, g2;
+    vector<vector<int>> graph1 = {{0, 1, 2}, {3, 0, 4}, {5, 6, 0}};
+    vector<vector<int>> graph2 = {{0, 2, 0}, {1, 0, 1}, {0, 3, 0}};
+    g1.loadGraph(graph1);
+    g2.loadGraph(graph2);
+    CHECK(g1.getNumOfVertices() == 3);
+    CHECK(g1.getRowStride() % 16 == 0);
+    CHECK(reinterpret_cast<uintptr_t>(g1.row(1)) % 64 == 0);
+    CHECK(g1.row(2)[1] == 6);
+    ariel::Graph g3 = g1 * g2;
+    vector<vector<int>> expectedGraph = {{1, 6, 1}, {0, 18, 0}, {6, 10, 6}};
+    CHECK(g3.getMatrixGraph() == expectedGraph);
+    ariel::Graph g4 = g1 - g1;
+    CHECK(g4.row(0)[2] == 0);
+    CHECK(g1 != g2);
+}